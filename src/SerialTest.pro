@@ -30,43 +30,99 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 SOURCES += \
     adaptivestackedwidget.cpp \
+    ahocorasick.cpp \
     asynccrc.cpp \
+    autoresponder.cpp \
+    bridge.cpp \
+    canframemodel.cpp \
+    captureindex.cpp \
     connection.cpp \
     controlitem.cpp \
     ctrltab.cpp \
     datatab.cpp \
+    deframer.cpp \
     devicetab.cpp \
+    filefanout.cpp \
     filetab.cpp \
     filexceiver.cpp \
+    hexformatter.cpp \
+    latencyhistogram.cpp \
     legenditemdialog.cpp \
+    lineindex.cpp \
     main.cpp \
     mainwindow.cpp \
     metadata.cpp \
+    metrics.cpp \
+    metricsserver.cpp \
     mycustomplot.cpp \
     mysettings.cpp \
+    plothistory.cpp \
     plottab.cpp \
+    rfc2217.cpp \
+    rtttracker.cpp \
+    rxdatamodel.cpp \
+    rxexporter.cpp \
+    rxindexbuilder.cpp \
+    rxsearcher.cpp \
     serialpinout.cpp \
     settingstab.cpp \
+    streamdecoder.cpp \
+    terminalscreen.cpp \
+    terminalwidget.cpp \
+    timeline.cpp \
+    timelinemodel.cpp \
+    timestampformatter.cpp \
+    txframe.cpp \
+    txscheduler.cpp \
+    txtemplate.cpp \
     util.cpp
 
 HEADERS += \
     metadata.h \
     adaptivestackedwidget.h \
+    ahocorasick.h \
     asynccrc.h \
+    autoresponder.h \
+    bridge.h \
+    canframemodel.h \
+    captureindex.h \
     connection.h \
     controlitem.h \
     ctrltab.h \
     datatab.h \
+    deframer.h \
     devicetab.h \
+    filefanout.h \
     filetab.h \
     filexceiver.h \
+    hexformatter.h \
+    latencyhistogram.h \
     legenditemdialog.h \
+    lineindex.h \
     mainwindow.h \
+    metrics.h \
+    metricsserver.h \
     mycustomplot.h \
     mysettings.h \
+    plothistory.h \
     plottab.h \
+    rfc2217.h \
+    rtttracker.h \
+    rxdatamodel.h \
+    rxexporter.h \
+    rxindexbuilder.h \
+    rxsearcher.h \
     serialpinout.h \
     settingstab.h \
+    streamdecoder.h \
+    terminalscreen.h \
+    terminalwidget.h \
+    timeline.h \
+    timelinemodel.h \
+    timestampformatter.h \
+    txframe.h \
+    txscheduler.h \
+    txtemplate.h \
     util.h
 
 FORMS += \
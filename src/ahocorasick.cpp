@@ -0,0 +1,95 @@
+#include "ahocorasick.h"
+
+#include <QQueue>
+#include <algorithm>
+
+AhoCorasick::AhoCorasick()
+{
+    setPatterns(QVector<QByteArray>());
+}
+
+void AhoCorasick::setPatterns(const QVector<QByteArray>& patterns)
+{
+    m_next.fill(-1, 256);
+    m_outputs.clear();
+    m_outputs.resize(1);
+    m_patternNum = 0;
+    m_state = 0;
+
+    // the trie, -1 for no transition
+    for(int i = 0; i < patterns.size(); i++)
+    {
+        const QByteArray& pattern = patterns[i];
+        if(pattern.isEmpty())
+            continue;
+        int state = 0;
+        for(const char c : pattern)
+        {
+            const int id = state * 256 + (quint8)c;
+            if(m_next[id] == -1)
+            {
+                m_next[id] = m_outputs.size();
+                m_next.resize(m_next.size() + 256);
+                std::fill(m_next.end() - 256, m_next.end(), -1);
+                m_outputs.append(QVector<int>());
+            }
+            state = m_next[id];
+        }
+        m_outputs[state].append(i);
+        m_patternNum++;
+    }
+
+    // the failure links by BFS, then the missing transitions follow the failure links
+    QVector<int> fail(m_outputs.size(), 0);
+    QQueue<int> queue;
+    for(int c = 0; c < 256; c++)
+    {
+        int& next = m_next[c];
+        if(next == -1)
+            next = 0;
+        else
+            queue.enqueue(next);
+    }
+    while(!queue.isEmpty())
+    {
+        const int state = queue.dequeue();
+        // the failure state is shallower, so it's done
+        m_outputs[state] += m_outputs[fail[state]];
+        for(int c = 0; c < 256; c++)
+        {
+            const int failNext = m_next[fail[state] * 256 + c];
+            int& next = m_next[state * 256 + c];
+            if(next == -1)
+                next = failNext;
+            else
+            {
+                fail[next] = failNext;
+                queue.enqueue(next);
+            }
+        }
+    }
+}
+
+bool AhoCorasick::isEmpty() const
+{
+    return m_patternNum == 0;
+}
+
+void AhoCorasick::reset()
+{
+    m_state = 0;
+}
+
+void AhoCorasick::feed(const char* data, qint64 len, QVector<int>* matches)
+{
+    const int* next = m_next.constData();
+    const QVector<int>* outputs = m_outputs.constData();
+    int state = m_state;
+    for(qint64 i = 0; i < len; i++)
+    {
+        state = next[state * 256 + (quint8)data[i]];
+        if(!outputs[state].isEmpty())
+            *matches += outputs[state];
+    }
+    m_state = state;
+}
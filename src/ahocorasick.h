@@ -0,0 +1,28 @@
+#ifndef AHOCORASICK_H
+#define AHOCORASICK_H
+
+#include <QByteArray>
+#include <QVector>
+
+// Finds all the patterns in a byte stream in one pass, the state is kept between the chunks.
+// The automaton is built as a full DFA with 256 transitions per state, so every byte costs one table lookup.
+class AhoCorasick
+{
+public:
+    AhoCorasick();
+
+    // the empty patterns never match
+    void setPatterns(const QVector<QByteArray>& patterns);
+    bool isEmpty() const;
+    // forgets the partial matches
+    void reset();
+    // the ids of the patterns ending in data are appended to matches, in the order they end
+    void feed(const char* data, qint64 len, QVector<int>* matches);
+private:
+    QVector<int> m_next; // m_next[state * 256 + byte]
+    QVector<QVector<int>> m_outputs; // the patterns ending at the state, including the ones ending at its suffixes
+    int m_patternNum = 0;
+    int m_state = 0;
+};
+
+#endif // AHOCORASICK_H
@@ -0,0 +1,55 @@
+#include "autoresponder.h"
+
+#include <QDateTime>
+#include <QTimer>
+
+AutoResponder::AutoResponder(QObject *parent)
+    : QObject{parent}
+{
+
+}
+
+void AutoResponder::setRules(const QVector<Rule>& rules)
+{
+    m_rules = rules;
+    QVector<QByteArray> patterns;
+    for(const Rule& rule : rules)
+        patterns.append(rule.pattern);
+    m_matcher.setPatterns(patterns);
+}
+
+bool AutoResponder::isEmpty() const
+{
+    return m_matcher.isEmpty();
+}
+
+void AutoResponder::feed(const QByteArray& data)
+{
+    if(m_matcher.isEmpty())
+        return;
+    // not a member, reply() might show a message box and feed() is called again in its event loop
+    QVector<int> matches;
+    m_matcher.feed(data.constData(), data.size(), &matches);
+    for(const int id : qAsConst(matches))
+    {
+        Rule& rule = m_rules[id];
+        const QByteArray replyData = rule.reply.data(m_sequence++, QDateTime::currentMSecsSinceEpoch());
+        if(rule.delay <= 0)
+        {
+            emit reply(replyData);
+            continue;
+        }
+        const int generation = m_generation;
+        QTimer::singleShot(rule.delay, Qt::PreciseTimer, this, [ = ]()
+        {
+            if(generation == m_generation)
+                emit reply(replyData);
+        });
+    }
+}
+
+void AutoResponder::reset()
+{
+    m_matcher.reset();
+    m_generation++;
+}
@@ -0,0 +1,41 @@
+#ifndef AUTORESPONDER_H
+#define AUTORESPONDER_H
+
+#include <QObject>
+#include <QVector>
+
+#include "ahocorasick.h"
+#include "txframe.h"
+
+// Sends a reply when a pattern is found in the received data, optionally after a delay.
+// The received chunks are checked as soon as they are read, not in the UI update timer,
+// and all the patterns are matched in one pass by AhoCorasick.
+class AutoResponder : public QObject
+{
+    Q_OBJECT
+public:
+    struct Rule
+    {
+        QByteArray pattern;
+        TxFrame reply;
+        int delay; // in ms, 0: reply immediately
+    };
+
+    explicit AutoResponder(QObject *parent = nullptr);
+
+    void setRules(const QVector<Rule>& rules);
+    bool isEmpty() const;
+    // the patterns might span the chunks
+    void feed(const QByteArray& data);
+    // forgets the partial matches and drops the delayed replies
+    void reset();
+signals:
+    void reply(const QByteArray& data);
+private:
+    QVector<Rule> m_rules;
+    AhoCorasick m_matcher;
+    quint64 m_sequence = 0;
+    int m_generation = 0;
+};
+
+#endif // AUTORESPONDER_H
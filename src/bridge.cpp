@@ -0,0 +1,158 @@
+#include "bridge.h"
+
+Bridge::Bridge(Connection* device, QObject *parent)
+    : QObject{parent}
+{
+    m_device = device;
+    m_peer = new Connection();
+    m_statisticTimer = new QTimer(this);
+    m_statisticTimer->setInterval(1000);
+    m_clock.start();
+
+    connect(m_device, &Connection::connected, this, &Bridge::onDeviceConnected);
+    connect(m_device, &Connection::disconnected, this, &Bridge::onDeviceDisconnected);
+    // forward the data before readyRead() is handled in MainWindow
+    connect(m_device, &Connection::dataReceived, this, &Bridge::onDeviceDataReceived, Qt::DirectConnection);
+    connect(m_peer, &Connection::readyRead, this, &Bridge::onPeerReadyRead, Qt::DirectConnection);
+    connect(m_peer, QOverload<const QStringList&>::of(&Connection::connectFailed), this, &Bridge::onPeerConnectFailed);
+    connect(m_peer, QOverload<const QString&>::of(&Connection::connectFailed), this, [ = ](const QString & info)
+    {
+        onPeerConnectFailed({info});
+    });
+    connect(m_statisticTimer, &QTimer::timeout, this, &Bridge::onStatisticTimeout);
+}
+
+Bridge::~Bridge()
+{
+    stopPeer();
+    m_peer->deleteLater();
+}
+
+bool Bridge::enabled() const
+{
+    return m_enabled;
+}
+
+Connection* Bridge::peer() const
+{
+    return m_peer;
+}
+
+void Bridge::setPeerArgument(Connection::Type type, const Connection::NetworkArgument& arg)
+{
+    // applied when the peer is started next time
+    m_peerType = type;
+    m_peerArgument = arg;
+}
+
+Bridge::Statistics Bridge::statistics(Direction direction) const
+{
+    return m_statistics[direction];
+}
+
+void Bridge::setEnabled(bool enabled)
+{
+    if(enabled == m_enabled)
+        return;
+    m_enabled = enabled;
+    if(enabled && m_device->isConnected())
+        startPeer();
+    else if(!enabled)
+        stopPeer();
+}
+
+void Bridge::resetStatistics()
+{
+    m_statistics[DeviceToPeer] = Statistics();
+    m_statistics[PeerToDevice] = Statistics();
+    m_lastBytes[DeviceToPeer] = 0;
+    m_lastBytes[PeerToDevice] = 0;
+    m_lastStatisticTime = m_clock.nsecsElapsed();
+    emit statisticsUpdated();
+}
+
+void Bridge::onDeviceConnected()
+{
+    if(m_enabled)
+        startPeer();
+}
+
+void Bridge::onDeviceDisconnected()
+{
+    stopPeer();
+}
+
+void Bridge::startPeer()
+{
+    if(m_peer->state() != Connection::Unconnected)
+        return;
+    m_peer->setType(m_peerType);
+    m_peer->setArgument(m_peerArgument);
+    m_peer->open();
+    resetStatistics();
+    m_statisticTimer->start();
+}
+
+void Bridge::stopPeer()
+{
+    m_statisticTimer->stop();
+    m_peer->close();
+}
+
+void Bridge::onDeviceDataReceived(const QByteArray& data)
+{
+    const qint64 beginTime = m_clock.nsecsElapsed();
+    if(!m_enabled || !m_peer->isConnected())
+        return;
+    forward(DeviceToPeer, data.constData(), data.size(), beginTime);
+}
+
+void Bridge::onPeerReadyRead()
+{
+    const qint64 beginTime = m_clock.nsecsElapsed();
+    // drop the data if the device is not ready, the buffer of the peer should be cleared anyway
+    QByteArray data = m_peer->readAll();
+    if(data.isEmpty() || !m_device->isConnected())
+        return;
+    if(forward(PeerToDevice, data.constData(), data.size(), beginTime))
+        emit peerDataForwarded(data);
+}
+
+bool Bridge::forward(Direction direction, const char* data, qint64 len, qint64 beginTime)
+{
+    Connection* target = (direction == DeviceToPeer) ? m_peer : m_device;
+    if(target->write(data, len) <= 0)
+        return false;
+
+    const qint64 latency = m_clock.nsecsElapsed() - beginTime;
+    Statistics& statistics = m_statistics[direction];
+    statistics.bytes += len;
+    statistics.chunks++;
+    statistics.totalLatency += latency;
+    if(statistics.minLatency < 0 || latency < statistics.minLatency)
+        statistics.minLatency = latency;
+    if(latency > statistics.maxLatency)
+        statistics.maxLatency = latency;
+    return true;
+}
+
+void Bridge::onPeerConnectFailed(const QStringList& infoList)
+{
+    m_statisticTimer->stop();
+    emit peerFailed(infoList.join('\n'));
+}
+
+void Bridge::onStatisticTimeout()
+{
+    const qint64 currTime = m_clock.nsecsElapsed();
+    const double period = (currTime - m_lastStatisticTime) / 1e9;
+    if(period <= 0)
+        return;
+    for(int i = DeviceToPeer; i <= PeerToDevice; i++)
+    {
+        m_statistics[i].throughput = (m_statistics[i].bytes - m_lastBytes[i]) / period;
+        m_lastBytes[i] = m_statistics[i].bytes;
+    }
+    m_lastStatisticTime = currTime;
+    emit statisticsUpdated();
+}
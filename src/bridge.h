@@ -0,0 +1,75 @@
+#ifndef BRIDGE_H
+#define BRIDGE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include "connection.h"
+
+// Forward the data between the device(the connection in the main window) and a peer connection, like ser2net.
+// The data is forwarded in the I/O path(Connection::dataReceived()) rather than in MainWindow::readData(),
+// the data from the device is still captured by MainWindow, the data from the peer is teed by peerDataForwarded().
+class Bridge : public QObject
+{
+    Q_OBJECT
+public:
+    enum Direction
+    {
+        DeviceToPeer = 0,
+        PeerToDevice,
+    };
+
+    struct Statistics
+    {
+        qint64 bytes = 0;
+        qint64 chunks = 0;
+        // the time spent on forwarding one chunk, in ns
+        qint64 minLatency = -1;
+        qint64 maxLatency = 0;
+        qint64 totalLatency = 0;
+        // bytes per second in the last statistic period
+        double throughput = 0;
+    };
+
+    explicit Bridge(Connection* device, QObject *parent = nullptr);
+    ~Bridge();
+
+    bool enabled() const;
+    Connection* peer() const;
+    void setPeerArgument(Connection::Type type, const Connection::NetworkArgument& arg);
+    Statistics statistics(Direction direction) const;
+public slots:
+    void setEnabled(bool enabled);
+    void resetStatistics();
+signals:
+    // the data from the peer which is written to the device
+    void peerDataForwarded(const QByteArray& data);
+    void peerFailed(const QString& info);
+    void statisticsUpdated();
+private slots:
+    void onDeviceConnected();
+    void onDeviceDisconnected();
+    void onDeviceDataReceived(const QByteArray& data);
+    void onPeerReadyRead();
+    void onPeerConnectFailed(const QStringList& infoList);
+    void onStatisticTimeout();
+private:
+    Connection* m_device;
+    Connection* m_peer;
+    bool m_enabled = false;
+    Connection::Type m_peerType = Connection::TCP_Server;
+    Connection::NetworkArgument m_peerArgument;
+
+    Statistics m_statistics[2];
+    qint64 m_lastBytes[2] = {0, 0};
+    QElapsedTimer m_clock;
+    qint64 m_lastStatisticTime = 0;
+    QTimer* m_statisticTimer;
+
+    void startPeer();
+    void stopPeer();
+    bool forward(Direction direction, const char* data, qint64 len, qint64 beginTime);
+};
+
+#endif // BRIDGE_H
@@ -0,0 +1,84 @@
+#include "canframemodel.h"
+#include "connection.h"
+
+#include <QDateTime>
+
+CANFrameModel::CANFrameModel(const QByteArray* RxBuf, const QVector<Metadata>* RxMetadataBuf, QObject *parent)
+    : QAbstractTableModel{parent}
+{
+    m_RxBuf = RxBuf;
+    m_RxMetadataBuf = RxMetadataBuf;
+}
+
+int CANFrameModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return m_rowCount;
+}
+
+int CANFrameModel::columnCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return ColumnCount;
+}
+
+QVariant CANFrameModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= m_rowCount || index.row() >= m_RxMetadataBuf->size())
+        return QVariant();
+    const Metadata& frame = m_RxMetadataBuf->at(index.row());
+    if(role == Qt::DisplayRole)
+    {
+        if(index.column() == TimeColumn)
+            return QDateTime::fromMSecsSinceEpoch(frame.timestamp).toString("hh:mm:ss.zzz");
+        else if(index.column() == IDColumn)
+            return Connection::CAN_frameIdString(frame.frameId);
+        else if(index.column() == DLCColumn)
+            return frame.len > 0 ? frame.len : frame.remoteDLC;
+        else if(index.column() == DataColumn)
+            return QByteArray::fromRawData(m_RxBuf->constData() + frame.pos, frame.len).toHex(' ').toUpper();
+    }
+    else if(role == Qt::TextAlignmentRole)
+    {
+        if(index.column() == DLCColumn)
+            return int(Qt::AlignCenter);
+    }
+    return QVariant();
+}
+
+QVariant CANFrameModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(role != Qt::DisplayRole)
+        return QVariant();
+    if(orientation == Qt::Vertical)
+        return section + 1;
+    if(section == TimeColumn)
+        return tr("Time");
+    else if(section == IDColumn)
+        return tr("ID");
+    else if(section == DLCColumn)
+        return tr("DLC");
+    else if(section == DataColumn)
+        return tr("Data");
+    return QVariant();
+}
+
+void CANFrameModel::sync()
+{
+    const int newCount = m_RxMetadataBuf->size();
+    if(newCount < m_rowCount)
+    {
+        // cleared
+        beginResetModel();
+        m_rowCount = newCount;
+        endResetModel();
+    }
+    else if(newCount > m_rowCount)
+    {
+        beginInsertRows(QModelIndex(), m_rowCount, newCount - 1);
+        m_rowCount = newCount;
+        endInsertRows();
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef CANFRAMEMODEL_H
+#define CANFRAMEMODEL_H
+
+#include <QAbstractTableModel>
+
+#include "metadata.h"
+
+// A read-only view of the received CAN frames.
+// Every frame is a Metadata in RxMetadata, the payload is stored in rawReceivedData.
+// Nothing is copied, QTableView only asks for the visible rows.
+class CANFrameModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column
+    {
+        TimeColumn = 0,
+        IDColumn,
+        DLCColumn,
+        DataColumn,
+        ColumnCount
+    };
+
+    explicit CANFrameModel(const QByteArray* RxBuf, const QVector<Metadata>* RxMetadataBuf, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // call it after the buffers are changed
+    void sync();
+private:
+    const QByteArray* m_RxBuf;
+    const QVector<Metadata>* m_RxMetadataBuf;
+    int m_rowCount = 0;
+};
+
+#endif // CANFRAMEMODEL_H
@@ -0,0 +1,180 @@
+#include "captureindex.h"
+
+#include <QByteArrayMatcher>
+
+// about 1% false positive rate with 10 bits per trigram
+static const int bloomHashNum = 7;
+static const int bloomBitsPerItem = 10;
+
+CaptureIndex::CaptureIndex(QObject *parent)
+    : QObject{parent}
+{
+
+}
+
+void CaptureIndex::reset()
+{
+    QWriteLocker locker(&m_lock);
+    // the chunks which are already queued are dropped
+    m_generation.fetchAndAddOrdered(1);
+    m_filters.clear();
+}
+
+int CaptureIndex::generation() const
+{
+    return m_generation.loadAcquire();
+}
+
+int CaptureIndex::chunkCount() const
+{
+    QReadLocker locker(&m_lock);
+    return m_filters.size();
+}
+
+qint64 CaptureIndex::memoryUsage() const
+{
+    QReadLocker locker(&m_lock);
+    qint64 result = 0;
+    for(const Filter& filter : m_filters)
+        result += sizeof(Filter) + filter.bits.size() * sizeof(quint64);
+    return result;
+}
+
+void CaptureIndex::addChunk(const QByteArray& chunk, int chunkId, int generation)
+{
+    if(generation != m_generation.loadAcquire() || chunk.size() < m_chunkSize + 2)
+        return;
+    if(m_seen.isEmpty())
+        m_seen.resize((1 << 24) / 64);
+
+    // count distinct trigrams first, then the filter size is known
+    const quint8* data = reinterpret_cast<const quint8*>(chunk.constData());
+    m_seenList.clear();
+    for(int i = 0; i < m_chunkSize; i++)
+    {
+        const quint32 trigram = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+        quint64& word = m_seen[trigram >> 6];
+        const quint64 bit = 1ULL << (trigram & 63);
+        if(word & bit)
+            continue;
+        word |= bit;
+        m_seenList.append(trigram);
+    }
+
+    Filter filter;
+    // a filter for high entropy data is as large as the data and rejects nothing
+    if(m_seenList.size() < m_chunkSize / 4)
+    {
+        quint32 bitNum = 64;
+        while(bitNum < (quint32)m_seenList.size() * bloomBitsPerItem)
+            bitNum <<= 1;
+        filter.bits.resize(bitNum / 64);
+        filter.mask = bitNum - 1;
+        for(quint32 trigram : qAsConst(m_seenList))
+            insert(filter, trigram);
+    }
+    for(quint32 trigram : qAsConst(m_seenList))
+        m_seen[trigram >> 6] = 0;
+
+    QWriteLocker locker(&m_lock);
+    // reset() might be called during building
+    if(generation != m_generation.loadAcquire() || chunkId != m_filters.size())
+        return;
+    m_filters.append(filter);
+}
+
+QVector<QPair<qint64, qint64>> CaptureIndex::candidateRanges(const QByteArray& pattern, qint64 dataSize) const
+{
+    QVector<QPair<qint64, qint64>> result;
+    const int len = pattern.size();
+    QReadLocker locker(&m_lock);
+    const int filterNum = m_filters.size();
+    const qint64 indexedSize = qMin((qint64)filterNum * m_chunkSize, dataSize);
+    if(len < 3 || len > m_chunkSize)
+    {
+        result.append(qMakePair((qint64)0, dataSize));
+        return result;
+    }
+
+    QVector<quint32> trigrams;
+    const quint8* p = reinterpret_cast<const quint8*>(pattern.constData());
+    for(int i = 0; i + 2 < len; i++)
+        trigrams.append((p[i] << 16) | (p[i + 1] << 8) | p[i + 2]);
+
+    auto addRange = [&](qint64 begin, qint64 end)
+    {
+        if(!result.isEmpty() && result.last().second == begin)
+            result.last().second = end;
+        else
+            result.append(qMakePair(begin, end));
+    };
+    for(int i = 0; i < filterNum && (qint64)i * m_chunkSize < indexedSize; i++)
+    {
+        // a match shorter than a chunk starts in this chunk and might end in the next one
+        bool isCandidate = true;
+        for(quint32 trigram : qAsConst(trigrams))
+        {
+            if(contains(m_filters[i], trigram))
+                continue;
+            if(i + 1 < filterNum && !contains(m_filters[i + 1], trigram))
+            {
+                isCandidate = false;
+                break;
+            }
+        }
+        if(isCandidate)
+            addRange((qint64)i * m_chunkSize, qMin((qint64)(i + 1) * m_chunkSize, dataSize));
+    }
+    if(indexedSize < dataSize)
+        addRange(indexedSize, dataSize);
+    return result;
+}
+
+qint64 CaptureIndex::indexOf(const QByteArray& data, const QByteArray& pattern, qint64 from, const CaptureIndex* index)
+{
+    if(index == nullptr)
+        return data.indexOf(pattern, from);
+    if(pattern.isEmpty())
+        return from <= data.size() ? from : -1;
+
+    const QByteArrayMatcher matcher(pattern);
+    const QVector<QPair<qint64, qint64>> ranges = index->candidateRanges(pattern, data.size());
+    for(const auto& range : ranges)
+    {
+        if(range.second <= from)
+            continue;
+        const qint64 begin = qMax(range.first, from);
+        // the match might end after the range
+        const qint64 end = qMin(range.second + pattern.size() - 1, (qint64)data.size());
+        const int pos = matcher.indexIn(data.constData() + begin, end - begin, 0);
+        if(pos != -1)
+            return begin + pos;
+    }
+    return -1;
+}
+
+bool CaptureIndex::contains(const Filter& filter, quint32 trigram)
+{
+    if(filter.bits.isEmpty())
+        return true;
+    const quint32 h1 = trigram * 0x9E3779B1u;
+    const quint32 h2 = ((trigram ^ (trigram >> 7)) * 0x85EBCA77u) | 1;
+    for(int i = 0; i < bloomHashNum; i++)
+    {
+        const quint32 pos = (h1 + i * h2) & filter.mask;
+        if(!(filter.bits[pos >> 6] & (1ULL << (pos & 63))))
+            return false;
+    }
+    return true;
+}
+
+void CaptureIndex::insert(Filter& filter, quint32 trigram)
+{
+    const quint32 h1 = trigram * 0x9E3779B1u;
+    const quint32 h2 = ((trigram ^ (trigram >> 7)) * 0x85EBCA77u) | 1;
+    for(int i = 0; i < bloomHashNum; i++)
+    {
+        const quint32 pos = (h1 + i * h2) & filter.mask;
+        filter.bits[pos >> 6] |= 1ULL << (pos & 63);
+    }
+}
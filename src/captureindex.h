@@ -0,0 +1,50 @@
+#ifndef CAPTUREINDEX_H
+#define CAPTUREINDEX_H
+
+#include <QObject>
+#include <QVector>
+#include <QPair>
+#include <QReadWriteLock>
+#include <QAtomicInt>
+
+// Trigram Bloom filters over the sealed chunks of the received data, built in a worker thread.
+// A search only scans the chunks whose filters contain all trigrams of the pattern.
+// The chunks with too many distinct trigrams(binary or random data) are not filtered, they are always scanned.
+class CaptureIndex : public QObject
+{
+    Q_OBJECT
+public:
+    static const int m_chunkSize = 65536;
+
+    explicit CaptureIndex(QObject *parent = nullptr);
+
+    // thread safe
+    void reset();
+    int generation() const;
+    int chunkCount() const;
+    qint64 memoryUsage() const;
+    // [begin, end) of the possible start positions of the pattern, the data which is not indexed yet is always included
+    QVector<QPair<qint64, qint64>> candidateRanges(const QByteArray& pattern, qint64 dataSize) const;
+    // same as QByteArray::indexOf(), the chunks are skipped if index is not nullptr
+    static qint64 indexOf(const QByteArray& data, const QByteArray& pattern, qint64 from, const CaptureIndex* index);
+public slots:
+    // chunk: m_chunkSize bytes starting from chunkId * m_chunkSize, followed by the first 2 bytes of the next chunk
+    void addChunk(const QByteArray& chunk, int chunkId, int generation);
+private:
+    struct Filter
+    {
+        QVector<quint64> bits; // empty: no filter
+        quint32 mask = 0;
+    };
+
+    QVector<Filter> m_filters;
+    mutable QReadWriteLock m_lock;
+    QAtomicInt m_generation = 0;
+    QVector<quint64> m_seen; // 2^24 bits, for counting distinct trigrams
+    QVector<quint32> m_seenList;
+
+    static bool contains(const Filter& filter, quint32 trigram);
+    static void insert(Filter& filter, quint32 trigram);
+};
+
+#endif // CAPTUREINDEX_H
@@ -1,7 +1,21 @@
 ﻿#include "connection.h"
+#include "metrics.h"
 
 #include <QNetworkDatagram>
 #include <QMetaEnum>
+#include <QDateTime>
+#include <QtEndian>
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <net/if.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#endif
 
 Connection::Connection(QObject *parent)
     : QObject{parent}
@@ -14,7 +28,17 @@ Connection::Connection(QObject *parent)
     m_TCPSocket = new QTcpSocket();
     m_TCPServer = new QTcpServer();
     m_UDPSocket = new QUdpSocket();
-
+    m_process = new QProcess();
+    m_localSocket = new QLocalSocket();
+
+    // stdout is the data channel, keep stderr for the log of the child process
+    m_process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    m_processKillTimer = new QTimer(this);
+    m_processKillTimer->setSingleShot(true);
+    m_processKillTimer->setInterval(m_processKillTimeout);
+    connect(m_processKillTimer, &QTimer::timeout, m_process, &QProcess::kill);
+    // the timer is for the exiting process, not the next one
+    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), m_processKillTimer, &QTimer::stop);
     BTServer_initServiceInfo();
 
     m_pollTimer->setInterval(100); // default interval
@@ -34,6 +58,8 @@ bool Connection::setType(Type type)
     m_lastSPArgumentValid = false;
     m_lastBTArgumentValid = false;
     m_lastNetArgumentValid = false;
+    m_lastLocalArgumentValid = false;
+    m_lastCANArgumentValid = false;
     updateSignalSlot();
     return true;
 }
@@ -51,7 +77,8 @@ Connection::State Connection::state()
 void Connection::setPolling(bool enabled)
 {
     m_pollTimerEnabled = enabled;
-    if(!enabled)
+    // RFC2217_Server always polls the pinout signals for the clients
+    if(!enabled && m_type != RFC2217_Server)
         m_pollTimer->stop();
     else if(enabled && isConnected())
         m_pollTimer->start();
@@ -87,6 +114,24 @@ QStringList Connection::getErrorStringList() const
     return m_errorStringList;
 }
 
+QString Connection::errorString() const
+{
+    if(m_type == SerialPort || m_type == RFC2217_Server)
+        return m_serialPort->errorString();
+    else if(m_type == BT_Client)
+        return m_BTSocket->errorString();
+    else if(m_type == TCP_Client || m_type == RFC2217_Client)
+        return m_TCPSocket->errorString();
+    else if(m_type == UDP)
+        return m_UDPSocket->errorString();
+    else if(m_type == Process)
+        return m_process->errorString();
+    else if(m_type == LocalSocket)
+        return m_localSocket->errorString();
+    // the servers write to several clients, SocketCAN and BLE keep no error string
+    return QString();
+}
+
 void Connection::setArgument(SerialPortArgument arg)
 {
     m_currSPArgument = arg;
@@ -102,6 +147,16 @@ void Connection::setArgument(NetworkArgument arg)
     m_currNetArgument = arg;
 }
 
+void Connection::setArgument(LocalArgument arg)
+{
+    m_currLocalArgument = arg;
+}
+
+void Connection::setArgument(CANArgument arg)
+{
+    m_currCANArgument = arg;
+}
+
 Connection::SerialPortArgument Connection::getSerialPortArgument()
 {
     return m_currSPArgument;
@@ -112,6 +167,16 @@ Connection::BTArgument Connection::getBTArgument()
     return m_currBTArgument;
 }
 
+Connection::LocalArgument Connection::getLocalArgument()
+{
+    return m_currLocalArgument;
+}
+
+Connection::CANArgument Connection::getCANArgument()
+{
+    return m_currCANArgument;
+}
+
 Connection::NetworkArgument Connection::getNetworkArgument(bool fillLocalAddress, bool fillLocalPort)
 {
     // the NetworkArgument passed to Connection might have auto-filled arguments
@@ -124,18 +189,18 @@ Connection::NetworkArgument Connection::getNetworkArgument(bool fillLocalAddress
 
     if(fillLocalAddress && arg.localAddress == QHostAddress::Any) // local address is not specified
     {
-        if(m_type == TCP_Client)
+        if(m_type == TCP_Client || m_type == RFC2217_Client)
             arg.localAddress = m_TCPSocket->localAddress();
-        else if(m_type == TCP_Server)
+        else if(m_type == TCP_Server || m_type == RFC2217_Server)
             arg.localAddress = m_TCPServer->serverAddress();
         else if(m_type == UDP)
             arg.localAddress = m_UDPSocket->localAddress();
     }
     if(fillLocalPort && arg.localPort == 0) // a random port is used
     {
-        if(m_type == TCP_Client)
+        if(m_type == TCP_Client || m_type == RFC2217_Client)
             arg.localPort = m_TCPSocket->localPort();
-        else if(m_type == TCP_Server)
+        else if(m_type == TCP_Server || m_type == RFC2217_Server)
             arg.localPort = m_TCPServer->serverPort();
         else if(m_type == UDP)
             arg.localPort = m_UDPSocket->localPort();
@@ -234,15 +299,8 @@ void Connection::open()
     setCollectingErrorStringList(true);
     if(m_type == SerialPort)
     {
-        m_serialPort->setPortName(m_currSPArgument.name);
-        m_serialPort->setBaudRate(m_currSPArgument.baudRate);
-        m_serialPort->setDataBits(m_currSPArgument.dataBits);
-        m_serialPort->setStopBits(m_currSPArgument.stopBits);
-        m_serialPort->setParity(m_currSPArgument.parity);
-        m_serialPort->setFlowControl(m_currSPArgument.flowControl);
-
         // serialport doesn't have connected() signal(open() is sync function), so call onConnected() manually
-        if(m_serialPort->open(QIODevice::ReadWrite))
+        if(SP_open())
             onConnected();
         else
             emit connectFailed(getErrorStringList());
@@ -342,6 +400,79 @@ void Connection::open()
                                    .arg(m_currNetArgument.localAddress.toString())
                                    .arg(m_currNetArgument.localPort));
     }
+    else if(m_type == Process)
+    {
+        changeState(Connecting);
+        // the last process is still exiting, it's killed rather than waited
+        if(m_process->state() != QProcess::NotRunning)
+        {
+            m_processKillTimer->stop();
+            // finished() of it must not disconnect the new one
+            m_process->blockSignals(true);
+            m_process->kill();
+            m_process->waitForFinished(m_processKillTimeout);
+            m_process->blockSignals(false);
+        }
+        m_process->setWorkingDirectory(m_currLocalArgument.workingDirectory);
+        // started() -> onConnected()
+        // errorOccurred(FailedToStart) -> connectFailed()
+        m_process->start(m_currLocalArgument.name, m_currLocalArgument.arguments, QIODevice::ReadWrite);
+    }
+    else if(m_type == LocalSocket)
+    {
+        changeState(Connecting);
+        m_localSocket->connectToServer(m_currLocalArgument.name, QIODevice::ReadWrite);
+    }
+    else if(m_type == SocketCAN)
+    {
+        // the raw socket is bound synchronously, like the serialport
+        if(CAN_open())
+            onConnected();
+        else
+            emit connectFailed(getErrorStringList());
+    }
+    else if(m_type == RFC2217_Client)
+    {
+        changeState(Connecting);
+        m_RFC2217Codec.reset();
+        m_RFC2217_modemState = 0;
+        m_RFC2217_DTR = false;
+        m_RFC2217_RTS = false;
+        m_RFC2217_lineSettingsSent = false;
+        // the line settings are sent after the server accepts COM-PORT-OPTION, see onReadyRead()
+        m_TCPSocket->bind(m_currNetArgument.localAddress, m_currNetArgument.localPort);
+        m_TCPSocket->connectToHost(m_currNetArgument.remoteName, m_currNetArgument.remotePort);
+    }
+    else if(m_type == RFC2217_Server)
+    {
+        if(!SP_open())
+        {
+            emit connectFailed(getErrorStringList());
+            return;
+        }
+        if(!m_TCPServer->listen(m_currNetArgument.localAddress, m_currNetArgument.localPort))
+        {
+            m_serialPort->close();
+            emit connectFailed(tr("Failed to listen to ") + "\n"
+                               + QString("(%1, %2)")
+                               .arg(m_currNetArgument.localAddress.toString())
+                               .arg(m_currNetArgument.localPort));
+            return;
+        }
+        // the local serial port works without any client, so the state is Connected rather than Bound
+        onConnected();
+    }
+}
+
+bool Connection::SP_open()
+{
+    m_serialPort->setPortName(m_currSPArgument.name);
+    m_serialPort->setBaudRate(m_currSPArgument.baudRate);
+    m_serialPort->setDataBits(m_currSPArgument.dataBits);
+    m_serialPort->setStopBits(m_currSPArgument.stopBits);
+    m_serialPort->setParity(m_currSPArgument.parity);
+    m_serialPort->setFlowControl(m_currSPArgument.flowControl);
+    return m_serialPort->open(QIODevice::ReadWrite);
 }
 
 bool Connection::reopen()
@@ -364,6 +495,26 @@ bool Connection::reopen()
             return false;
         setArgument(m_lastNetArgument);
     }
+    else if(m_type == Process || m_type == LocalSocket)
+    {
+        if(!m_lastLocalArgumentValid)
+            return false;
+        setArgument(m_lastLocalArgument);
+    }
+    else if(m_type == SocketCAN)
+    {
+        if(!m_lastCANArgumentValid)
+            return false;
+        setArgument(m_lastCANArgument);
+    }
+    else if(m_type == RFC2217_Client || m_type == RFC2217_Server)
+    {
+        // line settings and network address
+        if(!m_lastSPArgumentValid || !m_lastNetArgumentValid)
+            return false;
+        setArgument(m_lastSPArgument);
+        setArgument(m_lastNetArgument);
+    }
     open();
     return true;
 }
@@ -372,6 +523,7 @@ void Connection::close(bool forced)
 {
     if(m_state == Unconnected && !forced)
         return;
+    emit aboutToClose();
     if(m_type == SerialPort)
     {
         m_serialPort->close();
@@ -413,7 +565,7 @@ void Connection::close(bool forced)
             m_BLEController = nullptr;
         }
     }
-    else if(m_type == TCP_Client)
+    else if(m_type == TCP_Client || m_type == RFC2217_Client)
     {
         m_TCPSocket->close(); // will call disconnectFromHost()
         // for some unknown reason, the QTCPSocket might keep the error state for a while
@@ -434,6 +586,33 @@ void Connection::close(bool forced)
     {
         m_UDPSocket->close();
     }
+    else if(m_type == Process)
+    {
+        if(m_process->state() != QProcess::NotRunning)
+        {
+            // give the child process a chance to exit by itself, without blocking the GUI
+            m_process->closeWriteChannel();
+            m_process->terminate();
+            m_processKillTimer->start();
+        }
+    }
+    else if(m_type == LocalSocket)
+    {
+        m_localSocket->abort();
+    }
+    else if(m_type == SocketCAN)
+    {
+        CAN_close();
+    }
+    else if(m_type == RFC2217_Server)
+    {
+        m_TCPServer->close();
+        m_TCPTxClients.clear();
+        for(auto it = m_TCPConnectedClients.begin(); it != m_TCPConnectedClients.end(); ++it)
+            (*it)->close();
+        // the delete operation will be done in Server_onClientDisconnected()
+        m_serialPort->close();
+    }
     onDisconnected();
 }
 
@@ -469,7 +648,7 @@ void Connection::updateSignalSlot()
         // connected() -> onConnected() (called in BLEC_onServiceDetailDiscovered())
         // disconnected() -> onErrorOccurred() (no disconnected() signal)
     }
-    else if(m_type == TCP_Client)
+    else if(m_type == TCP_Client || m_type == RFC2217_Client)
     {
         m_lastReadyReadConn = connect(m_TCPSocket, &QIODevice::readyRead, this, &Connection::onReadyRead);
 #if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
@@ -497,6 +676,37 @@ void Connection::updateSignalSlot()
         m_lastOnConnectedConn = connect(m_UDPSocket, &QAbstractSocket::connected, this, &Connection::onConnected);
         m_lastOnDisconnectedConn = connect(m_UDPSocket, &QAbstractSocket::disconnected, this, &Connection::onDisconnected);
     }
+    else if(m_type == Process)
+    {
+        // stderr is forwarded, only stdout is read there
+        m_lastReadyReadConn = connect(m_process, &QProcess::readyReadStandardOutput, this, &Connection::onReadyRead);
+        m_lastOnErrorConn = connect(m_process, &QProcess::errorOccurred, this, &Connection::onErrorOccurred);
+        m_lastOnConnectedConn = connect(m_process, &QProcess::started, this, &Connection::onConnected);
+        m_lastOnDisconnectedConn = connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &Connection::onDisconnected);
+    }
+    else if(m_type == LocalSocket)
+    {
+        m_lastReadyReadConn = connect(m_localSocket, &QIODevice::readyRead, this, &Connection::onReadyRead);
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+        m_lastOnErrorConn = connect(m_localSocket, QOverload<QLocalSocket::LocalSocketError>::of(&QLocalSocket::error), this, &Connection::onErrorOccurred);
+#else
+        m_lastOnErrorConn = connect(m_localSocket, &QLocalSocket::errorOccurred, this, &Connection::onErrorOccurred);
+#endif
+        m_lastOnConnectedConn = connect(m_localSocket, &QLocalSocket::connected, this, &Connection::onConnected);
+        m_lastOnDisconnectedConn = connect(m_localSocket, &QLocalSocket::disconnected, this, &Connection::onDisconnected);
+    }
+    else if(m_type == SocketCAN)
+    {
+        // The socket notifier is not persistent, so the related signals/slots are not handled there.
+        // readyRead() -> CAN_onReadyRead() (connected in CAN_open())
+    }
+    else if(m_type == RFC2217_Server)
+    {
+        // readyRead() of clients -> RFC2217Server_onClientReadyRead() (connected in onClientConnected())
+        m_lastReadyReadConn = connect(m_serialPort, &QIODevice::readyRead, this, &Connection::onReadyRead);
+        m_lastOnErrorConn = connect(m_serialPort, &QSerialPort::errorOccurred, this, &Connection::onErrorOccurred);
+        m_lastOnConnectedConn = connect(m_TCPServer, &QTcpServer::newConnection, this, &Connection::Server_onClientConnected);
+    }
 }
 
 void Connection::BTServer_initServiceInfo()
@@ -557,12 +767,15 @@ void Connection::changeState(State newState)
 {
     State oldState = m_state;
     m_state = newState;
+    if(newState == Connected && oldState != Connected)
+        Metrics::add(Metrics::Connections);
     if(newState != oldState)
         emit stateChanged(newState, oldState);
 }
 
 void Connection::onReadyRead()
 {
+    const int oldSize = m_buf.size();
     if(m_type == SerialPort)
     {
         m_buf += m_serialPort->readAll();
@@ -590,13 +803,59 @@ void Connection::onReadyRead()
         while(m_UDPSocket->hasPendingDatagrams())
             m_buf += m_UDPSocket->receiveDatagram().data();
     }
+    else if(m_type == Process)
+    {
+        m_buf += m_process->readAllStandardOutput();
+    }
+    else if(m_type == LocalSocket)
+    {
+        m_buf += m_localSocket->readAll();
+    }
+    else if(m_type == RFC2217_Client)
+    {
+        const QByteArray rawData = m_TCPSocket->readAll();
+        m_buf += m_RFC2217Codec.decode(rawData.constData(), rawData.size());
+        QByteArray reply = m_RFC2217Codec.takeReply();
+        if(!m_RFC2217_lineSettingsSent && m_RFC2217Codec.comPortEnabled())
+        {
+            reply += RFC2217_lineSettings(m_currSPArgument);
+            // notify all changes of the modem state
+            reply += RFC2217::comPortCommand(RFC2217::SET_MODEMSTATE_MASK, (quint8)0xFF);
+            m_RFC2217_lineSettingsSent = true;
+        }
+        if(!reply.isEmpty())
+            m_TCPSocket->write(reply);
+        const QList<RFC2217::ComPortCommand> commandList = m_RFC2217Codec.takeCommands();
+        for(const RFC2217::ComPortCommand& command : commandList)
+            RFC2217Client_handleCommand(command);
+    }
+    else if(m_type == RFC2217_Server)
+    {
+        const QByteArray data = m_serialPort->readAll();
+        m_buf += data;
+        // forward to all clients
+        const QByteArray encodedData = RFC2217::encode(data.constData(), data.size());
+        for(auto it = m_TCPTxClients.cbegin(); it != m_TCPTxClients.cend(); ++it)
+            (*it)->write(encodedData);
+    }
+    afterReceived(oldSize);
+}
+
+void Connection::afterReceived(int oldSize)
+{
+    // m_buf is changed by readAll() later, a raw view of it would dangle in a queued slot
+    if(m_buf.size() > oldSize)
+        emit dataReceived(m_buf.mid(oldSize));
     emit readyRead();
 }
 
 void Connection::onErrorOccurred()
 {
     qDebug() << "Connection::onErrorOccurred()";
-    if(m_type == SerialPort)
+    // QSerialPort reports NoError after clearError()
+    if(!((m_type == SerialPort || m_type == RFC2217_Server) && m_serialPort->error() == QSerialPort::NoError))
+        Metrics::add(Metrics::Errors);
+    if(m_type == SerialPort || m_type == RFC2217_Server)
     {
         // connectFailed() is emitted in open()
         QSerialPort::SerialPortError error;
@@ -692,7 +951,7 @@ void Connection::onErrorOccurred()
             }
         }
     }
-    else if(m_type == TCP_Client)
+    else if(m_type == TCP_Client || m_type == RFC2217_Client)
     {
         QAbstractSocket::SocketError error;
         error = m_TCPSocket->error();
@@ -750,6 +1009,42 @@ void Connection::onErrorOccurred()
         qDebug() << "UDP State:" << m_UDPSocket->state();
 
     }
+    else if(m_type == Process)
+    {
+        QProcess::ProcessError error;
+        error = m_process->error();
+        if(m_isCollectingErrorString)
+            m_errorStringList += m_process->errorString();
+        qDebug() << "Process Error:" << error << m_process->errorString();
+        qDebug() << "Process State:" << m_process->state();
+
+        // Crashed is followed by finished(), which calls onDisconnected()
+        // other errors don't stop the process
+        if(error == QProcess::FailedToStart)
+        {
+            emit connectFailed(getErrorStringList());
+            onDisconnected();
+        }
+    }
+    else if(m_type == LocalSocket)
+    {
+        QLocalSocket::LocalSocketError error;
+        error = m_localSocket->error();
+        if(m_isCollectingErrorString)
+            m_errorStringList += m_localSocket->errorString();
+        qDebug() << "Local Socket Error:" << error << m_localSocket->errorString();
+        qDebug() << "State:" << m_localSocket->state();
+
+        // keep the statement in TCP_Client in same
+        if(error == QLocalSocket::OperationError || error == QLocalSocket::UnsupportedSocketOperationError)
+            ;
+        else
+        {
+            if(m_state == Connecting)
+                emit connectFailed(getErrorStringList());
+            close(true); // this will emit disconnected()
+        }
+    }
     emit errorOccurred();
 }
 
@@ -757,9 +1052,17 @@ QByteArray Connection::readAll()
 {
     QByteArray result(m_buf);
     m_buf.clear();
+    m_frameBuf.clear();
     return result;
 }
 
+QByteArray Connection::readAll(QVector<Metadata>& frameList)
+{
+    frameList.swap(m_frameBuf);
+    m_frameBuf.clear();
+    return readAll();
+}
+
 qint64 Connection::write(const char *data, qint64 len)
 {
     if(m_type == SerialPort)
@@ -814,6 +1117,29 @@ qint64 Connection::write(const char *data, qint64 len)
     {
         return m_UDPSocket->writeDatagram(data, len, QHostAddress(m_currNetArgument.remoteName), m_currNetArgument.remotePort);
     }
+    else if(m_type == Process)
+    {
+        return m_process->write(data, len);
+    }
+    else if(m_type == LocalSocket)
+    {
+        return m_localSocket->write(data, len);
+    }
+    else if(m_type == SocketCAN)
+    {
+        return CAN_write(data, len);
+    }
+    else if(m_type == RFC2217_Client)
+    {
+        // IAC in data is doubled, return the length of the raw data
+        if(m_TCPSocket->write(RFC2217::encode(data, len)) < 0)
+            return -1;
+        return len;
+    }
+    else if(m_type == RFC2217_Server)
+    {
+        return m_serialPort->write(data, len);
+    }
     return 0;
 }
 
@@ -856,7 +1182,34 @@ void Connection::afterConnected()
         m_lastNetArgument = m_currNetArgument;
         m_lastNetArgumentValid = true;
     }
-    if(m_pollTimerEnabled)
+    else if(m_type == Process || m_type == LocalSocket)
+    {
+        m_lastLocalArgument = m_currLocalArgument;
+        m_lastLocalArgumentValid = true;
+    }
+    else if(m_type == SocketCAN)
+    {
+        m_lastCANArgument = m_currCANArgument;
+        m_lastCANArgumentValid = true;
+    }
+    else if(m_type == RFC2217_Client || m_type == RFC2217_Server)
+    {
+        m_lastSPArgument = m_currSPArgument;
+        m_lastSPArgumentValid = true;
+        m_lastNetArgument = m_currNetArgument;
+        m_lastNetArgumentValid = true;
+    }
+    if(m_type == RFC2217_Client)
+    {
+        // the client offers COM-PORT-OPTION
+        m_TCPSocket->write(m_RFC2217Codec.startNegotiation());
+    }
+    else if(m_type == RFC2217_Server)
+    {
+        // the modem state is sent to clients in onPollingTimeout()
+        m_SP_lastSignals = m_serialPort->pinoutSignals();
+    }
+    if(m_pollTimerEnabled || m_type == RFC2217_Server)
         m_pollTimer->start();
     setCollectingErrorStringList(false);
     emit connected();
@@ -908,6 +1261,28 @@ void Connection::Server_onClientConnected()
         m_TCPTxClients.append(socket);
         emit TCP_clientConnected();
     }
+    else if(m_type == RFC2217_Server)
+    {
+        QTcpSocket* socket = m_TCPServer->nextPendingConnection();
+        if(!socket)
+            return;
+
+        // the serial port is opened, so the state is always Connected
+        connect(socket, &QTcpSocket::readyRead, this, &Connection::RFC2217Server_onClientReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &Connection::Server_onClientDisconnected);
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+        connect(socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error), this, &Connection::Server_onClientErrorOccurred);
+#else
+        connect(socket, &QAbstractSocket::errorOccurred, this, &Connection::Server_onClientErrorOccurred);
+#endif
+        RFC2217 codec(true);
+        socket->write(codec.startNegotiation());
+        socket->write(RFC2217::comPortCommand(RFC2217::NOTIFY_MODEMSTATE + RFC2217::SERVER_OFFSET, RFC2217::fromPinoutSignals(m_SP_lastSignals)));
+        m_RFC2217ClientCodecs.insert(socket, codec);
+        m_TCPConnectedClients.append(socket);
+        m_TCPTxClients.append(socket);
+        emit TCP_clientConnected();
+    }
 }
 
 // this will be called by cliendDisconnected() and clientErrorOccurred()
@@ -954,6 +1329,20 @@ void Connection::Server_onClientDisconnectedHandler(QObject * clientObj)
         if(firstCall)
             emit TCP_clientDisconnected();
     }
+    else if(m_type == RFC2217_Server)
+    {
+        QTcpSocket *socket = qobject_cast<QTcpSocket *>(clientObj);
+        if(!socket)
+            return;
+
+        // the state is not changed, the serial port is still opened
+        firstCall = m_TCPConnectedClients.removeOne(socket);
+        m_TCPTxClients.removeOne(socket);
+        m_RFC2217ClientCodecs.remove(socket);
+        socket->deleteLater();
+        if(firstCall)
+            emit TCP_clientDisconnected();
+    }
 }
 
 void Connection::Server_onClientDisconnected()
@@ -964,6 +1353,7 @@ void Connection::Server_onClientDisconnected()
 void Connection::Server_onClientErrorOccurred()
 {
     qDebug() << "Connection::Server_onClientErrorOccurred()";
+    Metrics::add(Metrics::Errors);
     if(m_type == BT_Server)
     {
         QBluetoothSocket *socket = qobject_cast<QBluetoothSocket *>(sender());
@@ -986,7 +1376,7 @@ void Connection::Server_onClientErrorOccurred()
             Server_onClientDisconnectedHandler(sender());
         }
     }
-    else if(m_type == TCP_Server)
+    else if(m_type == TCP_Server || m_type == RFC2217_Server)
     {
         QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
         QTcpSocket::SocketError socketError;
@@ -1016,42 +1406,93 @@ void Connection::onPollingTimeout()
             emit SP_signalsChanged(newSignal);
         m_SP_lastSignals = newSignal;
     }
+    else if(m_type == RFC2217_Server)
+    {
+        QSerialPort::PinoutSignals newSignal;
+        newSignal = SP_pinoutSignals();
+        if(newSignal != m_SP_lastSignals)
+        {
+            if(m_pollTimerEnabled)
+                emit SP_signalsChanged(newSignal);
+            const quint8 modemState = RFC2217::modemState(RFC2217::fromPinoutSignals(m_SP_lastSignals), RFC2217::fromPinoutSignals(newSignal));
+            const QByteArray notification = RFC2217::comPortCommand(RFC2217::NOTIFY_MODEMSTATE + RFC2217::SERVER_OFFSET, modemState);
+            for(auto it = m_TCPConnectedClients.cbegin(); it != m_TCPConnectedClients.cend(); ++it)
+                (*it)->write(notification);
+        }
+        m_SP_lastSignals = newSignal;
+    }
 }
 
 QSerialPort::PinoutSignals Connection::SP_pinoutSignals()
 {
+    if(m_type == RFC2217_Client)
+    {
+        // the server only reports the input signals
+        QSerialPort::PinoutSignals result = RFC2217::toPinoutSignals(m_RFC2217_modemState);
+        if(m_RFC2217_DTR)
+            result |= QSerialPort::DataTerminalReadySignal;
+        if(m_RFC2217_RTS)
+            result |= QSerialPort::RequestToSendSignal;
+        return result;
+    }
     return m_serialPort->pinoutSignals();
 }
 
 bool Connection::SP_setDataTerminalReady(bool set)
 {
-    if(m_type != SerialPort)
+    if(m_type == RFC2217_Client)
+    {
+        if(!RFC2217_sendCommand(RFC2217::comPortCommand(RFC2217::SET_CONTROL, (quint8)(set ? RFC2217::DTR_ON : RFC2217::DTR_OFF))))
+            return false;
+        m_RFC2217_DTR = set;
+        return true;
+    }
+    if(m_type != SerialPort && m_type != RFC2217_Server)
         return false;
     return m_serialPort->setDataTerminalReady(set);
 }
 
 bool Connection::SP_isDataTerminalReady()
 {
+    if(m_type == RFC2217_Client)
+        return m_RFC2217_DTR;
     return m_serialPort->isDataTerminalReady();
 }
 
 bool Connection::SP_setRequestToSend(bool set)
 {
-    if(m_type != SerialPort)
+    if(m_type == RFC2217_Client)
+    {
+        if(!RFC2217_sendCommand(RFC2217::comPortCommand(RFC2217::SET_CONTROL, (quint8)(set ? RFC2217::RTS_ON : RFC2217::RTS_OFF))))
+            return false;
+        m_RFC2217_RTS = set;
+        return true;
+    }
+    if(m_type != SerialPort && m_type != RFC2217_Server)
         return false;
     return m_serialPort->setRequestToSend(set);
 }
 
 bool Connection::SP_isRequestToSend()
 {
+    if(m_type == RFC2217_Client)
+        return m_RFC2217_RTS;
     return m_serialPort->isRequestToSend();
 }
 
 bool Connection::SP_setBaudRate(qint32 baudRate)
 {
-    if(m_type != SerialPort)
-        return false;
-    if(!m_serialPort->setBaudRate(baudRate))
+    if(m_type == SerialPort || m_type == RFC2217_Server)
+    {
+        if(!m_serialPort->setBaudRate(baudRate))
+            return false;
+    }
+    else if(m_type == RFC2217_Client)
+    {
+        if(!RFC2217_sendCommand(RFC2217::comPortCommand(RFC2217::SET_BAUDRATE, (quint32)baudRate)))
+            return false;
+    }
+    else
         return false;
     m_currSPArgument.baudRate = baudRate;
     if(isConnected() && m_lastSPArgumentValid)
@@ -1061,14 +1502,33 @@ bool Connection::SP_setBaudRate(qint32 baudRate)
 
 qint32 Connection::SP_baudRate()
 {
+    if(m_type == RFC2217_Client)
+        return m_currSPArgument.baudRate;
     return m_serialPort->baudRate();
 }
 
+int Connection::SP_handle()
+{
+#ifdef Q_OS_UNIX
+    if(m_type == SerialPort && m_serialPort->isOpen())
+        return m_serialPort->handle();
+#endif
+    return -1;
+}
+
 bool Connection::SP_setDataBits(QSerialPort::DataBits dataBits)
 {
-    if(m_type != SerialPort)
-        return false;
-    if(!m_serialPort->setDataBits(dataBits))
+    if(m_type == SerialPort || m_type == RFC2217_Server)
+    {
+        if(!m_serialPort->setDataBits(dataBits))
+            return false;
+    }
+    else if(m_type == RFC2217_Client)
+    {
+        if(!RFC2217_sendCommand(RFC2217::comPortCommand(RFC2217::SET_DATASIZE, (quint8)dataBits)))
+            return false;
+    }
+    else
         return false;
     m_currSPArgument.dataBits = dataBits;
     if(isConnected() && m_lastSPArgumentValid)
@@ -1078,9 +1538,17 @@ bool Connection::SP_setDataBits(QSerialPort::DataBits dataBits)
 
 bool Connection::SP_setStopBits(QSerialPort::StopBits stopBits)
 {
-    if(m_type != SerialPort)
-        return false;
-    if(!m_serialPort->setStopBits(stopBits))
+    if(m_type == SerialPort || m_type == RFC2217_Server)
+    {
+        if(!m_serialPort->setStopBits(stopBits))
+            return false;
+    }
+    else if(m_type == RFC2217_Client)
+    {
+        if(!RFC2217_sendCommand(RFC2217::comPortCommand(RFC2217::SET_STOPSIZE, RFC2217::fromStopBits(stopBits))))
+            return false;
+    }
+    else
         return false;
     m_currSPArgument.stopBits = stopBits;
     if(isConnected() && m_lastSPArgumentValid)
@@ -1090,9 +1558,17 @@ bool Connection::SP_setStopBits(QSerialPort::StopBits stopBits)
 
 bool Connection::SP_setParity(QSerialPort::Parity parity)
 {
-    if(m_type != SerialPort)
-        return false;
-    if(!m_serialPort->setParity(parity))
+    if(m_type == SerialPort || m_type == RFC2217_Server)
+    {
+        if(!m_serialPort->setParity(parity))
+            return false;
+    }
+    else if(m_type == RFC2217_Client)
+    {
+        if(!RFC2217_sendCommand(RFC2217::comPortCommand(RFC2217::SET_PARITY, RFC2217::fromParity(parity))))
+            return false;
+    }
+    else
         return false;
     m_currSPArgument.parity = parity;
     if(isConnected() && m_lastSPArgumentValid)
@@ -1102,9 +1578,17 @@ bool Connection::SP_setParity(QSerialPort::Parity parity)
 
 bool Connection::SP_setFlowControl(QSerialPort::FlowControl flowControl)
 {
-    if(m_type != SerialPort)
-        return false;
-    if(!m_serialPort->setFlowControl(flowControl))
+    if(m_type == SerialPort || m_type == RFC2217_Server)
+    {
+        if(!m_serialPort->setFlowControl(flowControl))
+            return false;
+    }
+    else if(m_type == RFC2217_Client)
+    {
+        if(!RFC2217_sendCommand(RFC2217::comPortCommand(RFC2217::SET_CONTROL, RFC2217::fromFlowControl(flowControl))))
+            return false;
+    }
+    else
         return false;
     m_currSPArgument.flowControl = flowControl;
     if(isConnected() && m_lastSPArgumentValid)
@@ -1189,6 +1673,11 @@ QList<QTcpSocket *> Connection::TCPServer_clientList() const
     return m_TCPConnectedClients;
 }
 
+QList<QTcpSocket *> Connection::TCPServer_TxClientList() const
+{
+    return m_TCPTxClients;
+}
+
 int Connection::TCPServer_clientCount()
 {
     return m_TCPConnectedClients.count();
@@ -1217,6 +1706,404 @@ bool Connection::TCPServer_setClientMode(QTcpSocket * clientSocket, bool RxEnabl
     return true;
 }
 
+qint64 Connection::Process_processId()
+{
+    if(m_type != Process)
+        return 0;
+    return m_process->processId();
+}
+
+bool Connection::CAN_open()
+{
+#ifdef Q_OS_LINUX
+    const int enabled = 1;
+    struct sockaddr_can addr;
+    unsigned int ifIndex;
+    int fd;
+
+    ifIndex = if_nametoindex(m_currCANArgument.interfaceName.toLocal8Bit().constData());
+    if(ifIndex == 0)
+    {
+        m_errorStringList += tr("No such interface") + ": " + m_currCANArgument.interfaceName;
+        return false;
+    }
+    fd = ::socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if(fd < 0)
+    {
+        m_errorStringList += QString::fromLocal8Bit(strerror(errno));
+        return false;
+    }
+    // kernel timestamp for every frame, fetched from the ancillary data in CAN_onReadyRead()
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMP, &enabled, sizeof(enabled));
+    if(m_currCANArgument.FDEnabled && setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enabled, sizeof(enabled)) < 0)
+    {
+        m_errorStringList += tr("CAN FD is not supported") + ": " + QString::fromLocal8Bit(strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    // error frames are shown as well
+    const can_err_mask_t errMask = CAN_ERR_MASK;
+    setsockopt(fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errMask, sizeof(errMask));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifIndex;
+    if(::bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+        m_errorStringList += QString::fromLocal8Bit(strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    m_CANSocket = fd;
+    m_CANNotifier = new QSocketNotifier(fd, QSocketNotifier::Read);
+    connect(m_CANNotifier, &QSocketNotifier::activated, this, &Connection::CAN_onReadyRead);
+    return true;
+#else
+    m_errorStringList += tr("SocketCAN is only supported on Linux");
+    return false;
+#endif
+}
+
+void Connection::CAN_close()
+{
+#ifdef Q_OS_LINUX
+    if(m_CANNotifier != nullptr)
+    {
+        m_CANNotifier->setEnabled(false);
+        m_CANNotifier->deleteLater();
+        m_CANNotifier = nullptr;
+    }
+    if(m_CANSocket >= 0)
+    {
+        ::close(m_CANSocket);
+        m_CANSocket = -1;
+    }
+#endif
+}
+
+void Connection::CAN_onReadyRead()
+{
+#ifdef Q_OS_LINUX
+    // fetch up to batchSize frames in one syscall
+    const int batchSize = 64;
+    struct canfd_frame frames[batchSize];
+    struct iovec iov[batchSize];
+    struct mmsghdr msgs[batchSize];
+    char ctrl[batchSize][CMSG_SPACE(sizeof(struct timeval))];
+    const int oldSize = m_buf.size();
+    bool hasData = false;
+    int num;
+
+    if(m_CANSocket < 0)
+        return;
+    while(true)
+    {
+        memset(msgs, 0, sizeof(msgs));
+        for(int i = 0; i < batchSize; i++)
+        {
+            iov[i].iov_base = &frames[i];
+            iov[i].iov_len = sizeof(struct canfd_frame);
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_control = ctrl[i];
+            msgs[i].msg_hdr.msg_controllen = sizeof(ctrl[i]);
+        }
+        num = recvmmsg(m_CANSocket, msgs, batchSize, MSG_DONTWAIT, nullptr);
+        if(num < 0)
+        {
+            if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                qDebug() << "SocketCAN Error:" << strerror(errno);
+                // the interface is down or removed
+                if(errno == ENETDOWN || errno == ENODEV)
+                    close(true);
+            }
+            break;
+        }
+        for(int i = 0; i < num; i++)
+        {
+            // CAN_MTU for classic frames, CANFD_MTU for FD frames
+            if(msgs[i].msg_len != CAN_MTU && msgs[i].msg_len != CANFD_MTU)
+                continue;
+            qint64 timestamp = 0;
+            for(struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg))
+            {
+                if(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMP)
+                {
+                    struct timeval tv;
+                    memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+                    timestamp = tv.tv_sec * 1000LL + tv.tv_usec / 1000;
+                }
+            }
+            if(timestamp == 0)
+                timestamp = QDateTime::currentMSecsSinceEpoch();
+            Metadata frame(m_buf.size(), frames[i].len, timestamp, frames[i].can_id);
+            // a remote frame has a DLC but no data
+            if(frames[i].can_id & CAN_RTR_FLAG)
+            {
+                frame.len = 0;
+                frame.remoteDLC = frames[i].len;
+            }
+            m_frameBuf.append(frame);
+            m_buf.append((const char*)frames[i].data, frame.len);
+        }
+        hasData |= (num > 0);
+        if(num < batchSize)
+            break;
+    }
+    // the same signals as the other types, so the bridge gets the payload as well
+    if(hasData)
+        afterReceived(oldSize);
+#endif
+}
+
+qint64 Connection::CAN_write(const char *data, qint64 len)
+{
+    // The data is parsed as lines of frames in the format of cansend:
+    // <can_id>#{data}            classic frame, e.g. 123#DEADBEEF, 12345678#11.22
+    // <can_id>#R{len}            remote transmission request, len is the DLC(0 by default)
+    // <can_id>##<flags>{data}    CAN FD frame, e.g. 123##1AABBCC
+    // can_id with 3 hex digits is a standard frame, 8 hex digits is an extended frame.
+#ifdef Q_OS_LINUX
+    if(m_CANSocket < 0)
+        return -1;
+    const QList<QByteArray> lines = QByteArray::fromRawData(data, len).split('\n');
+    qint64 writtenLen = 0;
+    for(const QByteArray& rawLine : lines)
+    {
+        const QByteArray line = rawLine.trimmed();
+        const int sp = line.indexOf('#');
+        if(line.isEmpty())
+        {
+            writtenLen += rawLine.size() + 1;
+            continue;
+        }
+        if(sp != 3 && sp != 8)
+        {
+            qDebug() << "SocketCAN: invalid frame" << line;
+            break;
+        }
+        struct canfd_frame frame;
+        bool ok, isFD = false;
+        int remoteDLC = -1;
+        QByteArray payload;
+        memset(&frame, 0, sizeof(frame));
+        frame.can_id = line.left(sp).toUInt(&ok, 16);
+        if(!ok)
+            break;
+        if(sp == 8)
+            frame.can_id |= CAN_EFF_FLAG;
+        payload = line.mid(sp + 1);
+        if(payload.startsWith('#'))
+        {
+            // CAN FD, the first hex digit is the flags
+            isFD = true;
+            frame.flags = QByteArray(payload.constData() + 1, qMin(1, payload.size() - 1)).toUInt(nullptr, 16);
+            payload = QByteArray::fromHex(payload.mid(2).replace('.', ""));
+        }
+        else if(payload.startsWith('R') || payload.startsWith('r'))
+        {
+            frame.can_id |= CAN_RTR_FLAG;
+            remoteDLC = (payload.size() > 1) ? payload.mid(1).toInt(&ok) : 0;
+            if(!ok || remoteDLC < 0 || remoteDLC > CAN_MAX_DLEN)
+            {
+                qDebug() << "SocketCAN: invalid DLC" << line;
+                break;
+            }
+            payload.clear();
+        }
+        else
+            payload = QByteArray::fromHex(payload.replace('.', ""));
+        if(payload.size() > (isFD ? CANFD_MAX_DLEN : CAN_MAX_DLEN))
+        {
+            qDebug() << "SocketCAN: payload too long" << line;
+            break;
+        }
+        frame.len = (remoteDLC >= 0) ? remoteDLC : payload.size();
+        memcpy(frame.data, payload.constData(), payload.size());
+        const size_t mtu = isFD ? CANFD_MTU : CAN_MTU;
+        if(::write(m_CANSocket, &frame, mtu) != (ssize_t)mtu)
+        {
+            qDebug() << "SocketCAN Error:" << strerror(errno);
+            break;
+        }
+        writtenLen += rawLine.size() + 1;
+    }
+    return qMin(writtenLen, len);
+#else
+    Q_UNUSED(data)
+    Q_UNUSED(len)
+    return -1;
+#endif
+}
+
+QString Connection::CAN_frameIdString(quint32 frameId)
+{
+#ifdef Q_OS_LINUX
+    if(frameId & CAN_ERR_FLAG)
+        return QString("ERR %1").arg(frameId & CAN_ERR_MASK, 8, 16, QLatin1Char('0')).toUpper();
+    QString result;
+    if(frameId & CAN_EFF_FLAG)
+        result = QString("%1").arg(frameId & CAN_EFF_MASK, 8, 16, QLatin1Char('0')).toUpper();
+    else
+        result = QString("%1").arg(frameId & CAN_SFF_MASK, 3, 16, QLatin1Char('0')).toUpper();
+    if(frameId & CAN_RTR_FLAG)
+        result += " R";
+    return result;
+#else
+    return QString::number(frameId, 16).toUpper();
+#endif
+}
+
+QByteArray Connection::RFC2217_lineSettings(const SerialPortArgument& arg)
+{
+    QByteArray result;
+    result += RFC2217::comPortCommand(RFC2217::SET_BAUDRATE, (quint32)arg.baudRate);
+    result += RFC2217::comPortCommand(RFC2217::SET_DATASIZE, (quint8)arg.dataBits);
+    result += RFC2217::comPortCommand(RFC2217::SET_PARITY, RFC2217::fromParity(arg.parity));
+    result += RFC2217::comPortCommand(RFC2217::SET_STOPSIZE, RFC2217::fromStopBits(arg.stopBits));
+    result += RFC2217::comPortCommand(RFC2217::SET_CONTROL, RFC2217::fromFlowControl(arg.flowControl));
+    return result;
+}
+
+bool Connection::RFC2217_sendCommand(const QByteArray& command)
+{
+    if(m_type != RFC2217_Client || !isConnected())
+        return false;
+    return m_TCPSocket->write(command) == command.size();
+}
+
+void Connection::RFC2217Client_handleCommand(const RFC2217::ComPortCommand& command)
+{
+    const QByteArray& value = command.value;
+    if(command.command == RFC2217::NOTIFY_MODEMSTATE + RFC2217::SERVER_OFFSET && !value.isEmpty())
+    {
+        QSerialPort::PinoutSignals newSignal;
+        m_RFC2217_modemState = value[0];
+        newSignal = SP_pinoutSignals();
+        if(newSignal != m_SP_lastSignals)
+            emit SP_signalsChanged(newSignal);
+        m_SP_lastSignals = newSignal;
+    }
+    else if(command.command == RFC2217::SET_BAUDRATE + RFC2217::SERVER_OFFSET && value.size() == 4)
+    {
+        // the server might not support the requested baudrate
+        const quint32 baudRate = qFromBigEndian<quint32>(value.constData());
+        if(baudRate != 0)
+            m_currSPArgument.baudRate = baudRate;
+    }
+    else
+        qDebug() << "RFC2217 response:" << command.command << value.toHex();
+}
+
+void Connection::RFC2217Server_onClientReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    auto codecIt = m_RFC2217ClientCodecs.find(socket);
+    if(codecIt == m_RFC2217ClientCodecs.end())
+        return;
+
+    const QByteArray rawData = socket->readAll();
+    const QByteArray data = codecIt->decode(rawData.constData(), rawData.size());
+    // the data from clients goes to the serial port directly
+    if(!data.isEmpty())
+        m_serialPort->write(data);
+    const QByteArray reply = codecIt->takeReply();
+    if(!reply.isEmpty())
+        socket->write(reply);
+    const QList<RFC2217::ComPortCommand> commandList = codecIt->takeCommands();
+    for(const RFC2217::ComPortCommand& command : commandList)
+        RFC2217Server_handleCommand(socket, command);
+}
+
+void Connection::RFC2217Server_handleCommand(QTcpSocket* socket, const RFC2217::ComPortCommand& command)
+{
+    // the server replies the current value of every setting, value 0 is a query
+    const quint8 response = command.command + RFC2217::SERVER_OFFSET;
+    const QByteArray& value = command.value;
+    const quint8 firstByte = value.isEmpty() ? 0 : value[0];
+    switch(command.command)
+    {
+    case RFC2217::SIGNATURE:
+        socket->write(RFC2217::comPortCommand(response, QByteArray("SerialTest")));
+        break;
+    case RFC2217::SET_BAUDRATE:
+    {
+        const quint32 baudRate = (value.size() == 4) ? qFromBigEndian<quint32>(value.constData()) : 0;
+        if(baudRate != 0)
+            SP_setBaudRate(baudRate);
+        socket->write(RFC2217::comPortCommand(response, (quint32)m_serialPort->baudRate()));
+        break;
+    }
+    case RFC2217::SET_DATASIZE:
+        if(firstByte >= 5 && firstByte <= 8)
+            SP_setDataBits((QSerialPort::DataBits)firstByte);
+        socket->write(RFC2217::comPortCommand(response, (quint8)m_serialPort->dataBits()));
+        break;
+    case RFC2217::SET_PARITY:
+        if(firstByte != 0)
+            SP_setParity(RFC2217::toParity(firstByte));
+        socket->write(RFC2217::comPortCommand(response, RFC2217::fromParity(m_serialPort->parity())));
+        break;
+    case RFC2217::SET_STOPSIZE:
+        if(firstByte != 0)
+            SP_setStopBits(RFC2217::toStopBits(firstByte));
+        socket->write(RFC2217::comPortCommand(response, RFC2217::fromStopBits(m_serialPort->stopBits())));
+        break;
+    case RFC2217::SET_CONTROL:
+    {
+        quint8 state = firstByte;
+        switch(firstByte)
+        {
+        case RFC2217::FLOW_NONE:
+        case RFC2217::FLOW_XONXOFF:
+        case RFC2217::FLOW_HARDWARE:
+            SP_setFlowControl(RFC2217::toFlowControl(firstByte));
+        case RFC2217::FLOW_REQUEST:
+            state = RFC2217::fromFlowControl(m_serialPort->flowControl());
+            break;
+        case RFC2217::BREAK_ON:
+        case RFC2217::BREAK_OFF:
+            m_serialPort->setBreakEnabled(firstByte == RFC2217::BREAK_ON);
+        case RFC2217::BREAK_REQUEST:
+            state = m_serialPort->isBreakEnabled() ? RFC2217::BREAK_ON : RFC2217::BREAK_OFF;
+            break;
+        case RFC2217::DTR_ON:
+        case RFC2217::DTR_OFF:
+            SP_setDataTerminalReady(firstByte == RFC2217::DTR_ON);
+        case RFC2217::DTR_REQUEST:
+            state = m_serialPort->isDataTerminalReady() ? RFC2217::DTR_ON : RFC2217::DTR_OFF;
+            break;
+        case RFC2217::RTS_ON:
+        case RFC2217::RTS_OFF:
+            SP_setRequestToSend(firstByte == RFC2217::RTS_ON);
+        case RFC2217::RTS_REQUEST:
+            state = m_serialPort->isRequestToSend() ? RFC2217::RTS_ON : RFC2217::RTS_OFF;
+            break;
+        }
+        socket->write(RFC2217::comPortCommand(response, state));
+        break;
+    }
+    case RFC2217::PURGE_DATA:
+        if(firstByte == 1)
+            m_serialPort->clear(QSerialPort::Input);
+        else if(firstByte == 2)
+            m_serialPort->clear(QSerialPort::Output);
+        else if(firstByte == 3)
+            m_serialPort->clear(QSerialPort::AllDirections);
+        socket->write(RFC2217::comPortCommand(response, firstByte));
+        break;
+    case RFC2217::SET_LINESTATE_MASK:
+    case RFC2217::SET_MODEMSTATE_MASK:
+        // all changes are notified, the masks are acknowledged only
+        socket->write(RFC2217::comPortCommand(response, firstByte));
+        break;
+    default:
+        qDebug() << "RFC2217 unsupported command:" << command.command << value.toHex();
+        break;
+    }
+}
+
 void Connection::blackhole()
 {
     // discard received data
@@ -1383,8 +2270,9 @@ void Connection::BLEC_onServiceDetailDiscovered(QLowEnergyService::ServiceState
 void Connection::BLEC_onDataArrived(const QLowEnergyCharacteristic & characteristic, const QByteArray & newValue)
 {
     Q_UNUSED(characteristic)
+    const int oldSize = m_buf.size();
     m_buf += newValue;
-    emit readyRead();
+    afterReceived(oldSize);
 }
 
 void Connection::setCollectingErrorStringList(bool state)
@@ -1403,7 +2291,12 @@ const QMap<Connection::Type, QLatin1String> Connection::m_typeNameMap
     {Connection::BLE_Peripheral, QLatin1String(QT_TR_NOOP("BLE Peripheral"))},
     {Connection::TCP_Client, QLatin1String(QT_TR_NOOP("TCP Client"))},
     {Connection::TCP_Server, QLatin1String(QT_TR_NOOP("TCP Server"))},
-    {Connection::UDP, QLatin1String(QT_TR_NOOP("UDP"))}
+    {Connection::UDP, QLatin1String(QT_TR_NOOP("UDP"))},
+    {Connection::Process, QLatin1String(QT_TR_NOOP("Subprocess"))},
+    {Connection::LocalSocket, QLatin1String(QT_TR_NOOP("Local Socket"))},
+    {Connection::SocketCAN, QLatin1String(QT_TR_NOOP("SocketCAN"))},
+    {Connection::RFC2217_Client, QLatin1String(QT_TR_NOOP("RFC2217 Client"))},
+    {Connection::RFC2217_Server, QLatin1String(QT_TR_NOOP("RFC2217 Server"))}
 };
 
 bool Connection::NetworkArgument::operator==(const NetworkArgument &other) const
@@ -1461,3 +2354,22 @@ QDebug operator<<(QDebug dbg, const Connection::NetworkArgument& arg)
                   << arg.alias << ")";
     return dbg;
 }
+
+QDebug operator<<(QDebug dbg, const Connection::LocalArgument& arg)
+{
+    QDebugStateSaver saver(dbg);
+    dbg.nospace() << "("
+                  << arg.name << ","
+                  << arg.arguments << ","
+                  << arg.workingDirectory << ")";
+    return dbg;
+}
+
+QDebug operator<<(QDebug dbg, const Connection::CANArgument& arg)
+{
+    QDebugStateSaver saver(dbg);
+    dbg.nospace() << "("
+                  << arg.interfaceName << ","
+                  << arg.FDEnabled << ")";
+    return dbg;
+}
@@ -12,9 +12,15 @@
 #include <QTcpSocket>
 #include <QTcpServer>
 #include <QUdpSocket>
+#include <QProcess>
+#include <QLocalSocket>
+#include <QSocketNotifier>
 #include <QDataStream>
 #include <QDebug>
 
+#include "metadata.h"
+#include "rfc2217.h"
+
 class Connection : public QObject
 {
     Q_OBJECT
@@ -28,7 +34,12 @@ public:
         BLE_Peripheral,
         TCP_Client,
         TCP_Server,
-        UDP
+        UDP,
+        Process,
+        LocalSocket,
+        SocketCAN,
+        RFC2217_Client,
+        RFC2217_Server
     };
     Q_ENUM(Type)
 
@@ -76,6 +87,21 @@ public:
         bool operator==(const NetworkArgument& other) const;
     };
 
+    struct LocalArgument
+    {
+        // program for Process, server name or socket path for LocalSocket
+        QString name;
+        // for Process only
+        QStringList arguments;
+        QString workingDirectory;
+    };
+
+    struct CANArgument
+    {
+        QString interfaceName;
+        bool FDEnabled = false;
+    };
+
     explicit Connection(QObject *parent = nullptr);
 
     // general
@@ -89,11 +115,15 @@ public:
     static QString getTypeName(Type type);
     static const QMap<Connection::Type, QLatin1String>& getTypeNameMap();
     QStringList getErrorStringList() const;
+    // the last error of the device, for the failures after connected
+    QString errorString() const;
 
     // connection
     SerialPortArgument getSerialPortArgument();
     BTArgument getBTArgument();
     NetworkArgument getNetworkArgument(bool fillLocalAddress = true, bool fillLocalPort = true);
+    LocalArgument getLocalArgument();
+    CANArgument getCANArgument();
     static QStringList arg2StringList(const SerialPortArgument& arg);
     static QStringList arg2StringList(const BTArgument& arg);
     static QStringList arg2StringList(const NetworkArgument& arg);
@@ -103,6 +133,8 @@ public:
 
     // IO
     QByteArray readAll();
+    // for frame-based types, every frame has a Metadata, pos is relative to the returned data
+    QByteArray readAll(QVector<Metadata>& frameList);
     qint64 write(const char *data, qint64 len);
     qint64 write(const QByteArray &data);
 
@@ -114,6 +146,8 @@ public:
     bool SP_isRequestToSend();
     bool SP_setBaudRate(qint32 baudRate);
     qint32 SP_baudRate();
+    // the file descriptor of the local serial port on Unix, -1 for others
+    int SP_handle();
     bool SP_setDataBits(QSerialPort::DataBits dataBits);
     bool SP_setStopBits(QSerialPort::StopBits stopBits);
     bool SP_setParity(QSerialPort::Parity parity);
@@ -131,8 +165,15 @@ public:
     // Network
     void UDP_setRemote(const QString& addr, quint16 port);
     QList<QTcpSocket*> TCPServer_clientList() const;
+    QList<QTcpSocket*> TCPServer_TxClientList() const;
     int TCPServer_clientCount();
     bool TCPServer_setClientMode(QTcpSocket* clientSocket, bool RxEnabled = true, bool TxEnabled = true);
+
+    // Process
+    qint64 Process_processId();
+
+    // SocketCAN
+    static QString CAN_frameIdString(quint32 frameId);
 public slots:
     // general
     void setPolling(bool enabled);
@@ -141,6 +182,8 @@ public slots:
     void setArgument(Connection::SerialPortArgument arg);
     void setArgument(Connection::BTArgument arg);
     void setArgument(Connection::NetworkArgument arg);
+    void setArgument(Connection::LocalArgument arg);
+    void setArgument(Connection::CANArgument arg);
     void open(); // async
     bool reopen(); // async, return false if no argument is stored in the previous connection
     void close(bool forced = false); // async
@@ -164,10 +207,12 @@ private:
     QMetaObject::Connection m_lastOnDisconnectedConn;
 
     // establish connetion and reconnect
-    bool m_lastSPArgumentValid = false, m_lastBTArgumentValid = false, m_lastNetArgumentValid = false;
+    bool m_lastSPArgumentValid = false, m_lastBTArgumentValid = false, m_lastNetArgumentValid = false, m_lastLocalArgumentValid = false, m_lastCANArgumentValid = false;
     SerialPortArgument m_lastSPArgument, m_currSPArgument;
     BTArgument m_lastBTArgument, m_currBTArgument;
     NetworkArgument m_lastNetArgument, m_currNetArgument;
+    LocalArgument m_lastLocalArgument, m_currLocalArgument;
+    CANArgument m_lastCANArgument, m_currCANArgument;
 
     QSerialPort* m_serialPort = nullptr;
     QBluetoothServer* m_BTServer = nullptr;
@@ -182,6 +227,12 @@ private:
     QTcpServer* m_TCPServer = nullptr;
     QTcpSocket* m_TCPSocket = nullptr;
     QUdpSocket* m_UDPSocket = nullptr;
+    QProcess* m_process = nullptr;
+    QLocalSocket* m_localSocket = nullptr;
+    int m_CANSocket = -1;
+    QSocketNotifier* m_CANNotifier = nullptr;
+    RFC2217 m_RFC2217Codec; // for RFC2217_Client
+    QHash<QTcpSocket*, RFC2217> m_RFC2217ClientCodecs; // for RFC2217_Server
 
     QList<QBluetoothSocket*> m_BTConnectedClients;
     QList<QBluetoothSocket*> m_BTTxClients;
@@ -195,12 +246,20 @@ private:
     // for characteristics without notify property in BLE, pinout signals in serialport
     QTimer* m_pollTimer = nullptr;
     bool m_pollTimerEnabled = false;
+    // the child process is killed if it doesn't exit after terminate()
+    QTimer* m_processKillTimer = nullptr;
+    static const int m_processKillTimeout = 1000;
 
     //
     QSerialPort::PinoutSignals m_SP_lastSignals;
     QList<QSerialPort::SerialPortError> m_SP_ignoredErrorList;
+    // the states of the remote port in RFC2217_Client
+    quint8 m_RFC2217_modemState = 0;
+    bool m_RFC2217_DTR = false, m_RFC2217_RTS = false;
+    bool m_RFC2217_lineSettingsSent = false;
 
     QByteArray m_buf;
+    QVector<Metadata> m_frameBuf; // for frame-based types
 
     bool m_isCollectingErrorString = false;
     QStringList m_errorStringList;
@@ -212,12 +271,26 @@ private:
     void BTServer_initServiceInfo();
     void BTServer_updateServicePort();
     void changeState(State newState);
+    // emits dataReceived() with m_buf[oldSize:] and readyRead()
+    void afterReceived(int oldSize);
     void Server_onClientDisconnectedHandler(QObject *clientObj);
     void afterConnected();
+    bool SP_open();
+    bool CAN_open();
+    void CAN_close();
+    qint64 CAN_write(const char *data, qint64 len);
+    QByteArray RFC2217_lineSettings(const SerialPortArgument& arg);
+    bool RFC2217_sendCommand(const QByteArray& command);
+    void RFC2217Client_handleCommand(const RFC2217::ComPortCommand& command);
+    void RFC2217Server_handleCommand(QTcpSocket* socket, const RFC2217::ComPortCommand& command);
 signals:
     void readyRead();
+    // emitted before readyRead() with the new data only, it's a copy so any connection type works
+    void dataReceived(const QByteArray& data);
     void connected();
     void disconnected();
+    // emitted in close() before the device is closed, for the users of SP_handle() in other threads
+    void aboutToClose();
     void connectFailed(const QString& info);
     void connectFailed(const QStringList& infoList);
     void errorOccurred();
@@ -242,6 +315,10 @@ private slots:
     void Server_onClientErrorOccurred();
     void onPollingTimeout();
     void blackhole();
+    // SocketCAN
+    void CAN_onReadyRead();
+    // RFC2217
+    void RFC2217Server_onClientReadyRead();
     // BLE
     void BLEC_onServiceDiscovered(const QBluetoothUuid& serviceUUID);
     void BLEC_onServiceDetailDiscovered(QLowEnergyService::ServiceState newState);
@@ -252,5 +329,7 @@ Q_DECLARE_METATYPE(Connection::SerialPortArgument)
 QDebug operator<<(QDebug dbg, const Connection::SerialPortArgument& arg);
 QDebug operator<<(QDebug dbg, const Connection::BTArgument& arg);
 QDebug operator<<(QDebug dbg, const Connection::NetworkArgument& arg);
+QDebug operator<<(QDebug dbg, const Connection::LocalArgument& arg);
+QDebug operator<<(QDebug dbg, const Connection::CANArgument& arg);
 
 #endif // CONNECTION_H
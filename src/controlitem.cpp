@@ -1,10 +1,12 @@
 ﻿#include "controlitem.h"
 #include "ui_controlitem.h"
 #include "util.h"
+#include "txtemplate.h"
 
 #include <QTextCodec>
 #include <QTimer>
 #include <QDateTime>
+#include <QMessageBox>
 
 ControlItem::ControlItem(Type type, QWidget *parent) :
     QWidget(parent),
@@ -17,13 +19,41 @@ ControlItem::ControlItem(Type type, QWidget *parent) :
 
     ui->confGrp->hide();
 
+    // connected before the auto sending in on_autoBox_stateChanged()
+    const auto invalidateFrame = [ = ]()
+    {
+        m_isFrameValid = false;
+    };
+    for(QLineEdit* edit : {ui->CMDEdit, ui->prefixEdit, ui->suffixEdit})
+        connect(edit, &QLineEdit::textChanged, this, invalidateFrame);
+    for(QCheckBox* box : {ui->hexBox, ui->unescapeBox, ui->templateBox, ui->prefixBox, ui->suffixBox, ui->checkBox})
+        connect(box, &QCheckBox::stateChanged, this, invalidateFrame);
+    connect(ui->prefixTypeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, invalidateFrame);
+    connect(ui->suffixTypeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, invalidateFrame);
+    connect(ui->slider, &QSlider::valueChanged, this, invalidateFrame);
+    connect(ui->spinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, invalidateFrame);
+
     this->type = type;
     initUI();
+
+    // the rules of the auto responder are rebuilt when any option is changed
+    const auto notifyResponder = [ = ]()
+    {
+        if(this->type == Responder)
+            emit responderChanged();
+    };
+    for(QLineEdit* edit : {ui->matchEdit, ui->CMDEdit, ui->prefixEdit, ui->suffixEdit, ui->delayEdit})
+        connect(edit, &QLineEdit::textChanged, this, notifyResponder);
+    for(QCheckBox* box : {ui->matchHexBox, ui->hexBox, ui->unescapeBox, ui->templateBox, ui->autoBox, ui->prefixBox, ui->suffixBox})
+        connect(box, &QCheckBox::stateChanged, this, notifyResponder);
+    connect(ui->prefixTypeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, notifyResponder);
+    connect(ui->suffixTypeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, notifyResponder);
 }
 
 void ControlItem::initUI()
 {
-    ui->CMDEdit->setVisible(type == Command);
+    ui->CMDEdit->setVisible(type == Command || type == Responder);
+    ui->matchEdit->setVisible(type == Responder);
     ui->sliderGrp->setVisible(type == Slider);
     ui->checkBox->setVisible(type == CheckBox);
     ui->spinBoxGrp->setVisible(type == SpinBox);
@@ -33,8 +63,14 @@ void ControlItem::initUI()
     ui->stepEdit->setVisible(type == SpinBox || type == Slider);
     ui->autoBox->setVisible(type != Command);
     ui->autoLabel->setVisible(type != Command);
-    ui->hexBox->setVisible(type == Command);
-    ui->hexLabel->setVisible(type == Command);
+    ui->hexBox->setVisible(type == Command || type == Responder);
+    ui->hexLabel->setVisible(type == Command || type == Responder);
+    // for Responder, the autoBox arms the rule
+    ui->autoLabel->setText(type == Responder ? tr("Enabled") : tr("Auto"));
+    ui->delayEdit->setVisible(type == Responder);
+    ui->matchHexBox->setVisible(type == Responder);
+    ui->matchHexLabel->setVisible(type == Responder);
+    ui->matchEdit->setPlaceholderText(tr("When received") + (ui->matchHexBox->isChecked() ? "(Hex)" : ""));
 
     on_minEdit_editingFinished();
     on_maxEdit_editingFinished();
@@ -178,68 +214,73 @@ void ControlItem::on_autoBox_stateChanged(int arg1)
 
 void ControlItem::on_sendButton_clicked()
 {
-    QByteArray data;
-    if(ui->prefixBox->isChecked())
+    QString errorString;
+    if(!compileFrame(&errorString))
     {
-        if(ui->prefixTypeBox->currentIndex() == 0)
-        {
-            if(ui->unescapeBox->isChecked())
-                data = Util::unescape(ui->prefixEdit->text(), dataCodec);
-            else
-                data = dataCodec->fromUnicode(ui->prefixEdit->text());
-        }
-        else if(ui->prefixTypeBox->currentIndex() == 1)
-            data = QByteArray::fromHex(ui->prefixEdit->text().toLatin1());
-        else if(ui->prefixTypeBox->currentIndex() == 2)
-            data = "\r\n";
-        else if(ui->prefixTypeBox->currentIndex() == 3)
-            data = "\n";
+        QMessageBox::warning(this, tr("Error"), tr("Invalid template:") + "\n" + errorString);
+        return;
     }
+    // the fields are patched into m_frame, nothing is parsed
+    emit send(m_frame.data(m_sendSequence++, QDateTime::currentMSecsSinceEpoch()));
+}
 
-    if(type == Command)
+bool ControlItem::compileFrame(QString* errorString)
+{
+    if(m_isFrameValid)
     {
-        if(ui->hexBox->isChecked())
-            data += QByteArray::fromHex(ui->CMDEdit->text().toLatin1());
-        else
-        {
-            if(ui->unescapeBox->isChecked())
-                data += Util::unescape(ui->CMDEdit->text(), dataCodec);
-            else
-                data += dataCodec->fromUnicode(ui->CMDEdit->text());
-        }
+        *errorString = m_frameError;
+        return m_frameError.isEmpty();
+    }
+    const TxTemplate::Converter toText = TxTemplate::textConverter(dataCodec, ui->unescapeBox->isChecked());
+    // the fields are only parsed in the template mode
+    TxTemplate sendTemplate(ui->templateBox->isChecked());
+
+    if(ui->prefixBox->isChecked())
+        sendTemplate.appendAffix(ui->prefixTypeBox->currentIndex(), ui->prefixEdit->text(), toText);
 
+    if(type == Command || type == Responder)
+    {
+        sendTemplate.append(ui->CMDEdit->text(), ui->hexBox->isChecked() ? TxTemplate::hexConverter() : toText);
     }
     else if(type == Slider)
     {
-        data += dataCodec->fromUnicode(QString::number(ui->slider->value()));
+        sendTemplate.appendRaw(dataCodec->fromUnicode(QString::number(ui->slider->value())));
     }
     else if(type == CheckBox)
     {
-        data += dataCodec->fromUnicode(ui->checkBox->isChecked() ? "1" : "0");
+        sendTemplate.appendRaw(dataCodec->fromUnicode(ui->checkBox->isChecked() ? "1" : "0"));
     }
     else if(type == SpinBox)
     {
-        data += dataCodec->fromUnicode(QString::number(ui->spinBox->value()));
+        sendTemplate.appendRaw(dataCodec->fromUnicode(QString::number(ui->spinBox->value())));
     }
 
 
     if(ui->suffixBox->isChecked())
-    {
-        if(ui->suffixTypeBox->currentIndex() == 0)
-        {
-            if(ui->unescapeBox->isChecked())
-                data += Util::unescape(ui->suffixEdit->text(), dataCodec);
-            else
-                data += dataCodec->fromUnicode(ui->suffixEdit->text());
-        }
-        else if(ui->suffixTypeBox->currentIndex() == 1)
-            data += QByteArray::fromHex(ui->suffixEdit->text().toLatin1());
-        else if(ui->suffixTypeBox->currentIndex() == 2)
-            data += "\r\n";
-        else if(ui->suffixTypeBox->currentIndex() == 3)
-            data += "\n";
-    }
-    emit send(data);
+        sendTemplate.appendAffix(ui->suffixTypeBox->currentIndex(), ui->suffixEdit->text(), toText);
+
+    m_frameError = sendTemplate.isValid() ? QString() : sendTemplate.errorString();
+    m_frame = sendTemplate.isValid() ? sendTemplate.frame() : TxFrame();
+    m_isFrameValid = true;
+    *errorString = m_frameError;
+    return sendTemplate.isValid();
+}
+
+bool ControlItem::responderRule(AutoResponder::Rule* rule)
+{
+    if(type != Responder || !ui->autoBox->isChecked() || dataCodec == nullptr)
+        return false;
+    const QString match = ui->matchEdit->text();
+    if(ui->matchHexBox->isChecked())
+        rule->pattern = QByteArray::fromHex(match.toLatin1());
+    else
+        rule->pattern = ui->unescapeBox->isChecked() ? Util::unescape(match, dataCodec) : dataCodec->fromUnicode(match);
+    rule->delay = ui->delayEdit->text().toInt();
+    QString errorString;
+    if(rule->pattern.isEmpty() || !compileFrame(&errorString))
+        return false;
+    rule->reply = m_frame;
+    return true;
 }
 
 
@@ -261,7 +302,12 @@ void ControlItem::on_sliderEdit_editingFinished()
 
 void ControlItem::on_hexBox_stateChanged(int arg1)
 {
-    ui->CMDEdit->setPlaceholderText(tr("Command") + ((arg1 == Qt::Checked) ? "(Hex)" : ""));
+    ui->CMDEdit->setPlaceholderText((type == Responder ? tr("Reply") : tr("Command")) + ((arg1 == Qt::Checked) ? "(Hex)" : ""));
+}
+
+void ControlItem::on_matchHexBox_stateChanged(int arg1)
+{
+    ui->matchEdit->setPlaceholderText(tr("When received") + ((arg1 == Qt::Checked) ? "(Hex)" : ""));
 }
 
 bool ControlItem::load(const QJsonObject& dict)
@@ -276,10 +322,13 @@ bool ControlItem::load(const QJsonObject& dict)
     ui->suffixEdit->setText(dict["suffix"].toString());
     ui->hexBox->setChecked(dict["hex"].toBool());
     ui->unescapeBox->setChecked(dict["unescape"].toBool());
+    ui->templateBox->setChecked(dict["template"].toBool());
     ui->autoBox->setChecked(dict["auto"].toBool());
     ui->minEdit->setText(dict["min"].toString());
     ui->maxEdit->setText(dict["max"].toString());
     ui->stepEdit->setText(dict["step"].toString());
+    ui->matchHexBox->setChecked(dict["matchHex"].toBool());
+    ui->delayEdit->setText(dict["delay"].toString("0"));
 
     ui->slider->blockSignals(true);
     ui->checkBox->blockSignals(true);
@@ -291,9 +340,10 @@ bool ControlItem::load(const QJsonObject& dict)
     on_minEdit_editingFinished();
     on_maxEdit_editingFinished();
 
-    if(type == Command)
+    if(type == Command || type == Responder)
     {
         ui->CMDEdit->setText(dict["content"].toString());
+        ui->matchEdit->setText(dict["match"].toString());
     }
     else if(type == Slider)
     {
@@ -311,6 +361,8 @@ bool ControlItem::load(const QJsonObject& dict)
     ui->slider->blockSignals(false);
     ui->checkBox->blockSignals(false);
     ui->spinBox->blockSignals(false);
+    // the value is set with the signals blocked
+    m_isFrameValid = false;
 
     initUI();
     return true;
@@ -330,12 +382,18 @@ QJsonObject ControlItem::save()
     data["suffix"] = ui->suffixEdit->text();
     data["hex"] = ui->hexBox->isChecked();
     data["unescape"] = ui->unescapeBox->isChecked();
+    data["template"] = ui->templateBox->isChecked();
     data["auto"] = ui->autoBox->isChecked();
     data["min"] = ui->minEdit->text();
     data["max"] = ui->maxEdit->text();
     data["step"] = ui->stepEdit->text();
-    if(type == Command)
+    data["matchHex"] = ui->matchHexBox->isChecked();
+    data["delay"] = ui->delayEdit->text();
+    if(type == Command || type == Responder)
+    {
         data["content"] = ui->CMDEdit->text();
+        data["match"] = ui->matchEdit->text();
+    }
     else if(type == Slider)
         data["content"] = ui->slider->value();
     else if(type == CheckBox)
@@ -349,6 +407,7 @@ QJsonObject ControlItem::save()
 void ControlItem::setDataCodec(QTextCodec *codec)
 {
     this->dataCodec = codec;
+    m_isFrameValid = false;
 }
 
 void ControlItem::on_slider_actionTriggered(int action)
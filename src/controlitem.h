@@ -4,6 +4,9 @@
 #include <QWidget>
 #include <QJsonObject>
 
+#include "autoresponder.h"
+#include "txframe.h"
+
 namespace Ui
 {
 class ControlItem;
@@ -20,6 +23,7 @@ public:
         Slider,
         CheckBox,
         SpinBox,
+        Responder,
     };
 
     explicit ControlItem(Type type = Command, QWidget *parent = nullptr);
@@ -27,6 +31,8 @@ public:
 
     bool load(const QJsonObject& dict);
     QJsonObject save();
+    // false if it's not an enabled Responder or the reply is invalid
+    bool responderRule(AutoResponder::Rule* rule);
 public slots:
     void setDataCodec(QTextCodec* codec);
 private slots:
@@ -62,6 +68,8 @@ private slots:
 
     void on_hexBox_stateChanged(int arg1);
 
+    void on_matchHexBox_stateChanged(int arg1);
+
     void on_slider_actionTriggered(int action);
 
     void onSliderReleased();
@@ -70,11 +78,18 @@ private:
     Type type;
 
     void initUI();
-    QTextCodec* dataCodec;
+    // compiles m_frame if any option or the value is changed
+    bool compileFrame(QString* errorString);
+    QTextCodec* dataCodec = nullptr;
+    TxFrame m_frame;
+    QString m_frameError;
+    bool m_isFrameValid = false;
     bool m_sliderPageChanged = false;
     qint64 m_lastSliderReleasedTimestamp = 0;
+    quint64 m_sendSequence = 0;
 signals:
     void send(const QByteArray& data);
+    void responderChanged();
 
 };
 
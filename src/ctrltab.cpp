@@ -26,6 +26,9 @@ CtrlTab::CtrlTab(QWidget *parent) :
     connect(ui->ctrl_addSliderButton, &QPushButton::clicked, this, &CtrlTab::addCtrlItem);
     connect(ui->ctrl_addCheckBoxButton, &QPushButton::clicked, this, &CtrlTab::addCtrlItem);
     connect(ui->ctrl_addSpinBoxButton, &QPushButton::clicked, this, &CtrlTab::addCtrlItem);
+    connect(ui->ctrl_addResponderButton, &QPushButton::clicked, this, &CtrlTab::addCtrlItem);
+
+    m_autoResponder = new AutoResponder(this);
 
     commentRegExp = new QRegularExpression("^#.+$", QRegularExpression::MultilineOption);
     commentRegExp->optimize();
@@ -42,6 +45,25 @@ void CtrlTab::setDataCodec(QTextCodec *codec)
 {
     dataCodec = codec;
     emit newDataCodec(dataCodec);
+    updateAutoResponder();
+}
+
+AutoResponder* CtrlTab::autoResponder()
+{
+    return m_autoResponder;
+}
+
+void CtrlTab::updateAutoResponder()
+{
+    QVector<AutoResponder::Rule> rules;
+    const QList<ControlItem*> list = ui->ctrl_itemContents->findChildren<ControlItem*>(QString(), Qt::FindDirectChildrenOnly);
+    for(ControlItem* item : list)
+    {
+        AutoResponder::Rule rule;
+        if(item->responderRule(&rule))
+            rules.append(rule);
+    }
+    m_autoResponder->setRules(rules);
 }
 
 // remember to change on_ctrl_importButton_clicked() if related code is changed
@@ -57,10 +79,13 @@ void CtrlTab::addCtrlItem()
         type = ControlItem::CheckBox;
     else if(buttonName.contains("SpinBox"))
         type = ControlItem::SpinBox;
+    else if(buttonName.contains("Responder"))
+        type = ControlItem::Responder;
     QBoxLayout* p = static_cast<QBoxLayout*>(ui->ctrl_itemContents->layout());
     ControlItem* c = new ControlItem(type);
     connect(c, &ControlItem::send, this, &CtrlTab::send);
     connect(c, &ControlItem::destroyed, this, &CtrlTab::onCtrlItemDestroyed);
+    connect(c, &ControlItem::responderChanged, this, &CtrlTab::updateAutoResponder);
     connect(this, &CtrlTab::newDataCodec, c, &ControlItem::setDataCodec);
     c->setDataCodec(dataCodec);
     p->insertWidget(ctrlItemCount++, c);
@@ -69,6 +94,8 @@ void CtrlTab::addCtrlItem()
 void CtrlTab::onCtrlItemDestroyed()
 {
     ctrlItemCount--;
+    // queued, the item is still being destroyed, and so is this when the tab is closed
+    QMetaObject::invokeMethod(this, "updateAutoResponder", Qt::QueuedConnection);
 }
 
 
@@ -99,6 +126,7 @@ void CtrlTab::on_ctrl_importButton_clicked()
         ui->ctrl_addSliderButton->setEnabled(false);
         ui->ctrl_addCheckBoxButton->setEnabled(false);
         ui->ctrl_addSpinBoxButton->setEnabled(false);
+        ui->ctrl_addResponderButton->setEnabled(false);
     }
     else
     {
@@ -113,6 +141,7 @@ void CtrlTab::on_ctrl_importButton_clicked()
         ui->ctrl_addSliderButton->setEnabled(true);
         ui->ctrl_addCheckBoxButton->setEnabled(true);
         ui->ctrl_addSpinBoxButton->setEnabled(true);
+        ui->ctrl_addResponderButton->setEnabled(true);
     }
 #else
     bool flag = true;
@@ -139,12 +168,14 @@ void CtrlTab::loadCtrlPanel(const QString& data)
         ControlItem* c = new ControlItem();
         connect(c, &ControlItem::send, this, &CtrlTab::send);
         connect(c, &ControlItem::destroyed, this, &CtrlTab::onCtrlItemDestroyed);
+        connect(c, &ControlItem::responderChanged, this, &CtrlTab::updateAutoResponder);
         connect(this, &CtrlTab::newDataCodec, c, &ControlItem::setDataCodec);
         c->setDataCodec(dataCodec);
         p->insertWidget(ctrlItemCount++, c);
         if(!c->load(it->toObject()))
             c->deleteLater();
     }
+    updateAutoResponder();
 }
 
 void CtrlTab::on_ctrl_exportButton_clicked()
@@ -178,6 +209,7 @@ void CtrlTab::on_ctrl_exportButton_clicked()
         ui->ctrl_addSliderButton->setEnabled(false);
         ui->ctrl_addCheckBoxButton->setEnabled(false);
         ui->ctrl_addSpinBoxButton->setEnabled(false);
+        ui->ctrl_addResponderButton->setEnabled(false);
     }
     else
     {
@@ -191,6 +223,7 @@ void CtrlTab::on_ctrl_exportButton_clicked()
         ui->ctrl_addSliderButton->setEnabled(true);
         ui->ctrl_addCheckBoxButton->setEnabled(true);
         ui->ctrl_addSpinBoxButton->setEnabled(true);
+        ui->ctrl_addResponderButton->setEnabled(true);
     }
 #else
     if(ctrlItemCount == 0)
@@ -5,6 +5,8 @@
 #include <QTextCodec>
 #include <QRegularExpression>
 
+#include "autoresponder.h"
+
 namespace Ui
 {
 class CtrlTab;
@@ -18,6 +20,8 @@ public:
     explicit CtrlTab(QWidget *parent = nullptr);
     ~CtrlTab();
 
+    AutoResponder* autoResponder();
+
 public slots:
     void setDataCodec(QTextCodec *codec);
     void setTouchScroll(bool enabled);
@@ -30,12 +34,14 @@ private slots:
     void on_ctrl_importButton_clicked();
     void on_ctrl_exportButton_clicked();
     void addCtrlItem();
+    void updateAutoResponder();
 private:
     Ui::CtrlTab *ui;
 
     int ctrlItemCount = 0;
     QTextCodec* dataCodec = nullptr;
     QRegularExpression* commentRegExp = nullptr;
+    AutoResponder* m_autoResponder;
     void loadCtrlPanel(const QString& data);
 signals:
     void send(const QByteArray& data);
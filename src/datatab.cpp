@@ -1,22 +1,29 @@
 ﻿#include "datatab.h"
-#include "util.h"
+#include "hexformatter.h"
+#include "rxexporter.h"
+#include "txtemplate.h"
 #include "ui_datatab.h"
 
-#include <QTimer>
 #include <QTextCodec>
 #include <QMessageBox>
 #include <QClipboard>
 #include <QFileDialog>
+#include <QProgressDialog>
+#include <QDoubleValidator>
 #include <QSerialPort>
 #include <QDateTime>
+#include <QLocale>
 #include <QDebug>
+#include <QRegularExpression>
+#include <algorithm>
 
-DataTab::DataTab(QByteArray* RxBuf, QVector<Metadata>* RxMetadataBuf, QByteArray* TxBuf, QWidget *parent) :
+DataTab::DataTab(QByteArray* RxBuf, QVector<Metadata>* RxMetadataBuf, QByteArray* TxBuf, Timeline* timeline, QWidget *parent) :
     QWidget(parent),
     ui(new Ui::DataTab),
     rawReceivedData(RxBuf),
     RxMetadata(RxMetadataBuf),
-    rawSendedData(TxBuf)
+    rawSendedData(TxBuf),
+    m_timeline(timeline)
 {
     ui->setupUi(this);
 #ifdef Q_OS_ANDROID
@@ -32,22 +39,87 @@ DataTab::DataTab(QByteArray* RxBuf, QVector<Metadata>* RxMetadataBuf, QByteArray
     env->DeleteLocalRef(javaClass);
 
 #endif
-    repeatTimer = new QTimer();
-    RxSlider = ui->receivedEdit->verticalScrollBar();
+    m_RxModel = new RxDataModel(rawReceivedData, RxMetadata, this);
+    ui->receivedView->setModel(m_RxModel);
+    connect(ui->receivedView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &DataTab::onReceivedSelectionChanged);
+    connect(ui->receivedView->selectionModel(), &QItemSelectionModel::currentChanged, this, &DataTab::onReceivedCurrentChanged);
+    // the rows might be added by the background rebuilding
+    connect(m_RxModel, &QAbstractItemModel::rowsInserted, this, &DataTab::onReceivedRowsChanged);
+    connect(m_RxModel, &QAbstractItemModel::modelReset, this, &DataTab::onReceivedRowsChanged);
+    connect(m_RxModel, &RxDataModel::matchesChanged, this, &DataTab::onSearchMatchesChanged);
+    // the data font is set for QPlainTextEdit, follow sendedEdit
+    ui->receivedView->setFont(ui->sendedEdit->font());
+    ui->sendedEdit->installEventFilter(this);
+    m_frameModel = new CANFrameModel(rawReceivedData, RxMetadata, this);
+    ui->receivedFrameView->setModel(m_frameModel);
+    // fixed row height, so the view doesn't need to measure every row
+    ui->receivedFrameView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->receivedFrameView->verticalHeader()->setDefaultSectionSize(ui->receivedFrameView->fontMetrics().height() + 4);
+    ui->receivedFrameView->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    ui->receivedFrameView->horizontalHeader()->setStretchLastSection(true);
+    ui->receivedFrameView->hide();
+    ui->receivedTerminal->hide();
+    connect(ui->receivedTerminal, &TerminalWidget::send, this, &DataTab::terminalInput);
+    m_timelineModel = new TimelineModel(m_timeline, rawReceivedData, rawSendedData, this);
+    ui->receivedConversationView->setModel(m_timelineModel);
+    ui->receivedConversationView->setFont(ui->sendedEdit->font());
+    ui->receivedConversationView->hide();
+    connect(ui->receivedConversationView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &DataTab::onReceivedSelectionChanged);
     ui->dataTabSplitter->handle(1)->installEventFilter(this); // the id of the 1st visible handle is 1 rather than 0
 
     connect(ui->sendEdit, &QLineEdit::returnPressed, this, &DataTab::on_sendButton_clicked);
-    connect(repeatTimer, &QTimer::timeout, this, &DataTab::on_sendButton_clicked);
+    connect(ui->data_suffixBox, &QGroupBox::toggled, this, &DataTab::onSendFrameChanged);
+    connect(ui->data_suffixTypeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &DataTab::onSendFrameChanged);
+    connect(ui->data_suffixEdit, &QLineEdit::textChanged, this, &DataTab::onSendFrameChanged);
+    connect(ui->data_templateBox, &QCheckBox::stateChanged, this, &DataTab::onSendFrameChanged);
+    // in ms, a period of 0 would spin the scheduler
+    QDoubleValidator* repeatDelayValidator = new QDoubleValidator(this);
+    repeatDelayValidator->setBottom(m_minRepeatPeriod / 1000.0);
+    repeatDelayValidator->setNotation(QDoubleValidator::StandardNotation);
+    repeatDelayValidator->setLocale(QLocale::c());
+    ui->repeatDelayEdit->setValidator(repeatDelayValidator);
+
+    m_exporterThread = new QThread(this);
+    m_exporter = new RxExporter();
+    m_exporter->moveToThread(m_exporterThread);
+    connect(m_exporter, &RxExporter::written, this, &DataTab::onExportChunkWritten);
+    connect(m_exporter, &RxExporter::finished, this, &DataTab::onExportFinished);
+    connect(m_exporterThread, &QThread::finished, m_exporter, &QObject::deleteLater);
+    m_exporterThread->start();
 }
 
 DataTab::~DataTab()
 {
+    if(m_exportDialog != nullptr)
+    {
+        m_exporter->restart();
+        QMetaObject::invokeMethod(m_exporter, "abort", Qt::BlockingQueuedConnection);
+    }
+    m_exporterThread->quit();
+    m_exporterThread->wait();
     delete ui;
 }
 
 void DataTab::onConnTypeChanged(Connection::Type type)
 {
-    ui->data_flowControlBox->setVisible(type == Connection::SerialPort);
+    ui->data_flowControlBox->setVisible(type == Connection::SerialPort || type == Connection::RFC2217_Client || type == Connection::RFC2217_Server);
+    // one row for every CAN frame
+    if(type == Connection::SocketCAN)
+    {
+        ui->receivedTerminalBox->setChecked(false);
+        ui->receivedConversationBox->setChecked(false);
+    }
+    ui->receivedTerminalBox->setVisible(type != Connection::SocketCAN);
+    ui->receivedTerminalLabel->setVisible(type != Connection::SocketCAN);
+    ui->receivedConversationBox->setVisible(type != Connection::SocketCAN);
+    ui->receivedConversationLabel->setVisible(type != Connection::SocketCAN);
+    ui->receivedFrameView->setVisible(type == Connection::SocketCAN);
+    ui->receivedView->setVisible(type != Connection::SocketCAN && !ui->receivedTerminalBox->isChecked() && !ui->receivedConversationBox->isChecked());
+    // the matches and the positions are shown in receivedView
+    const QList<QWidget*> searchWidgets = {ui->receivedSearchTypeBox, ui->receivedSearchEdit, ui->receivedSearchLabel, ui->receivedSearchPrevButton, ui->receivedSearchNextButton, ui->receivedPosLabel, ui->receivedGotoTypeBox, ui->receivedGotoEdit};
+    for(QWidget* widget : searchWidgets)
+        widget->setVisible(type != Connection::SocketCAN);
+    m_frameModel->sync();
 }
 
 void DataTab::initSettings()
@@ -58,10 +130,13 @@ void DataTab::initSettings()
     connect(ui->receivedHexBox, &QCheckBox::clicked, this, &DataTab::saveDataPreference);
     connect(ui->receivedLatestBox, &QCheckBox::clicked, this, &DataTab::saveDataPreference);
     connect(ui->receivedTimestampBox, &QCheckBox::clicked, this, &DataTab::saveDataPreference);
+    connect(ui->receivedTerminalBox, &QCheckBox::clicked, this, &DataTab::saveDataPreference);
+    connect(ui->receivedConversationBox, &QCheckBox::clicked, this, &DataTab::saveDataPreference);
     connect(ui->receivedRealtimeBox, &QCheckBox::clicked, this, &DataTab::saveDataPreference);
     connect(ui->sendedHexBox, &QCheckBox::clicked, this, &DataTab::saveDataPreference);
     connect(ui->sendedEnableBox, &QCheckBox::clicked, this, &DataTab::saveDataPreference);
     connect(ui->data_unescapeBox, &QCheckBox::clicked, this, &DataTab::saveDataPreference);
+    connect(ui->data_templateBox, &QCheckBox::clicked, this, &DataTab::saveDataPreference);
     connect(ui->data_suffixBox, &QGroupBox::clicked, this, &DataTab::saveDataPreference);
     connect(ui->data_suffixTypeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &DataTab::saveDataPreference);
     connect(ui->data_suffixEdit, &QLineEdit::editingFinished, this, &DataTab::saveDataPreference);
@@ -74,7 +149,15 @@ void DataTab::initSettings()
 
 bool DataTab::eventFilter(QObject *watched, QEvent *event)
 {
-    if(watched == ui->dataTabSplitter->handle(1))
+    if(watched == ui->sendedEdit)
+    {
+        if(event->type() == QEvent::FontChange)
+        {
+            ui->receivedView->setFont(ui->sendedEdit->font());
+            ui->receivedConversationView->setFont(ui->sendedEdit->font());
+        }
+    }
+    else if(watched == ui->dataTabSplitter->handle(1))
     {
         // double click the handle to reset the size
         if(event->type() == QEvent::MouseButtonDblClick)
@@ -123,13 +206,14 @@ void DataTab::on_data_encodingSetButton_clicked()
     newCodec = QTextCodec::codecForName(box->currentText().toLatin1());
     if(newCodec != nullptr)
     {
-        if(RxDecoder != nullptr)
-            delete RxDecoder;
         dataCodec = newCodec;
         box->setCurrentText(dataCodec->name());
         emit setDataCodec(dataCodec);
-        RxDecoder = dataCodec->makeDecoder(); // clear state machine
-        emit setPlotDecoder(dataCodec->makeDecoder());// clear state machine, standalone decoder for DataTab/PlotTab
+        m_RxModel->setCodec(dataCodec);
+        m_timelineModel->setCodec(dataCodec);
+        ui->receivedTerminal->setCodec(dataCodec);
+        onSendFrameChanged();
+        emit setPlotDecoder(new StreamDecoder(dataCodec));// clear state machine
         settings->beginGroup("SerialTest_Data");
         settings->setValue("Encoding_Name", ui->data_encodingNameBox->currentText());
         settings->endGroup();
@@ -155,10 +239,13 @@ void DataTab::saveDataPreference()
     settings->setValue("Recv_Hex", ui->receivedHexBox->isChecked());
     settings->setValue("Recv_Latest", ui->receivedLatestBox->isChecked());
     settings->setValue("Recv_Timestamp", ui->receivedTimestampBox->isChecked());
+    settings->setValue("Recv_Terminal", ui->receivedTerminalBox->isChecked());
+    settings->setValue("Recv_Conversation", ui->receivedConversationBox->isChecked());
     settings->setValue("Recv_Realtime", ui->receivedRealtimeBox->isChecked());
     settings->setValue("Send_Hex", ui->sendedHexBox->isChecked());
     settings->setValue("Send_Enabled", ui->sendedEnableBox->isChecked());
     settings->setValue("Send_Unescape", ui->data_unescapeBox->isChecked());
+    settings->setValue("Send_Template", ui->data_templateBox->isChecked());
     settings->setValue("Suffix_Enabled", ui->data_suffixBox->isChecked());
     settings->setValue("Suffix_Type", ui->data_suffixTypeBox->currentIndex());
     settings->setValue("Suffix_Context", ui->data_suffixEdit->text());
@@ -183,10 +270,13 @@ void DataTab::loadPreference()
     ui->receivedHexBox->setChecked(settings->value("Recv_Hex", false).toBool());
     ui->receivedLatestBox->setChecked(settings->value("Recv_Latest", true).toBool());
     ui->receivedTimestampBox->setChecked(settings->value("Recv_Timestamp", false).toBool());
+    ui->receivedTerminalBox->setChecked(settings->value("Recv_Terminal", false).toBool());
+    ui->receivedConversationBox->setChecked(settings->value("Recv_Conversation", false).toBool());
     ui->receivedRealtimeBox->setChecked(settings->value("Recv_Realtime", true).toBool());
     ui->sendedHexBox->setChecked(settings->value("Send_Hex", false).toBool());
     ui->sendedEnableBox->setChecked(settings->value("Send_Enabled", true).toBool());
     ui->data_unescapeBox->setChecked(settings->value("Send_Unescape", false).toBool());
+    ui->data_templateBox->setChecked(settings->value("Send_Template", false).toBool());
     ui->data_suffixBox->setChecked(settings->value("Suffix_Enabled", false).toBool());
     ui->data_suffixTypeBox->setCurrentIndex(settings->value("Suffix_Type", 2).toInt());
     ui->data_suffixEdit->setText(settings->value("Suffix_Context", "").toString());
@@ -209,12 +299,15 @@ void DataTab::on_data_suffixTypeBox_currentIndexChanged(int index)
 void DataTab::on_sendedHexBox_stateChanged(int arg1)
 {
     isSendedDataHex = (arg1 == Qt::Checked);
+    onSendFrameChanged();
     syncSendedEditWithData();
 }
 
 void DataTab::on_receivedHexBox_stateChanged(int arg1)
 {
     isReceivedDataHex = (arg1 == Qt::Checked);
+    m_RxModel->setHexEnabled(isReceivedDataHex);
+    m_timelineModel->setHexEnabled(isReceivedDataHex);
     syncReceivedEditWithData();
 }
 
@@ -222,9 +315,71 @@ void DataTab::on_receivedHexBox_stateChanged(int arg1)
 void DataTab::on_receivedTimestampBox_stateChanged(int arg1)
 {
     RxTimestampEnabled = (arg1 == Qt::Checked);
+    m_RxModel->setTimestampEnabled(RxTimestampEnabled);
     syncReceivedEditWithData();
 }
 
+void DataTab::on_receivedTerminalBox_stateChanged(int arg1)
+{
+    // the terminal shows the data received after it's enabled
+    ui->receivedTerminal->clear();
+    ui->receivedTerminal->setVisible(arg1 == Qt::Checked);
+    if(arg1 == Qt::Checked)
+    {
+        // only one of them is shown
+        ui->receivedConversationBox->setChecked(false);
+        ui->receivedTerminal->setFocus();
+    }
+    ui->receivedView->setVisible(!ui->receivedTerminalBox->isChecked() && !ui->receivedConversationBox->isChecked());
+}
+
+void DataTab::on_receivedConversationBox_stateChanged(int arg1)
+{
+    ui->receivedConversationView->setVisible(arg1 == Qt::Checked);
+    // the conversation can only be exported when it's shown, a running export keeps its snapshot
+    m_timeline->setEnabled(arg1 == Qt::Checked);
+    if(arg1 == Qt::Checked)
+    {
+        ui->receivedTerminalBox->setChecked(false);
+        syncConversationWithData();
+    }
+    ui->receivedView->setVisible(!ui->receivedTerminalBox->isChecked() && !ui->receivedConversationBox->isChecked());
+    // the selection of the other view
+    onReceivedSelectionChanged();
+}
+
+void DataTab::syncConversationWithData()
+{
+    // synced when it's shown
+    if(!ui->receivedConversationBox->isChecked())
+        return;
+    m_timelineModel->sync();
+    if(ui->receivedLatestBox->isChecked())
+        ui->receivedConversationView->scrollToBottom();
+}
+
+QListView* DataTab::receivedListView() const
+{
+    return ui->receivedConversationBox->isChecked() ? ui->receivedConversationView : ui->receivedView;
+}
+
+void DataTab::feedTerminal(const QByteArray& data)
+{
+    if(ui->receivedTerminalBox->isChecked())
+        ui->receivedTerminal->feed(data);
+}
+
+void DataTab::on_receivedLatestBox_stateChanged(int arg1)
+{
+    m_RxModel->setLatestFirst(arg1 == Qt::Checked);
+}
+
+void DataTab::onReceivedRowsChanged()
+{
+    if(ui->receivedLatestBox->isChecked())
+        ui->receivedView->scrollToBottom();
+}
+
 void DataTab::on_receivedClearButton_clicked()
 {
     clearRxData();
@@ -233,9 +388,9 @@ void DataTab::on_receivedClearButton_clicked()
 
 void DataTab::clearRxData()
 {
-    lastReceivedByte = '\0'; // anything but '\r'
     emit clearReceivedData();
     syncReceivedEditWithData();
+    ui->receivedTerminal->clear();
 }
 
 void DataTab::on_sendedClearButton_clicked()
@@ -247,26 +402,48 @@ void DataTab::on_sendedClearButton_clicked()
 void DataTab::on_sendEdit_textChanged(const QString &arg1)
 {
     Q_UNUSED(arg1);
-    repeatTimer->stop();
+    m_isSendFrameValid = false;
     ui->data_repeatCheckBox->setChecked(false);
 }
 
 void DataTab::on_data_repeatCheckBox_stateChanged(int arg1)
 {
-    if(arg1 == Qt::Checked)
-    {
-        repeatTimer->setInterval(ui->repeatDelayEdit->text().toInt());
-        repeatTimer->start();
-    }
+    // sent by TxScheduler in its thread, not limited by QTimer
+    if(arg1 != Qt::Checked)
+        emit stopRepeat();
+    else if(checkSendFrame())
+        emit startRepeat(sendFrame(), repeatPeriod());
     else
-        repeatTimer->stop();
+        ui->data_repeatCheckBox->setChecked(false);
+}
+
+void DataTab::onSendFrameChanged()
+{
+    m_isSendFrameValid = false;
+    if(!ui->data_repeatCheckBox->isChecked())
+        return;
+    // the repeated frame follows the input, the template might be incomplete while typing
+    if(sendFrame().isEmpty())
+        ui->data_repeatCheckBox->setChecked(false);
+    else
+        emit startRepeat(sendFrame(), repeatPeriod());
+}
+
+// in us, the delay in ms can be a decimal like 0.25
+qint64 DataTab::repeatPeriod() const
+{
+    // the text might be empty or not finished
+    const qint64 period = qRound64(ui->repeatDelayEdit->text().toDouble() * 1000);
+    return (period < m_minRepeatPeriod) ? (qint64)m_minRepeatPeriod : period;
 }
 
 void DataTab::on_receivedCopyButton_clicked()
 {
-    QString selection = ui->receivedEdit->textCursor().selectedText();
-    if(selection.isEmpty())
-        QApplication::clipboard()->setText(ui->receivedEdit->toPlainText());
+    QString selection = selectedReceivedText();
+    if(selection.isEmpty() && ui->receivedConversationBox->isChecked())
+        QApplication::clipboard()->setText(m_timelineModel->rowsText(0, m_timelineModel->rowCount() - 1));
+    else if(selection.isEmpty())
+        QApplication::clipboard()->setText(m_RxModel->rowsText(0, m_RxModel->rowCount() - 1));
     else
         QApplication::clipboard()->setText(selection);
 }
@@ -284,23 +461,212 @@ void DataTab::on_receivedExportButton_clicked()
 {
     bool flag = true;
     QString fileName, selection;
+    // a time range might be too large for the text
+    const bool isTimeRange = (m_timeRangeBegin >= 0);
+    const bool isConversation = ui->receivedConversationBox->isChecked();
+    if(!isTimeRange || isConversation)
+        selection = selectedReceivedText();
+    if(selection.isEmpty() && isConversation)
+    {
+        // the order matches RxExporter::Format from ConversationText
+        const QStringList filters = {tr("Conversation") + " (*.txt)", tr("Conversation in hex") + " (*.txt)", "CSV (*.csv)", tr("JSON lines") + " (*.jsonl)"};
+        QString selectedFilter;
+        fileName = QFileDialog::getSaveFileName(this, tr("Export conversation"), "conv_" + QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss") + ".txt", filters.join(";;"), &selectedFilter);
+        if(fileName.isEmpty())
+            return;
+        startExport(fileName, RxExporter::ConversationText + qMax(filters.indexOf(selectedFilter), 0), 0, m_timeline->size());
+        return;
+    }
+    else if(selection.isEmpty())
+    {
+        // the whole data or the time range is exported in the background, the order matches RxExporter::Format
+        const QStringList filters = {tr("Raw data") + " (*.txt *.bin)", tr("Hex dump") + " (*.txt)", "CSV (*.csv)", tr("JSON lines") + " (*.jsonl)"};
+        QString selectedFilter;
+        fileName = QFileDialog::getSaveFileName(this, tr("Export received data"), "recv_" + QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss") + ".txt", filters.join(";;"), &selectedFilter);
+        if(fileName.isEmpty())
+            return;
+        const int format = qMax(filters.indexOf(selectedFilter), 0);
+        if(isTimeRange)
+            startExport(fileName, format, m_timeRangeBegin, m_timeRangeEnd);
+        else
+            startExport(fileName, format, 0, rawReceivedData->size());
+        return;
+    }
     fileName = QFileDialog::getSaveFileName(this, tr("Export received data"), "recv_" + QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss") + ".txt");
     if(fileName.isEmpty())
         return;
     QFile file(fileName);
-    selection = ui->receivedEdit->textCursor().selectedText();
-    if(selection.isEmpty())
+    flag &= file.open(QFile::WriteOnly | QFile::Text);
+    flag &= file.write(dataCodec->fromUnicode(selection)) != -1;
+    file.close();
+    QMessageBox::information(this, tr("Info"), flag ? tr("Successed!") : tr("Failed!"));
+}
+
+// begin should be the start of a Metadata, or an entry id for the conversation formats
+void DataTab::startExport(const QString& fileName, int format, qint64 begin, qint64 end)
+{
+    m_exportGeneration = m_exporter->restart();
+    m_exportFormat = format;
+    m_exportPendingChunkNum = 0;
+    m_exportBegin = begin;
+    m_exportEnd = end;
+    m_isTimelineExport = (format >= RxExporter::ConversationText);
+    if(m_isTimelineExport)
     {
-        flag &= file.open(QFile::WriteOnly);
-        flag &= file.write(*rawReceivedData) != -1;
+        // the entries might be inserted or merged during exporting, so a snapshot is exported
+        m_exportEntries = m_timeline->entries();
+        m_exportTimelineGeneration = m_timeline->generation();
+        m_exportItemEnd = end;
+        m_exportFedItem = begin;
     }
     else
     {
-        flag &= file.open(QFile::WriteOnly | QFile::Text);
-        flag &= file.write(dataCodec->fromUnicode(selection.replace(QChar(0x2029), '\n'))) != -1;
+        m_exportItemEnd = (end > begin) ? Metadata::indexAt(*RxMetadata, end - 1) + 1 : 0;
+        m_exportFedItem = qMax(Metadata::indexAt(*RxMetadata, begin), 0);
     }
-    file.close();
-    QMessageBox::information(this, tr("Info"), flag ? tr("Successed!") : tr("Failed!"));
+    m_exportFedPos = begin;
+    m_exportFedEntryOffset = 0;
+    QMetaObject::invokeMethod(m_exporter, "start", Qt::QueuedConnection, Q_ARG(QString, fileName), Q_ARG(int, format), Q_ARG(QByteArray, dataCodec->name()), Q_ARG(int, m_exportGeneration));
+
+    // not modal, the data is still received and shown
+    m_exportDialog = new QProgressDialog(tr("Exporting received data..."), tr("Cancel"), 0, 100, this);
+    m_exportDialog->setAutoClose(false);
+    m_exportDialog->setAutoReset(false);
+    connect(m_exportDialog, &QProgressDialog::canceled, this, &DataTab::onExportCanceled);
+    m_exportDialog->show();
+    ui->receivedExportButton->setEnabled(false);
+    feedExporter();
+}
+
+void DataTab::feedExporter()
+{
+    if(m_isTimelineExport)
+    {
+        feedTimelineExporter();
+        return;
+    }
+    if(rawReceivedData->size() < m_exportEnd || RxMetadata->size() < m_exportItemEnd)
+    {
+        stopExport();
+        QMetaObject::invokeMethod(m_exporter, "abort", Qt::QueuedConnection);
+        QMessageBox::warning(this, tr("Error"), tr("Failed to export:") + "\n" + tr("The received data is cleared."));
+        return;
+    }
+    // CSV and JSON lines have one record per Metadata, so only whole Metadata are sent
+    const bool isItemBased = (m_exportFormat == RxExporter::CSV || m_exportFormat == RxExporter::JSONLines);
+    while(m_exportPendingChunkNum < m_maxPendingExportChunkNum)
+    {
+        QVector<Metadata> items;
+        qint64 begin = m_exportFedPos, end;
+        if(isItemBased)
+        {
+            if(m_exportFedItem >= m_exportItemEnd)
+                break;
+            // m_exportFedPos is in the middle of an item if it's longer than a chunk
+            begin = end = qMax(m_exportFedPos, (*RxMetadata)[m_exportFedItem].pos);
+            while(m_exportFedItem < m_exportItemEnd && end - begin < m_exportChunkSize)
+            {
+                Metadata item = (*RxMetadata)[m_exportFedItem];
+                // the last one might be merged with the data received after starting
+                const qint64 itemEnd = qMin(item.pos + item.len, m_exportEnd);
+                // a long item is split into several records, so the chunks are bounded
+                item.pos = qMax(item.pos, end);
+                item.len = qMin(itemEnd, begin + m_exportChunkSize) - item.pos;
+                end = item.pos + item.len;
+                items.append(item);
+                if(end >= itemEnd)
+                    m_exportFedItem++;
+            }
+        }
+        else
+        {
+            if(m_exportFedPos >= m_exportEnd)
+                break;
+            end = qMin(begin + m_exportChunkSize, m_exportEnd);
+        }
+        QMetaObject::invokeMethod(m_exporter, "addChunk", Qt::QueuedConnection, Q_ARG(QByteArray, rawReceivedData->mid(begin, end - begin)), Q_ARG(qint64, begin), Q_ARG(QVector<Metadata>, items), Q_ARG(int, m_exportGeneration));
+        m_exportFedPos = end;
+        m_exportPendingChunkNum++;
+    }
+    if(m_exportPendingChunkNum == 0)
+        QMetaObject::invokeMethod(m_exporter, "finish", Qt::QueuedConnection, Q_ARG(int, m_exportGeneration));
+}
+
+void DataTab::feedTimelineExporter()
+{
+    if(m_timeline->generation() != m_exportTimelineGeneration)
+    {
+        stopExport();
+        QMetaObject::invokeMethod(m_exporter, "abort", Qt::QueuedConnection);
+        QMessageBox::warning(this, tr("Error"), tr("Failed to export:") + "\n" + tr("The data is cleared."));
+        return;
+    }
+    while(m_exportPendingChunkNum < m_maxPendingExportChunkNum && m_exportFedItem < m_exportItemEnd)
+    {
+        // the Rx and Tx data of the entries are copied into one chunk
+        QByteArray data;
+        QVector<Timeline::Entry> entries;
+        while(m_exportFedItem < m_exportItemEnd && data.size() < m_exportChunkSize)
+        {
+            Timeline::Entry entry = m_exportEntries[m_exportFedItem];
+            const QByteArray* buf = (entry.direction == Timeline::Rx) ? rawReceivedData : rawSendedData;
+            // a long entry is split into several records, so the chunks are bounded
+            const qint64 len = qMin(entry.len - m_exportFedEntryOffset, (qint64)m_exportChunkSize - data.size());
+            data.append(buf->constData() + entry.pos + m_exportFedEntryOffset, len);
+            m_exportFedEntryOffset += len;
+            if(m_exportFedEntryOffset >= entry.len)
+            {
+                m_exportFedItem++;
+                m_exportFedEntryOffset = 0;
+            }
+            entry.pos = data.size() - len;
+            entry.len = len;
+            entries.append(entry);
+        }
+        QMetaObject::invokeMethod(m_exporter, "addTimelineChunk", Qt::QueuedConnection, Q_ARG(QByteArray, data), Q_ARG(QVector<Timeline::Entry>, entries), Q_ARG(qint64, m_exportFedItem), Q_ARG(int, m_exportGeneration));
+        m_exportPendingChunkNum++;
+    }
+    if(m_exportPendingChunkNum == 0)
+        QMetaObject::invokeMethod(m_exporter, "finish", Qt::QueuedConnection, Q_ARG(int, m_exportGeneration));
+}
+
+void DataTab::stopExport()
+{
+    m_exportGeneration = m_exporter->restart();
+    m_exportEntries.clear();
+    // close() emits canceled()
+    m_exportDialog->deleteLater();
+    m_exportDialog = nullptr;
+    ui->receivedExportButton->setEnabled(true);
+}
+
+void DataTab::onExportChunkWritten(qint64 end, int generation)
+{
+    if(generation != m_exportGeneration || m_exportDialog == nullptr)
+        return;
+    m_exportPendingChunkNum--;
+    if(m_exportEnd > m_exportBegin)
+        m_exportDialog->setValue((end - m_exportBegin) * 100 / (m_exportEnd - m_exportBegin));
+    feedExporter();
+}
+
+void DataTab::onExportFinished(bool succeeded, const QString& errorString, int generation)
+{
+    if(generation != m_exportGeneration || m_exportDialog == nullptr)
+        return;
+    stopExport();
+    if(succeeded)
+        QMessageBox::information(this, tr("Info"), tr("Successed!"));
+    else
+        QMessageBox::warning(this, tr("Error"), tr("Failed to export:") + "\n" + errorString);
+}
+
+void DataTab::onExportCanceled()
+{
+    if(m_exportDialog == nullptr)
+        return;
+    stopExport();
+    QMetaObject::invokeMethod(m_exporter, "abort", Qt::QueuedConnection);
 }
 
 void DataTab::on_sendedExportButton_clicked()
@@ -333,82 +699,50 @@ void DataTab::on_receivedUpdateButton_clicked()
 
 void DataTab::on_sendButton_clicked()
 {
-    QByteArray data;
-    if(isSendedDataHex)
-        data = QByteArray::fromHex(ui->sendEdit->text().toLatin1());
-    else
-    {
-        if(unescapeSendedData)
-            data = Util::unescape(ui->sendEdit->text(), dataCodec);
-        else
-            data = dataCodec->fromUnicode(ui->sendEdit->text());
-    }
+    if(!checkSendFrame())
+        return;
+    emit send(sendFrame().data(m_sendSequence++, QDateTime::currentMSecsSinceEpoch()));
+}
+
+TxFrame& DataTab::sendFrame()
+{
+    if(m_isSendFrameValid)
+        return m_sendFrame;
+    const TxTemplate::Converter toText = TxTemplate::textConverter(dataCodec, unescapeSendedData);
+    // the fields are only parsed in the template mode
+    TxTemplate sendTemplate(ui->data_templateBox->isChecked());
+    sendTemplate.append(ui->sendEdit->text(), isSendedDataHex ? TxTemplate::hexConverter() : toText);
     if(ui->data_suffixBox->isChecked())
-    {
-        if(ui->data_suffixTypeBox->currentIndex() == 0)
-        {
-            if(unescapeSendedData)
-                data += Util::unescape(ui->data_suffixEdit->text(), dataCodec);
-            else
-                data += dataCodec->fromUnicode(ui->data_suffixEdit->text());
-        }
-        else if(ui->data_suffixTypeBox->currentIndex() == 1)
-            data += QByteArray::fromHex(ui->data_suffixEdit->text().toLatin1());
-        else if(ui->data_suffixTypeBox->currentIndex() == 2)
-            data += "\r\n";
-        else if(ui->data_suffixTypeBox->currentIndex() == 3)
-            data += "\n";
-    }
+        sendTemplate.appendAffix(ui->data_suffixTypeBox->currentIndex(), ui->data_suffixEdit->text(), toText);
+    m_sendFrameError = sendTemplate.isValid() ? QString() : sendTemplate.errorString();
+    m_sendFrame = sendTemplate.isValid() ? sendTemplate.frame() : TxFrame();
+    m_isSendFrameValid = true;
+    return m_sendFrame;
+}
 
-    emit send(data);
+bool DataTab::checkSendFrame()
+{
+    sendFrame();
+    if(m_sendFrameError.isEmpty())
+        return true;
+    QMessageBox::warning(this, tr("Error"), tr("Invalid template:") + "\n" + m_sendFrameError);
+    return false;
 }
 
 void DataTab::syncReceivedEditWithData()
 {
-    RxSlider->blockSignals(true);
-    if(isReceivedDataHex)
-    {
-        if(RxTimestampEnabled)
-        {
-            ui->receivedEdit->clear();
-            for(const Metadata& item : qAsConst(*RxMetadata))
-            {
-                QByteArray dataItem = rawReceivedData->mid(item.pos, item.len);
-                ui->receivedEdit->appendPlainText(stringWithTimestamp(dataItem.toHex(' '), item.timestamp));
-            }
-        }
-        else
-        {
-            ui->receivedEdit->setPlainText(rawReceivedData->toHex(' ') + ' ');
-        }
-    }
-    else
-    {
-        if(RxTimestampEnabled)
-        {
-            ui->receivedEdit->clear();
-            for(const Metadata& item : qAsConst(*RxMetadata))
-            {
-                QByteArray dataItem = rawReceivedData->mid(item.pos, item.len);
-                ui->receivedEdit->appendPlainText(stringWithTimestamp(dataCodec->toUnicode(dataItem), item.timestamp));
-            }
-        }
-        else
-        {
-            // sync, use QTextCodec
-            ui->receivedEdit->setPlainText(dataCodec->toUnicode(*rawReceivedData));
-        }
-    }
-    RxSlider->blockSignals(false);
-//    qDebug() << toHEX(*rawReceivedData);
+    m_frameModel->sync();
+    m_RxModel->sync();
+    syncConversationWithData();
 }
 
 void DataTab::syncSendedEditWithData()
 {
     if(isSendedDataHex)
-        ui->sendedEdit->setPlainText(rawSendedData->toHex(' ') + ' ');
+        ui->sendedEdit->setPlainText(HexFormatter::hex(rawSendedData->constData(), rawSendedData->size()) + ' ');
     else
-        ui->sendedEdit->setPlainText(dataCodec->toUnicode(*rawSendedData));
+        ui->sendedEdit->setPlainText(StreamDecoder::decode(dataCodec, *rawSendedData));
+    syncConversationWithData();
 }
 
 void DataTab::setConnection(Connection* conn)
@@ -416,9 +750,20 @@ void DataTab::setConnection(Connection* conn)
     m_connection = conn;
 }
 
+void DataTab::setCaptureIndex(const CaptureIndex* index)
+{
+    m_RxModel->setCaptureIndex(index);
+}
+
+void DataTab::setFrameSplitEnabled(bool enabled)
+{
+    m_RxModel->setFrameSplitEnabled(enabled);
+}
+
 void DataTab::onConnEstablished()
 {
-    if(m_connection->type() == Connection::SerialPort)
+    const Connection::Type type = m_connection->type();
+    if(type == Connection::SerialPort || type == Connection::RFC2217_Client || type == Connection::RFC2217_Server)
     {
         ui->data_flowRTSBox->setVisible(m_connection->getSerialPortArgument().flowControl != QSerialPort::HardwareControl);
         // sync states from serial to UI
@@ -461,7 +806,7 @@ void DataTab::appendSendedData(const QByteArray& data)
     ui->sendedEdit->moveCursor(QTextCursor::End);
     if(isSendedDataHex)
     {
-        ui->sendedEdit->insertPlainText(data.toHex(' ') + ' ');
+        ui->sendedEdit->insertPlainText(HexFormatter::hex(data.constData(), data.size()) + ' ');
         TxHexCounter += data.length();
         if(TxHexCounter > 5000)
         {
@@ -471,90 +816,26 @@ void DataTab::appendSendedData(const QByteArray& data)
     }
     else
     {
-        ui->sendedEdit->insertPlainText(dataCodec->toUnicode(data));
+        ui->sendedEdit->insertPlainText(StreamDecoder::decode(dataCodec, data));
     }
+    syncConversationWithData();
 }
 
-// TODO:
-// split sync process, add processEvents()
-// void MainWindow::syncEditWithData()
 void DataTab::appendReceivedData(const QByteArray &data, const QVector<Metadata>& metadata)
 {
-    // Record cursor position and selection
-    QTextCursor textCursor = ui->receivedEdit->textCursor();
-    int sliderPos;
-
-    if(!ui->receivedLatestBox->isChecked())
+    // the data and metadata are already in rawReceivedData and RxMetadata
+    Q_UNUSED(data)
+    Q_UNUSED(metadata)
+    syncConversationWithData();
+    if(!ui->receivedFrameView->isHidden())
     {
-        // Record slider position
-        sliderPos = RxSlider->sliderPosition();
-    }
-
-    ui->receivedEdit->moveCursor(QTextCursor::End);
-    if(isReceivedDataHex)
-    {
-        qint64 offset = 0;
-        QByteArray dataItem;
-        if(RxTimestampEnabled)
-        {
-            for(const Metadata& item : metadata)
-            {
-                dataItem = data.mid(offset, item.len);
-                offset += item.len;
-                ui->receivedEdit->appendPlainText(stringWithTimestamp(dataItem.toHex(' ') + ' ', item.timestamp));
-            }
-        }
-
-        dataItem = data.mid(offset);
-        ui->receivedEdit->insertPlainText(dataItem.toHex(' ') + ' ');
-        RxHexCounter += dataItem.length();
-        // QPlainTextEdit is not good at handling long line
-        // Seperate for better realtime receiving response
-        if(RxHexCounter > 5000)
-        {
-            ui->receivedEdit->insertPlainText("\n");
-            RxHexCounter = 0;
-        }
-    }
-    else
-    {
-        qint64 offset = 0;
-        QByteArray dataItem;
-        if(RxTimestampEnabled)
-        {
-            for(const Metadata& item : metadata)
-            {
-                dataItem = data.mid(offset, item.len);
-                offset += item.len;
-                if(lastReceivedByte == '\r' && !dataItem.isEmpty() && *dataItem.cbegin() == '\n')
-                    ui->receivedEdit->appendPlainText(stringWithTimestamp(RxDecoder->toUnicode(dataItem.right(dataItem.size() - 1)), item.timestamp));
-                else
-                    ui->receivedEdit->appendPlainText(stringWithTimestamp(RxDecoder->toUnicode(dataItem), item.timestamp));
-                lastReceivedByte = *dataItem.crbegin();
-            }
-        }
-
-        dataItem = data.mid(offset);
-        // append, use QTextDecoder
-        // if \r and \n are received seperatedly, the rawReceivedData will be fine, but the receivedEdit will have one more empty line
-        // just ignore one of them
-        if(lastReceivedByte == '\r' && !dataItem.isEmpty() && *dataItem.cbegin() == '\n')
-            ui->receivedEdit->insertPlainText(RxDecoder->toUnicode(dataItem.right(dataItem.size() - 1)));
-        else
-            ui->receivedEdit->insertPlainText(RxDecoder->toUnicode(dataItem));
-        lastReceivedByte = *dataItem.crbegin();
-    }
-    ui->receivedEdit->setTextCursor(textCursor);
-    if(!ui->receivedLatestBox->isChecked())
-    {
-        // Restore slider position
-        RxSlider->setSliderPosition(sliderPos);
-    }
-    else
-    {
-        // Sometimes the slider position is a few lines above the maximum position
-        RxSlider->setSliderPosition(RxSlider->maximum());
+        m_frameModel->sync();
+        if(ui->receivedLatestBox->isChecked())
+            ui->receivedFrameView->scrollToBottom();
+        return;
     }
+    // only the new rows are inserted, the view keeps its position unless it's following the latest data
+    m_RxModel->sync();
 }
 
 void DataTab::on_data_flowDTRBox_clicked(bool checked)
@@ -574,6 +855,7 @@ void DataTab::on_data_flowRTSBox_clicked(bool checked)
 void DataTab::on_data_unescapeBox_stateChanged(int arg1)
 {
     unescapeSendedData = (arg1 == Qt::Checked);
+    onSendFrameChanged();
 }
 
 void DataTab::on_sendedEdit_selectionChanged()
@@ -591,9 +873,11 @@ void DataTab::on_sendedEdit_selectionChanged()
 }
 
 
-void DataTab::on_receivedEdit_selectionChanged()
+void DataTab::onReceivedSelectionChanged()
 {
-    if(ui->receivedEdit->textCursor().hasSelection())
+    // set again by selectTimeRange()
+    m_timeRangeBegin = m_timeRangeEnd = -1;
+    if(receivedListView()->selectionModel()->hasSelection())
     {
         ui->receivedExportButton->setText(tr("Export Selected"));
         ui->receivedCopyButton->setText(tr("Copy Selected"));
@@ -615,9 +899,224 @@ void DataTab::showUpTabHelper(int tabID)
     emit showUpTab(tabID);
 }
 
-inline QString DataTab::stringWithTimestamp(const QString& str, qint64 timestamp)
+QString DataTab::selectedReceivedText()
+{
+    const bool isConversation = ui->receivedConversationBox->isChecked();
+    QModelIndexList rows = receivedListView()->selectionModel()->selectedRows();
+    std::sort(rows.begin(), rows.end());
+    QString result;
+    for(int i = 0; i < rows.size(); i++)
+    {
+        if(i > 0)
+            result += '\n';
+        result += isConversation ? m_timelineModel->rowText(rows[i].row()) : m_RxModel->rowText(rows[i].row());
+    }
+    return result;
+}
+
+void DataTab::on_receivedSearchEdit_returnPressed()
 {
-    return ('[' + QDateTime::fromMSecsSinceEpoch(timestamp).toString(Qt::ISODateWithMs) + "] " + str);
+    on_receivedSearchNextButton_clicked();
+}
+
+void DataTab::on_receivedSearchNextButton_clicked()
+{
+    if(updateSearch())
+        return;
+    const int num = m_RxModel->matches().size();
+    if(num > 0)
+        showMatch((m_RxModel->currentMatch() + 1) % num);
+}
+
+void DataTab::on_receivedSearchPrevButton_clicked()
+{
+    if(updateSearch())
+        return;
+    const int num = m_RxModel->matches().size();
+    const int id = m_RxModel->currentMatch();
+    if(num > 0)
+        showMatch(id <= 0 ? num - 1 : id - 1);
+}
+
+void DataTab::onSearchMatchesChanged()
+{
+    if(m_showFirstMatch && !m_RxModel->matches().isEmpty())
+    {
+        m_showFirstMatch = false;
+        showMatch(0);
+    }
+    else
+        updateSearchLabel();
+}
+
+// starts a new search if the pattern is changed, returns true if it's started or the pattern is invalid
+bool DataTab::updateSearch()
+{
+    const int type = ui->receivedSearchTypeBox->currentIndex();
+    const QString text = ui->receivedSearchEdit->text();
+    QByteArray pattern;
+    if(type == 0)
+        pattern = dataCodec->fromUnicode(text);
+    else if(type == 1)
+        pattern = QByteArray::fromHex(text.toLatin1());
+    else
+    {
+        const QRegularExpression regExp(text);
+        if(!regExp.isValid())
+        {
+            QMessageBox::warning(this, tr("Error"), tr("Invalid regular expression:") + "\n" + regExp.errorString());
+            return true;
+        }
+        pattern = text.toUtf8();
+    }
+    if(type == m_searchType && pattern == m_searchPattern)
+        return false;
+    m_searchType = type;
+    m_searchPattern = pattern;
+    m_showFirstMatch = true;
+    m_RxModel->startSearch(pattern, type == 2);
+    return true;
+}
+
+void DataTab::showMatch(int id)
+{
+    m_RxModel->setCurrentMatch(id);
+    scrollToPos(m_RxModel->matches()[id].first);
+    updateSearchLabel();
+}
+
+// returns false if the row of pos is not shown
+bool DataTab::scrollToPos(qint64 pos)
+{
+    const int row = m_RxModel->rowOf(pos);
+    if(row == -1)
+        return false;
+    // stop following the latest data, otherwise the view jumps back
+    ui->receivedLatestBox->setChecked(false);
+    const QModelIndex index = m_RxModel->index(row);
+    ui->receivedView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+    ui->receivedView->setCurrentIndex(index);
+    return true;
+}
+
+void DataTab::on_receivedGotoEdit_returnPressed()
+{
+    const QString text = ui->receivedGotoEdit->text().trimmed();
+    const int type = ui->receivedGotoTypeBox->currentIndex();
+    qint64 pos = -1;
+    bool ok = false;
+    if(type == 0)
+    {
+        // starts from 1 in UI
+        const qint64 line = text.toLongLong(&ok);
+        if(ok && line >= 1 && line <= m_RxModel->lineCount())
+            pos = m_RxModel->lineBegin(line - 1);
+    }
+    else if(type == 1)
+    {
+        const qint64 frame = text.toLongLong(&ok);
+        if(ok && frame >= 1 && frame <= RxMetadata->size())
+            pos = (*RxMetadata)[frame - 1].pos;
+    }
+    else if(type == 2)
+    {
+        // "T1 ~ T2" selects the frames received in the range
+        if(text.contains('~'))
+        {
+            if(!selectTimeRange(text))
+                QMessageBox::information(this, tr("Info"), text + " " + tr("is not found in the received data."));
+            return;
+        }
+        // the first frame received at or after the time
+        const qint64 timestamp = parseTimestamp(text);
+        const int id = (timestamp != -1) ? Metadata::indexAtTime(*RxMetadata, timestamp) : RxMetadata->size();
+        if(id < RxMetadata->size())
+            pos = (*RxMetadata)[id].pos;
+    }
+    if(!scrollToPos(pos))
+        QMessageBox::information(this, tr("Info"), text + " " + tr("is not found in the received data."));
+}
+
+bool DataTab::selectTimeRange(const QString& text)
+{
+    const QStringList parts = text.split('~');
+    if(parts.size() != 2)
+        return false;
+    const qint64 from = parseTimestamp(parts[0].trimmed());
+    const qint64 to = parseTimestamp(parts[1].trimmed());
+    if(from == -1 || to == -1)
+        return false;
+    qint64 begin, end;
+    Metadata::posRangeOfTime(*RxMetadata, from, to, &begin, &end);
+    const int firstRow = m_RxModel->rowOf(begin);
+    if(begin >= end || firstRow == -1)
+        return false;
+    int lastRow = m_RxModel->rowOf(end - 1);
+    // the last row is not shown yet
+    if(lastRow == -1)
+        lastRow = m_RxModel->rowCount() - 1;
+    scrollToPos(begin);
+    ui->receivedView->selectionModel()->select(QItemSelection(m_RxModel->index(firstRow), m_RxModel->index(lastRow)), QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+    m_timeRangeBegin = begin;
+    m_timeRangeEnd = end;
+    return true;
+}
+
+qint64 DataTab::parseTimestamp(const QString& text) const
+{
+    QDateTime time = QDateTime::fromString(text, Qt::ISODateWithMs);
+    if(!time.isValid())
+    {
+        // only the time is given, use the date of the latest frame
+        QTime timeOfDay = QTime::fromString(text, "hh:mm:ss.zzz");
+        if(!timeOfDay.isValid())
+            timeOfDay = QTime::fromString(text, "hh:mm:ss");
+        if(!timeOfDay.isValid() || RxMetadata->isEmpty())
+            return -1;
+        time = QDateTime(QDateTime::fromMSecsSinceEpoch(RxMetadata->last().timestamp).date(), timeOfDay);
+    }
+    return time.toMSecsSinceEpoch();
+}
+
+void DataTab::onReceivedCurrentChanged()
+{
+    const QModelIndex current = ui->receivedView->currentIndex();
+    if(!current.isValid())
+    {
+        ui->receivedPosLabel->clear();
+        return;
+    }
+    // both are found by binary search
+    const qint64 pos = m_RxModel->posOf(current.row());
+    const QLocale locale;
+    QString text = tr("Line") + " " + locale.toString(m_RxModel->lineOf(pos) + 1);
+    const int frameId = Metadata::indexAt(*RxMetadata, pos);
+    if(frameId >= 0)
+        text += ", " + tr("Frame") + " " + locale.toString(frameId + 1) + " " + tr("of") + " " + locale.toString(RxMetadata->size());
+    ui->receivedPosLabel->setText(text);
+}
+
+void DataTab::updateSearchLabel()
+{
+    const QVector<QPair<qint64, qint64>>& matches = m_RxModel->matches();
+    const int id = m_RxModel->currentMatch();
+    QString text;
+    if(matches.isEmpty())
+    {
+        if(!m_searchPattern.isEmpty())
+            text = m_RxModel->isSearching() ? tr("Searching") : tr("Not found");
+    }
+    else
+    {
+        text = (id >= 0 ? QString::number(id + 1) : "-") + "/" + QString::number(matches.size());
+        // the timestamp of the data containing the match
+        const Metadata* item = (id >= 0) ? m_RxModel->metadataAt(matches[id].first) : nullptr;
+        if(item != nullptr)
+            text += " " + QDateTime::fromMSecsSinceEpoch(item->timestamp).toString(Qt::ISODateWithMs);
+    }
+    if(m_RxModel->isSearching())
+        text += " (" + QString::number(m_RxModel->searchProgress()) + "%)";
+    ui->receivedSearchLabel->setText(text);
 }
 
 void DataTab::onRecordDataChanged(bool enabled)
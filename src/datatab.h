@@ -3,7 +3,6 @@
 
 #include <QWidget>
 #include <QScrollBar>
-#include <QTextDecoder>
 
 #ifdef Q_OS_ANDROID
 #include <QAndroidJniEnvironment>
@@ -13,25 +12,39 @@
 #include "mysettings.h"
 #include "connection.h"
 #include "metadata.h"
+#include "canframemodel.h"
+#include "rxdatamodel.h"
+#include "timelinemodel.h"
+#include "streamdecoder.h"
+#include "txframe.h"
 
 namespace Ui
 {
 class DataTab;
 }
 
+class RxExporter;
+class QProgressDialog;
+class QListView;
+
 class DataTab : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit DataTab(QByteArray* RxBuf, QVector<Metadata>* RxMetadataBuf, QByteArray* TxBuf, QWidget *parent = nullptr);
+    explicit DataTab(QByteArray* RxBuf, QVector<Metadata>* RxMetadataBuf, QByteArray* TxBuf, Timeline* timeline, QWidget *parent = nullptr);
     ~DataTab();
 
     void appendSendedData(const QByteArray &data);
     void appendReceivedData(const QByteArray &data, const QVector<Metadata>& metadata);
+    // called for every received chunk, ignored if the terminal is disabled
+    void feedTerminal(const QByteArray& data);
     void syncReceivedEditWithData();
     void syncSendedEditWithData();
     void setConnection(Connection* conn);
+    void setCaptureIndex(const CaptureIndex* index);
+    // one received frame per row
+    void setFrameSplitEnabled(bool enabled);
 
     void setRepeat(bool state);
     bool getRxRealtimeState();
@@ -69,22 +82,40 @@ private slots:
 
     void on_sendedEdit_selectionChanged();
 
-    void on_receivedEdit_selectionChanged();
+    void onReceivedSelectionChanged();
 
     void on_sendedEnableBox_stateChanged(int arg1);
 
     void on_receivedTimestampBox_stateChanged(int arg1);
 
+    void on_receivedTerminalBox_stateChanged(int arg1);
+
+    void on_receivedConversationBox_stateChanged(int arg1);
+
+    void on_receivedLatestBox_stateChanged(int arg1);
+
+    void onReceivedRowsChanged();
+
+    void on_receivedSearchEdit_returnPressed();
+    void on_receivedSearchNextButton_clicked();
+    void on_receivedSearchPrevButton_clicked();
+    void onSearchMatchesChanged();
+
+    void on_receivedGotoEdit_returnPressed();
+    void onReceivedCurrentChanged();
+
+    void onExportChunkWritten(qint64 end, int generation);
+    void onExportFinished(bool succeeded, const QString& errorString, int generation);
+    void onExportCanceled();
+
     void recordDataToBeSent();
+    void onSendFrameChanged();
 private:
     Ui::DataTab *ui;
 
     QIODevice* IODevice;
     Connection* m_connection = nullptr;
     MySettings* settings;
-    QTimer* repeatTimer;
-
-    QScrollBar* RxSlider;
 
     bool isReceivedDataHex = false;
     bool isSendedDataHex = false;
@@ -92,35 +123,95 @@ private:
     bool TxTimestampEnabled = false;
     bool unescapeSendedData = false;
 
-    QTextCodec* dataCodec = nullptr; // for Tx and generating Rx decoder
-    QTextDecoder* RxDecoder = nullptr; // for Rx UI, a multi-byte character might be split.
-    char lastReceivedByte = '\0';
-    int RxHexCounter = 0, TxHexCounter = 0;
+    QTextCodec* dataCodec = nullptr; // for Tx and Rx
+    int TxHexCounter = 0;
     QByteArray* rawReceivedData = nullptr;
     QVector<Metadata>* RxMetadata;
     QByteArray* rawSendedData = nullptr;
+    Timeline* m_timeline;
+    CANFrameModel* m_frameModel;
+    RxDataModel* m_RxModel;
+    TimelineModel* m_timelineModel;
 
     bool acceptClearSignal = false;
 
+    // compiled from sendEdit and the suffix when they are changed, rather than on every send
+    TxFrame m_sendFrame;
+    bool m_isSendFrameValid = false;
+    QString m_sendFrameError;
+    quint64 m_sendSequence = 0;
+    // in us
+    static const qint64 m_minRepeatPeriod = 1;
+
+    // the last search
+    QByteArray m_searchPattern;
+    int m_searchType = -1;
+    bool m_showFirstMatch = false;
+
+    // exporting the whole received data in the background
+    static const int m_exportChunkSize = 1024 * 1024;
+    static const int m_maxPendingExportChunkNum = 4;
+    QThread* m_exporterThread;
+    RxExporter* m_exporter;
+    QProgressDialog* m_exportDialog = nullptr;
+    int m_exportGeneration = 0;
+    int m_exportFormat = 0;
+    int m_exportPendingChunkNum = 0;
+    // only [m_exportBegin, m_exportEnd) is exported
+    qint64 m_exportBegin = 0;
+    qint64 m_exportEnd = 0;
+    int m_exportItemEnd = 0;
+    qint64 m_exportFedPos = 0;
+    int m_exportFedItem = 0;
+    qint64 m_exportFedEntryOffset = 0; // the fed part of m_exportEntries[m_exportFedItem]
+    // the conversation formats export a snapshot of the timeline, the positions are entry ids
+    bool m_isTimelineExport = false;
+    QVector<Timeline::Entry> m_exportEntries;
+    int m_exportTimelineGeneration = 0;
+    // the bytes of the selected time range, -1 if the selection is not a time range
+    qint64 m_timeRangeBegin = -1;
+    qint64 m_timeRangeEnd = -1;
+
     void loadPreference();
     void showUpTabHelper(int tabID);
-    inline QString stringWithTimestamp(const QString& str, qint64 timestamp);
+    QString selectedReceivedText();
+    bool updateSearch();
+    void showMatch(int id);
+    void updateSearchLabel();
+    bool scrollToPos(qint64 pos);
+    bool selectTimeRange(const QString& text);
+    qint64 parseTimestamp(const QString& text) const;
+    void startExport(const QString& fileName, int format, qint64 begin, qint64 end);
+    void feedExporter();
+    void feedTimelineExporter();
+    void stopExport();
 
 #ifdef Q_OS_ANDROID
     static DataTab* m_currInstance;
     static void onSharedTextReceived(JNIEnv *env, jobject thiz, jstring text);
 #endif
     void clearRxData();
+    void syncConversationWithData();
+    // receivedView, or receivedConversationView in the conversation mode
+    QListView* receivedListView() const;
+    TxFrame& sendFrame();
+    bool checkSendFrame();
+    qint64 repeatPeriod() const;
 signals:
     void send(const QByteArray& data);
+    // period: in us
+    void startRepeat(const TxFrame& frame, qint64 period);
+    void stopRepeat();
     void setDataCodec(QTextCodec* codec);
-    void setPlotDecoder(QTextDecoder* decoder);
+    void setPlotDecoder(StreamDecoder* decoder);
     void updateRxTxLen(bool updateRx, bool updateTx);
     void clearSendedData();
     void clearReceivedData();
     void clearGraph();
     void setTxDataRecording(bool enabled);
     void showUpTab(int tabID);
+    // the keystrokes in the terminal
+    void terminalInput(const QByteArray& data);
 };
 
 #endif // DATATAB_H
@@ -0,0 +1,106 @@
+#include "deframer.h"
+
+#include <cstring>
+
+void Deframer::setMode(Mode mode)
+{
+    m_mode = mode;
+    reset();
+}
+
+Deframer::Mode Deframer::mode() const
+{
+    return m_mode;
+}
+
+void Deframer::setLengthField(int size, bool bigEndian)
+{
+    m_lengthSize = size;
+    m_lengthBigEndian = bigEndian;
+    reset();
+}
+
+void Deframer::setDelimiter(char delimiter)
+{
+    m_delimiter = delimiter;
+    reset();
+}
+
+void Deframer::reset()
+{
+    m_frameLen = 0;
+    m_payloadLen = 0;
+}
+
+void Deframer::feed(const char* data, qint64 len, qint64 pos, QVector<qint64>* frameEnds)
+{
+    if(m_mode == None)
+        return;
+    else if(m_mode == LengthPrefix)
+        feedLengthPrefixed(data, len, pos, frameEnds);
+    else
+        feedDelimited(data, len, pos, frameEnds);
+}
+
+void Deframer::feedDelimited(const char* data, qint64 len, qint64 pos, QVector<qint64>* frameEnds)
+{
+    const char delimiter = (m_mode == SLIP) ? '\xC0' : ((m_mode == COBS) ? '\0' : m_delimiter);
+    // SLIP and COBS senders might put a delimiter before every frame, skip the empty frames
+    const bool skipEmpty = (m_mode != Delimiter);
+    const char* begin = data;
+    const char* end = data + len;
+    while(begin < end)
+    {
+        const char* found = (const char*)memchr(begin, delimiter, end - begin);
+        if(found == nullptr)
+        {
+            m_frameLen += end - begin;
+            break;
+        }
+        m_frameLen += found - begin;
+        // the leading delimiter joins the next frame
+        if(m_frameLen > 0 || !skipEmpty)
+        {
+            frameEnds->append(pos + (found - data) + 1);
+            m_frameLen = 0;
+        }
+        begin = found + 1;
+    }
+}
+
+void Deframer::feedLengthPrefixed(const char* data, qint64 len, qint64 pos, QVector<qint64>* frameEnds)
+{
+    qint64 i = 0;
+    while(i < len)
+    {
+        if(m_frameLen < m_lengthSize)
+        {
+            m_lengthBytes[m_frameLen++] = data[i++];
+            if(m_frameLen < m_lengthSize)
+                continue;
+            m_payloadLen = 0;
+            for(int j = 0; j < m_lengthSize; j++)
+                m_payloadLen |= (quint32)m_lengthBytes[j] << (8 * (m_lengthBigEndian ? m_lengthSize - 1 - j : j));
+            if(m_lengthSize + (qint64)m_payloadLen > m_maxFrameLen)
+            {
+                // out of sync or noise, skip the first byte and read the length again
+                // the skipped bytes join the next frame
+                memmove(m_lengthBytes, m_lengthBytes + 1, m_lengthSize - 1);
+                m_frameLen--;
+                continue;
+            }
+        }
+        else
+        {
+            const qint64 step = qMin(len - i, m_lengthSize + (qint64)m_payloadLen - m_frameLen);
+            i += step;
+            m_frameLen += step;
+        }
+        if(m_frameLen == m_lengthSize + (qint64)m_payloadLen)
+        {
+            frameEnds->append(pos + i);
+            m_frameLen = 0;
+            m_payloadLen = 0;
+        }
+    }
+}
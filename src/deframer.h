@@ -0,0 +1,50 @@
+#ifndef DEFRAMER_H
+#define DEFRAMER_H
+
+#include <QVector>
+
+// Splits the received stream into frames incrementally, the state is kept between the chunks.
+// The data is neither copied nor decoded, only the end positions of the frames are reported,
+// so the raw capture is kept as it is and one frame can be shown per row.
+class Deframer
+{
+public:
+    enum Mode
+    {
+        None = 0,
+        SLIP, // frames end with 0xC0, the empty frames are ignored
+        COBS, // frames end with 0x00, the empty frames are ignored
+        LengthPrefix, // the length field counts the bytes after it, a byte is skipped if the frame is too long
+        Delimiter, // frames end with a custom byte
+    };
+
+    void setMode(Mode mode);
+    Mode mode() const;
+    // size: 1, 2 or 4
+    void setLengthField(int size, bool bigEndian);
+    void setDelimiter(char delimiter);
+    // forgets the unfinished frame
+    void reset();
+    // data[0] is at pos of the stream, the end positions of the frames ending in data are appended
+    void feed(const char* data, qint64 len, qint64 pos, QVector<qint64>* frameEnds);
+private:
+    // LengthPrefix, including the length field
+    static const qint64 m_maxFrameLen = 64 * 1024;
+
+    Mode m_mode = None;
+    int m_lengthSize = 1;
+    bool m_lengthBigEndian = false;
+    char m_delimiter = '\n';
+
+    // the bytes of the unfinished frame, excluding the skipped delimiters
+    qint64 m_frameLen = 0;
+    // LengthPrefix, the payload length is valid after the length field
+    quint32 m_payloadLen = 0;
+    // LengthPrefix, kept until the length is accepted
+    quint8 m_lengthBytes[4];
+
+    void feedDelimited(const char* data, qint64 len, qint64 pos, QVector<qint64>* frameEnds);
+    void feedLengthPrefixed(const char* data, qint64 len, qint64 pos, QVector<qint64>* frameEnds);
+};
+
+#endif // DEFRAMER_H
@@ -9,6 +9,7 @@
 #include <QNetworkInterface>
 #include <QTreeWidgetItem>
 #include <QScroller>
+#include <QProcess>
 #ifdef Q_OS_ANDROID
 #include <QtAndroid>
 #include <QAndroidJniEnvironment>
@@ -26,6 +27,11 @@ const QMap<QString, QString> DeviceTab::m_historyPrefix =
     {QLatin1String("TCPServer"), QLatin1String("SerialTest_History_TCP_Server")},
     {QLatin1String("TCPClient"), QLatin1String("SerialTest_History_TCP_Client")},
     {QLatin1String("UDP"), QLatin1String("SerialTest_History_UDP")},
+    {QLatin1String("Process"), QLatin1String("SerialTest_History_Process")},
+    {QLatin1String("LocalSocket"), QLatin1String("SerialTest_History_LocalSocket")},
+    {QLatin1String("SocketCAN"), QLatin1String("SerialTest_History_SocketCAN")},
+    {QLatin1String("RFC2217Client"), QLatin1String("SerialTest_History_RFC2217_Client")},
+    {QLatin1String("RFC2217Server"), QLatin1String("SerialTest_History_RFC2217_Server")},
 };
 
 DeviceTab::DeviceTab(QWidget *parent) :
@@ -147,6 +153,16 @@ void DeviceTab::initSettings()
     settings->endGroup();
 
     // TCP server preference(last connected) is loaded in on_typeBox_currentIndexChanged()
+
+    settings->beginGroup("SerialTest_Bridge");
+    ui->bridgeBox->setChecked(settings->value("Enabled", false).toBool());
+    ui->bridge_typeBox->blockSignals(true);
+    ui->bridge_typeBox->setCurrentIndex(qMax(ui->bridge_typeBox->findData(settings->value("Type", Connection::TCP_Server).toInt()), 0));
+    ui->bridge_typeBox->blockSignals(false);
+    ui->bridge_addrEdit->setText(settings->value("Address", "").toString());
+    ui->bridge_portEdit->setText(settings->value("Port", 2000).toString());
+    settings->endGroup();
+    on_bridge_typeBox_currentIndexChanged(ui->bridge_typeBox->currentIndex()); // update UI and apply
 }
 
 void DeviceTab::setConnection(Connection *conn)
@@ -154,12 +170,19 @@ void DeviceTab::setConnection(Connection *conn)
     m_connection = conn;
 }
 
+void DeviceTab::setBridge(Bridge* bridge)
+{
+    m_bridge = bridge;
+    connect(m_bridge, &Bridge::statisticsUpdated, this, &DeviceTab::onBridgeStatisticsUpdated);
+    connect(m_bridge, &Bridge::peerFailed, this, &DeviceTab::onBridgePeerFailed);
+}
+
 void DeviceTab::refreshTargetList()
 {
     if(m_connection == nullptr)
         return;
     Connection::Type currType = m_connection->type();
-    if(currType == Connection::SerialPort)
+    if(currType == Connection::SerialPort || currType == Connection::RFC2217_Server)
     {
         ui->SP_portList->setRowCount(0);
         ui->SP_portNameBox->clear();
@@ -219,6 +242,24 @@ void DeviceTab::refreshTargetList()
 #endif
         BTClient_discoveryAgent->start(QBluetoothDeviceDiscoveryAgent::LowEnergyMethod);
     }
+    else if(currType == Connection::SocketCAN)
+    {
+        QStringList CANInterfaceList;
+        const auto interfaceList = QNetworkInterface::allInterfaces();
+        for(auto it = interfaceList.cbegin(); it != interfaceList.cend(); ++it)
+        {
+            if(it->type() == QNetworkInterface::CanBus)
+                CANInterfaceList += it->name() + (it->flags().testFlag(QNetworkInterface::IsUp) ? QString() : tr("(Down)"));
+        }
+        ui->Local_tipLabel->setText(tr("Available interfaces:") + " " + CANInterfaceList.join(", ") + "\n"
+                                    + tr("Send frames in the format of cansend, one frame per line:") + "\n"
+                                    + "123#DEADBEEF\n12345678#R\n123##1AABBCC");
+    }
+    else if(currType == Connection::RFC2217_Client)
+    {
+        ui->Local_tipLabel->setText(tr("Connect to a remote serial port over RFC 2217 (Telnet COM Port Control).") + "\n"
+                                    + tr("Input the server as <host>:<port>, the line settings are sent to the server after connected."));
+    }
 }
 
 #ifdef Q_OS_ANDROID
@@ -322,6 +363,19 @@ void DeviceTab::initUI()
 
     ui->Net_localPortEdit->setValidator(m_netPortValidator);
     ui->Net_remotePortEdit->setValidator(m_netPortValidator);
+    ui->SP_RFC2217PortEdit->setValidator(m_netPortValidator);
+    ui->bridge_portEdit->setValidator(m_netPortValidator);
+    ui->bridge_typeBox->blockSignals(true);
+    ui->bridge_typeBox->addItem(Connection::getTypeName(Connection::TCP_Server), Connection::TCP_Server);
+    ui->bridge_typeBox->addItem(Connection::getTypeName(Connection::TCP_Client), Connection::TCP_Client);
+    ui->bridge_typeBox->addItem(Connection::getTypeName(Connection::UDP), Connection::UDP);
+    ui->bridge_typeBox->blockSignals(false);
+    ui->bridge_addrLabel->hide();
+    ui->bridge_addrEdit->hide();
+    connect(ui->bridge_addrEdit, &QLineEdit::editingFinished, this, &DeviceTab::onBridgeArgumentEdited);
+    connect(ui->bridge_portEdit, &QLineEdit::editingFinished, this, &DeviceTab::onBridgeArgumentEdited);
+    ui->SP_RFC2217PortLabel->hide();
+    ui->SP_RFC2217PortEdit->hide();
 }
 
 void DeviceTab::getAvailableTypes(bool useFirstValid)
@@ -338,7 +392,16 @@ void DeviceTab::getAvailableTypes(bool useFirstValid)
     bool AndroidHWSerialEnabled = settings->value("Android_HWSerial", false).toBool();
     settings->endGroup();
     if(!AndroidHWSerialEnabled)
+    {
         invalid += Connection::SerialPort;
+        invalid += Connection::RFC2217_Server;
+    }
+    // apps are not allowed to spawn arbitrary programs
+    invalid += Connection::Process;
+    invalid += Connection::SocketCAN;
+#endif
+#ifndef Q_OS_LINUX
+    invalid += Connection::SocketCAN;
 #endif
 #ifdef Q_OS_WINDOWS
     // Qt5 and Qt6 doesn't support BLE Peripheral on Windows
@@ -375,6 +438,8 @@ void DeviceTab::getAvailableTypes(bool useFirstValid)
         invalid += Connection::TCP_Client;
         invalid += Connection::TCP_Server;
         invalid += Connection::UDP;
+        invalid += Connection::RFC2217_Client;
+        invalid += Connection::RFC2217_Server;
     }
 
     ui->typeBox->blockSignals(true);
@@ -586,11 +651,12 @@ bool DeviceTab::eventFilter(QObject *watched, QEvent *event)
         // like editFinished()
         QComboBox* box = qobject_cast<QComboBox*>(watched);
         qint32 baud = box->currentText().toInt();
-        if(baud != 0 && baud != m_connection->SP_baudRate() && m_connection->type() == Connection::SerialPort && m_connection->isConnected())
+        if(baud != 0 && baud != m_connection->SP_baudRate() && SP_isConfigurable())
         {
             if(m_connection->SP_setBaudRate(baud))
             {
-                saveSPPreference(m_connection->getSerialPortArgument());
+                if(m_connection->type() != Connection::RFC2217_Client)
+                    saveSPPreference(m_connection->getSerialPortArgument());
                 emit argumentChanged();
             }
         }
@@ -645,19 +711,7 @@ void DeviceTab::on_openButton_clicked()
             QMessageBox::warning(this, tr("Error"), tr("The port has been opened."));
             return;
         }
-        Connection::SerialPortArgument arg;
-        arg.name = ui->SP_portNameBox->currentText();
-        arg.baudRate = ui->SP_baudRateBox->currentText().toInt();
-        arg.dataBits = (QSerialPort::DataBits)ui->SP_dataBitsBox->currentData().toInt();
-        arg.stopBits = (QSerialPort::StopBits)ui->SP_stopBitsBox->currentData().toInt();
-        arg.parity = (QSerialPort::Parity)ui->SP_parityBox->currentData().toInt();
-        arg.flowControl = (QSerialPort::FlowControl)ui->SP_flowControlBox->currentData().toInt();
-        const SP_ID spid = SP_ID(QSerialPortInfo(arg.name));
-        if(spid && !SP_hasDuplicateID(spid))
-            arg.id = spid.toString();
-        else
-            arg.id = arg.name;
-        m_connection->setArgument(arg);
+        m_connection->setArgument(SP_argumentFromUI());
         m_connection->open();
     }
     else if(currType == Connection::BT_Client)
@@ -796,6 +850,142 @@ void DeviceTab::on_openButton_clicked()
         m_connection->setArgument(arg);
         m_connection->open();
     }
+    else if(currType == Connection::Process)
+    {
+        if(m_connection->state() != Connection::Unconnected)
+        {
+            QMessageBox::warning(this, tr("Error"), tr("The process is already running."));
+            return;
+        }
+        Connection::LocalArgument arg;
+        arg.name = ui->Local_nameEdit->text().trimmed();
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+        arg.arguments = QProcess::splitCommand(ui->Local_argumentsEdit->text());
+#else
+        arg.arguments = ui->Local_argumentsEdit->text().split(' ', QString::SkipEmptyParts);
+#endif
+        arg.workingDirectory = ui->Local_workingDirEdit->text().trimmed();
+        m_connection->setArgument(arg);
+        m_connection->open();
+
+        settings->beginGroup(m_historyPrefix["Process"]);
+        settings->setValue("LastProgram", arg.name);
+        settings->setValue("LastArguments", ui->Local_argumentsEdit->text());
+        settings->setValue("LastWorkingDirectory", arg.workingDirectory);
+        settings->endGroup();
+    }
+    else if(currType == Connection::LocalSocket)
+    {
+        if(m_connection->isConnected())
+        {
+            QMessageBox::warning(this, tr("Error"), tr("The client has already connected to the server."));
+            return;
+        }
+        else if(m_connection->state() == Connection::Connecting)
+        {
+            // force disconnect
+            m_connection->close(true);
+        }
+        Connection::LocalArgument arg;
+        arg.name = ui->Local_nameEdit->text().trimmed();
+        m_connection->setArgument(arg);
+        m_connection->open();
+
+        settings->beginGroup(m_historyPrefix["LocalSocket"]);
+        settings->setValue("LastServerName", arg.name);
+        settings->endGroup();
+    }
+    else if(currType == Connection::SocketCAN)
+    {
+        if(m_connection->isConnected())
+        {
+            QMessageBox::warning(this, tr("Error"), tr("The interface has been opened."));
+            return;
+        }
+        Connection::CANArgument arg;
+        arg.interfaceName = ui->Local_nameEdit->text().trimmed();
+        arg.FDEnabled = ui->Local_CANFDBox->isChecked();
+        m_connection->setArgument(arg);
+        m_connection->open();
+
+        settings->beginGroup(m_historyPrefix["SocketCAN"]);
+        settings->setValue("LastInterface", arg.interfaceName);
+        settings->setValue("FDEnabled", arg.FDEnabled);
+        settings->endGroup();
+    }
+    else if(currType == Connection::RFC2217_Client)
+    {
+        if(m_connection->isConnected())
+        {
+            QMessageBox::warning(this, tr("Error"), tr("The client has already connected to the server."));
+            return;
+        }
+        else if(m_connection->state() == Connection::Connecting)
+        {
+            // force disconnect
+            m_connection->close(true);
+        }
+        const QString server = ui->SP_portNameBox->currentText().trimmed();
+        const int separatorPos = server.lastIndexOf(':');
+        Connection::NetworkArgument netArg;
+        netArg.localAddress = QHostAddress::Any;
+        if(separatorPos > 0)
+        {
+            // [::1]:2217 for IPv6 address
+            netArg.remoteName = server.left(separatorPos).remove('[').remove(']');
+            netArg.remotePort = server.mid(separatorPos + 1).toUShort();
+        }
+        else
+        {
+            netArg.remoteName = server;
+            netArg.remotePort = 2217;
+        }
+        Connection::SerialPortArgument SPArg = SP_argumentFromUI();
+        SPArg.id = SPArg.name = server;
+        m_connection->setArgument(SPArg);
+        m_connection->setArgument(netArg);
+        m_connection->open();
+
+        settings->beginGroup(m_historyPrefix["RFC2217Client"]);
+        settings->setValue("LastServer", server);
+        settings->endGroup();
+    }
+    else if(currType == Connection::RFC2217_Server)
+    {
+        if(m_connection->state() != Connection::Unconnected)
+        {
+            QMessageBox::warning(this, tr("Error"), tr("The server is already running."));
+            return;
+        }
+        Connection::SerialPortArgument SPArg = SP_argumentFromUI();
+        Connection::NetworkArgument netArg;
+        netArg.localAddress = QHostAddress::Any;
+        netArg.localPort = ui->SP_RFC2217PortEdit->text().toUInt();
+        m_connection->setArgument(SPArg);
+        m_connection->setArgument(netArg);
+        m_connection->open();
+
+        settings->beginGroup(m_historyPrefix["RFC2217Server"]);
+        settings->setValue("LastPort", netArg.localPort);
+        settings->endGroup();
+    }
+}
+
+Connection::SerialPortArgument DeviceTab::SP_argumentFromUI()
+{
+    Connection::SerialPortArgument arg;
+    arg.name = ui->SP_portNameBox->currentText();
+    arg.baudRate = ui->SP_baudRateBox->currentText().toInt();
+    arg.dataBits = (QSerialPort::DataBits)ui->SP_dataBitsBox->currentData().toInt();
+    arg.stopBits = (QSerialPort::StopBits)ui->SP_stopBitsBox->currentData().toInt();
+    arg.parity = (QSerialPort::Parity)ui->SP_parityBox->currentData().toInt();
+    arg.flowControl = (QSerialPort::FlowControl)ui->SP_flowControlBox->currentData().toInt();
+    const SP_ID spid = SP_ID(QSerialPortInfo(arg.name));
+    if(spid && !SP_hasDuplicateID(spid))
+        arg.id = spid.toString();
+    else
+        arg.id = arg.name;
+    return arg;
 }
 
 void DeviceTab::on_closeButton_clicked()
@@ -1174,6 +1364,9 @@ void DeviceTab::on_typeBox_currentIndexChanged(int index)
     BTdiscoverFinished();
     if(newType == Connection::SerialPort)
     {
+        ui->SP_portNameLabel->setText(tr("Port:"));
+        ui->SP_RFC2217PortLabel->hide();
+        ui->SP_RFC2217PortEdit->hide();
         ui->targetListStack->setCurrentWidget(ui->SPListPage);
         ui->argsStack->setCurrentWidget(ui->SPArgsPage);
     }
@@ -1267,6 +1460,87 @@ void DeviceTab::on_typeBox_currentIndexChanged(int index)
             showNetArgumentHistory(m_UDPHistory, newType);
         }
     }
+    else if(newType == Connection::Process)
+    {
+        ui->Local_nameLabel->setText(tr("Program:"));
+        ui->Local_argumentsLabel->show();
+        ui->Local_argumentsEdit->show();
+        ui->Local_workingDirLabel->show();
+        ui->Local_workingDirEdit->show();
+        ui->Local_CANFDBox->hide();
+        ui->Local_tipLabel->setText(tr("The program is started when the connection is opened.") + "\n"
+                                    + tr("Data is sent to its stdin and received from its stdout, stderr is forwarded to the console."));
+        ui->targetListStack->setCurrentWidget(ui->LocalListPage);
+        ui->argsStack->setCurrentWidget(ui->LocalArgsPage);
+
+        settings->beginGroup(m_historyPrefix["Process"]);
+        ui->Local_nameEdit->setText(settings->value("LastProgram").toString());
+        ui->Local_argumentsEdit->setText(settings->value("LastArguments").toString());
+        ui->Local_workingDirEdit->setText(settings->value("LastWorkingDirectory").toString());
+        settings->endGroup();
+    }
+    else if(newType == Connection::LocalSocket)
+    {
+        ui->Local_nameLabel->setText(tr("Server Name/Path:"));
+        ui->Local_argumentsLabel->hide();
+        ui->Local_argumentsEdit->hide();
+        ui->Local_workingDirLabel->hide();
+        ui->Local_workingDirEdit->hide();
+        ui->Local_CANFDBox->hide();
+#ifdef Q_OS_WINDOWS
+        ui->Local_tipLabel->setText(tr("Connect to a named pipe."));
+#else
+        ui->Local_tipLabel->setText(tr("Connect to a Unix domain socket."));
+#endif
+        ui->targetListStack->setCurrentWidget(ui->LocalListPage);
+        ui->argsStack->setCurrentWidget(ui->LocalArgsPage);
+
+        settings->beginGroup(m_historyPrefix["LocalSocket"]);
+        ui->Local_nameEdit->setText(settings->value("LastServerName").toString());
+        settings->endGroup();
+    }
+    else if(newType == Connection::SocketCAN)
+    {
+        ui->Local_nameLabel->setText(tr("Interface:"));
+        ui->Local_argumentsLabel->hide();
+        ui->Local_argumentsEdit->hide();
+        ui->Local_workingDirLabel->hide();
+        ui->Local_workingDirEdit->hide();
+        ui->Local_CANFDBox->show();
+        ui->targetListStack->setCurrentWidget(ui->LocalListPage);
+        ui->argsStack->setCurrentWidget(ui->LocalArgsPage);
+
+        settings->beginGroup(m_historyPrefix["SocketCAN"]);
+        ui->Local_nameEdit->setText(settings->value("LastInterface", "can0").toString());
+        ui->Local_CANFDBox->setChecked(settings->value("FDEnabled", false).toBool());
+        settings->endGroup();
+    }
+    else if(newType == Connection::RFC2217_Client)
+    {
+        // the line settings are set in SPArgsPage, the port name is the server
+        ui->SP_portNameLabel->setText(tr("Server:"));
+        ui->SP_RFC2217PortLabel->hide();
+        ui->SP_RFC2217PortEdit->hide();
+        ui->targetListStack->setCurrentWidget(ui->LocalListPage);
+        ui->argsStack->setCurrentWidget(ui->SPArgsPage);
+
+        ui->SP_portNameBox->clear();
+        settings->beginGroup(m_historyPrefix["RFC2217Client"]);
+        ui->SP_portNameBox->setCurrentText(settings->value("LastServer", "localhost:2217").toString());
+        settings->endGroup();
+    }
+    else if(newType == Connection::RFC2217_Server)
+    {
+        ui->SP_portNameLabel->setText(tr("Port:"));
+        ui->SP_RFC2217PortLabel->show();
+        ui->SP_RFC2217PortEdit->show();
+        ui->targetListStack->setCurrentWidget(ui->SPListPage);
+        ui->argsStack->setCurrentWidget(ui->SPArgsPage);
+
+        settings->beginGroup(m_historyPrefix["RFC2217Server"]);
+        ui->SP_RFC2217PortEdit->setText(QString::number(settings->value("LastPort", 2217).toUInt()));
+        settings->endGroup();
+    }
     emit connTypeChanged(newType);
     refreshTargetList();
 }
@@ -1360,14 +1634,24 @@ void DeviceTab::on_Net_localAddrBox_currentIndexChanged(int index)
 }
 
 
+bool DeviceTab::SP_isConfigurable()
+{
+    // the line settings of the local serial port or the remote one in RFC2217_Client
+    if(m_connection == nullptr || !m_connection->isConnected())
+        return false;
+    const Connection::Type type = m_connection->type();
+    return type == Connection::SerialPort || type == Connection::RFC2217_Client || type == Connection::RFC2217_Server;
+}
+
 void DeviceTab::on_SP_baudRateBox_currentIndexChanged(int index)
 {
     Q_UNUSED(index)
-    if(m_connection == nullptr || m_connection->type() != Connection::SerialPort || !m_connection->isConnected())
+    if(!SP_isConfigurable())
         return;
     if(m_connection->SP_setBaudRate(ui->SP_baudRateBox->currentText().toInt()))
     {
-        saveSPPreference(m_connection->getSerialPortArgument());
+        if(m_connection->type() != Connection::RFC2217_Client)
+            saveSPPreference(m_connection->getSerialPortArgument());
         emit argumentChanged();
     }
 }
@@ -1376,11 +1660,12 @@ void DeviceTab::on_SP_baudRateBox_currentIndexChanged(int index)
 void DeviceTab::on_SP_dataBitsBox_currentIndexChanged(int index)
 {
     Q_UNUSED(index)
-    if(m_connection == nullptr || m_connection->type() != Connection::SerialPort || !m_connection->isConnected())
+    if(!SP_isConfigurable())
         return;
     if(m_connection->SP_setDataBits((QSerialPort::DataBits)ui->SP_dataBitsBox->currentData().toInt()))
     {
-        saveSPPreference(m_connection->getSerialPortArgument());
+        if(m_connection->type() != Connection::RFC2217_Client)
+            saveSPPreference(m_connection->getSerialPortArgument());
         emit argumentChanged();
     }
 }
@@ -1389,11 +1674,12 @@ void DeviceTab::on_SP_dataBitsBox_currentIndexChanged(int index)
 void DeviceTab::on_SP_stopBitsBox_currentIndexChanged(int index)
 {
     Q_UNUSED(index)
-    if(m_connection == nullptr || m_connection->type() != Connection::SerialPort || !m_connection->isConnected())
+    if(!SP_isConfigurable())
         return;
     if(m_connection->SP_setStopBits((QSerialPort::StopBits)ui->SP_stopBitsBox->currentData().toInt()))
     {
-        saveSPPreference(m_connection->getSerialPortArgument());
+        if(m_connection->type() != Connection::RFC2217_Client)
+            saveSPPreference(m_connection->getSerialPortArgument());
         emit argumentChanged();
     }
 }
@@ -1402,11 +1688,12 @@ void DeviceTab::on_SP_stopBitsBox_currentIndexChanged(int index)
 void DeviceTab::on_SP_parityBox_currentIndexChanged(int index)
 {
     Q_UNUSED(index)
-    if(m_connection == nullptr || m_connection->type() != Connection::SerialPort || !m_connection->isConnected())
+    if(!SP_isConfigurable())
         return;
     if(m_connection->SP_setParity((QSerialPort::Parity)ui->SP_parityBox->currentData().toInt()))
     {
-        saveSPPreference(m_connection->getSerialPortArgument());
+        if(m_connection->type() != Connection::RFC2217_Client)
+            saveSPPreference(m_connection->getSerialPortArgument());
         emit argumentChanged();
     }
 }
@@ -1415,11 +1702,12 @@ void DeviceTab::on_SP_parityBox_currentIndexChanged(int index)
 void DeviceTab::on_SP_flowControlBox_currentIndexChanged(int index)
 {
     Q_UNUSED(index)
-    if(m_connection == nullptr || m_connection->type() != Connection::SerialPort || !m_connection->isConnected())
+    if(!SP_isConfigurable())
         return;
     if(m_connection->SP_setFlowControl((QSerialPort::FlowControl)ui->SP_flowControlBox->currentData().toInt()))
     {
-        saveSPPreference(m_connection->getSerialPortArgument());
+        if(m_connection->type() != Connection::RFC2217_Client)
+            saveSPPreference(m_connection->getSerialPortArgument());
         emit argumentChanged();
     }
 }
@@ -1755,3 +2043,82 @@ void DeviceTab::setTouchScroll(bool enabled)
 
     }
 }
+
+void DeviceTab::applyBridgeArgument()
+{
+    if(m_bridge == nullptr)
+        return;
+    // the server listens on the port, the client and UDP send to the remote port
+    const Connection::Type type = (Connection::Type)ui->bridge_typeBox->currentData().toInt();
+    const quint16 port = ui->bridge_portEdit->text().toUShort();
+    Connection::NetworkArgument arg;
+    arg.localAddress = QHostAddress::Any;
+    if(type == Connection::TCP_Server)
+        arg.localPort = port;
+    else if(type == Connection::TCP_Client)
+    {
+        arg.remoteName = ui->bridge_addrEdit->text().trimmed();
+        arg.remotePort = port;
+    }
+    else if(type == Connection::UDP)
+    {
+        arg.localPort = port;
+        arg.remoteName = ui->bridge_addrEdit->text().trimmed();
+        arg.remotePort = port;
+    }
+    m_bridge->setPeerArgument(type, arg);
+    m_bridge->setEnabled(ui->bridgeBox->isChecked());
+    if(!ui->bridgeBox->isChecked())
+        ui->bridge_statisticsLabel->clear();
+}
+
+void DeviceTab::on_bridgeBox_clicked(bool checked)
+{
+    settings->beginGroup("SerialTest_Bridge");
+    settings->setValue("Enabled", checked);
+    settings->endGroup();
+    applyBridgeArgument();
+}
+
+void DeviceTab::on_bridge_typeBox_currentIndexChanged(int index)
+{
+    const Connection::Type type = (Connection::Type)ui->bridge_typeBox->itemData(index).toInt();
+    ui->bridge_addrLabel->setVisible(type != Connection::TCP_Server);
+    ui->bridge_addrEdit->setVisible(type != Connection::TCP_Server);
+    ui->bridge_portLabel->setText(type == Connection::TCP_Server ? tr("Local Port:") : tr("Port:"));
+    onBridgeArgumentEdited();
+}
+
+void DeviceTab::onBridgeArgumentEdited()
+{
+    settings->beginGroup("SerialTest_Bridge");
+    settings->setValue("Type", ui->bridge_typeBox->currentData().toInt());
+    settings->setValue("Address", ui->bridge_addrEdit->text().trimmed());
+    settings->setValue("Port", ui->bridge_portEdit->text().toUShort());
+    settings->endGroup();
+    applyBridgeArgument();
+}
+
+void DeviceTab::onBridgeStatisticsUpdated()
+{
+    QString text;
+    const QString directionName[2] = {tr("Device -> Peer"), tr("Peer -> Device")};
+    for(int i = Bridge::DeviceToPeer; i <= Bridge::PeerToDevice; i++)
+    {
+        const Bridge::Statistics statistics = m_bridge->statistics((Bridge::Direction)i);
+        const double avgLatency = statistics.chunks > 0 ? statistics.totalLatency / 1000.0 / statistics.chunks : 0;
+        text += directionName[i] + ": " + QString::number(statistics.bytes) + "B, " + QString::number(statistics.throughput, 'f', 0) + "B/s\n";
+        text += "    " + tr("Latency") + QString("(us): %1/%2/%3\n")
+                .arg(qMax<qint64>(statistics.minLatency, 0) / 1000.0, 0, 'f', 1)
+                .arg(avgLatency, 0, 'f', 1)
+                .arg(statistics.maxLatency / 1000.0, 0, 'f', 1);
+    }
+    if(m_bridge->peer()->type() == Connection::TCP_Server)
+        text += tr("Connected Clients") + ": " + QString::number(m_bridge->peer()->TCPServer_clientCount());
+    ui->bridge_statisticsLabel->setText(text.trimmed());
+}
+
+void DeviceTab::onBridgePeerFailed(const QString& info)
+{
+    QMessageBox::warning(this, tr("Error"), tr("Cannot start the bridge.") + "\n" + info);
+}
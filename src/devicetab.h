@@ -10,6 +10,7 @@
 
 #include "mysettings.h"
 #include "connection.h"
+#include "bridge.h"
 
 namespace Ui
 {
@@ -46,6 +47,7 @@ public:
 
     void initSettings();
     void setConnection(Connection* conn);
+    void setBridge(Bridge* bridge);
 public slots:
     void refreshTargetList();
     void saveTCPClientPreference(const Connection::NetworkArgument &arg);
@@ -64,6 +66,7 @@ private:
 
     MySettings* settings;
     Connection* m_connection = nullptr;
+    Bridge* m_bridge = nullptr;
 
     QIntValidator* m_netPortValidator;
 
@@ -108,6 +111,9 @@ private:
     bool SP_hasDuplicateID(int rowInList);
     bool SP_hasDuplicateID(const SP_ID& spid);
     int SP_getMatchedHistoryIndex(int rowInList);
+    Connection::SerialPortArgument SP_argumentFromUI();
+    bool SP_isConfigurable();
+    void applyBridgeArgument();
 signals:
     void connTypeChanged(Connection::Type type);
     void argumentChanged();
@@ -136,6 +142,11 @@ private slots:
     void BLEC_onServiceDetailDiscovered(QLowEnergyService::ServiceState newState);
     void on_BTServer_deviceList_cellChanged(int row, int column);
     void on_Net_addrPortList_cellChanged(int row, int column);
+    void on_bridgeBox_clicked(bool checked);
+    void on_bridge_typeBox_currentIndexChanged(int index);
+    void onBridgeArgumentEdited();
+    void onBridgeStatisticsUpdated();
+    void onBridgePeerFailed(const QString& info);
     void on_BLEC_ServiceUUIDBox_currentTextChanged(const QString &arg1);
     void on_BTClient_serviceUUIDBox_clicked();
 };
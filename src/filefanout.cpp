@@ -0,0 +1,209 @@
+#include "filefanout.h"
+
+#include <QDebug>
+#include <QHostAddress>
+
+FileFanout::FileFanout(QObject *parent)
+    : QObject{parent}
+{
+
+}
+
+FileFanout::~FileFanout()
+{
+    stop();
+}
+
+bool FileFanout::start(const QString& filename, const QList<QTcpSocket*>& clients)
+{
+    stop();
+    if(clients.isEmpty())
+        return false;
+    m_file.setFileName(filename);
+    if(!m_file.open(QFile::ReadOnly))
+        return false;
+    m_size = m_file.size();
+    // one buffer for all clients
+    m_data = reinterpret_cast<const char*>(m_file.map(0, m_size));
+    if(m_data == nullptr)
+    {
+        qDebug() << "FileFanout: cannot map" << filename << m_file.errorString();
+        m_fileBuffer = m_file.readAll();
+        if(m_fileBuffer.size() != m_size)
+        {
+            releaseFile();
+            return false;
+        }
+        m_data = m_fileBuffer.constData();
+    }
+
+    m_isRunning = true;
+    for(QTcpSocket* socket : clients)
+    {
+        Session* session = new Session;
+        session->socket = socket;
+        session->name = socket->peerAddress().toString() + ":" + QString::number(socket->peerPort());
+        session->retryTimer = new QTimer(this);
+        session->retryTimer->setSingleShot(true);
+        m_sessions.append(session);
+
+        connect(session->retryTimer, &QTimer::timeout, this, [ = ]()
+        {
+            if(session->state != Retrying)
+                return;
+            session->state = Sending;
+            pump(session);
+        });
+        connect(socket, &QTcpSocket::bytesWritten, this, [ = ](qint64 bytes)
+        {
+            emit dataTransmitted(bytes);
+            pump(session);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [ = ]()
+        {
+            finishSession(session, Failed, tr("Disconnected"));
+        });
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+        connect(socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error), this, [ = ](QAbstractSocket::SocketError error)
+#else
+        connect(socket, &QAbstractSocket::errorOccurred, this, [ = ](QAbstractSocket::SocketError error)
+#endif
+        {
+            onSocketError(session, error);
+        });
+    }
+    // start in the next event loop, a session might finish immediately and finished() should be emitted after start() returns
+    QTimer::singleShot(0, this, [ = ]()
+    {
+        for(int i = 0; i < m_sessions.size() && m_isRunning; i++)
+            pump(m_sessions[i]);
+    });
+    return true;
+}
+
+void FileFanout::stop()
+{
+    for(Session* session : qAsConst(m_sessions))
+    {
+        if(!session->socket.isNull())
+            disconnect(session->socket, nullptr, this, nullptr);
+        // a pending timeout() must not reach the deleted session
+        session->retryTimer->stop();
+        disconnect(session->retryTimer, nullptr, this, nullptr);
+        // stop() might be called in the timeout() of the timer
+        session->retryTimer->deleteLater();
+        delete session;
+    }
+    m_sessions.clear();
+    m_isRunning = false;
+    releaseFile();
+}
+
+bool FileFanout::isRunning() const
+{
+    return m_isRunning;
+}
+
+void FileFanout::setArgument(const Argument& arg)
+{
+    m_argument = arg;
+    if(m_argument.windowSize <= 0)
+        m_argument.windowSize = Argument().windowSize;
+    if(m_argument.chunkSize <= 0)
+        m_argument.chunkSize = Argument().chunkSize;
+}
+
+qint64 FileFanout::fileSize() const
+{
+    return m_size;
+}
+
+void FileFanout::pump(Session* session)
+{
+    if(session->state != Sending && session->state != Draining)
+        return;
+    QTcpSocket* socket = session->socket;
+    if(socket == nullptr || socket->state() != QAbstractSocket::ConnectedState)
+    {
+        finishSession(session, Failed, tr("Disconnected"));
+        return;
+    }
+    while(session->offset < m_size)
+    {
+        // the socket copies the data into its own buffer, the window limits the memory used by each client
+        const qint64 room = m_argument.windowSize - socket->bytesToWrite();
+        if(room <= 0)
+            break;
+        const qint64 len = qMin(qMin(room, m_argument.chunkSize), m_size - session->offset);
+        const qint64 written = socket->write(m_data + session->offset, len);
+        if(written < 0)
+        {
+            retry(session, socket->errorString());
+            return;
+        }
+        else if(written == 0)
+            break;
+        session->offset += written;
+        // a successful write resets the retry counter
+        session->retryCount = 0;
+    }
+    if(session->offset >= m_size)
+    {
+        session->state = Draining;
+        if(socket->bytesToWrite() == 0)
+            finishSession(session, Finished);
+    }
+}
+
+void FileFanout::retry(Session* session, const QString& reason)
+{
+    if(session->retryCount >= m_argument.maxRetry)
+    {
+        finishSession(session, Failed, reason);
+        return;
+    }
+    session->retryCount++;
+    session->state = Retrying;
+    qDebug() << "FileFanout: retry" << session->name << session->retryCount << reason;
+    session->retryTimer->start(m_argument.retryInterval);
+}
+
+void FileFanout::onSocketError(Session* session, QAbstractSocket::SocketError error)
+{
+    if(error == QAbstractSocket::TemporaryError || error == QAbstractSocket::SocketResourceError)
+        retry(session, session->socket.isNull() ? QString() : session->socket->errorString());
+    else
+        finishSession(session, Failed, session->socket.isNull() ? QString() : session->socket->errorString());
+}
+
+void FileFanout::finishSession(Session* session, SessionState state, const QString& info)
+{
+    if(session->state == Finished || session->state == Failed)
+        return;
+    session->state = state;
+    session->retryTimer->stop();
+    if(!session->socket.isNull())
+        disconnect(session->socket, nullptr, this, nullptr);
+    emit clientFinished(session->name, state == Finished, info);
+
+    for(const Session* s : qAsConst(m_sessions))
+    {
+        if(s->state != Finished && s->state != Failed)
+            return;
+    }
+    m_isRunning = false;
+    releaseFile();
+    emit finished();
+}
+
+void FileFanout::releaseFile()
+{
+    if(m_file.isOpen())
+    {
+        if(m_fileBuffer.isNull() && m_data != nullptr)
+            m_file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(m_data)));
+        m_file.close();
+    }
+    m_fileBuffer.clear();
+    m_data = nullptr;
+}
@@ -0,0 +1,76 @@
+#ifndef FILEFANOUT_H
+#define FILEFANOUT_H
+
+#include <QObject>
+#include <QFile>
+#include <QTcpSocket>
+#include <QPointer>
+#include <QTimer>
+
+// Push one file to several TCP clients concurrently, for TCP_Server mode.
+// Each client has its own session(state, offset, window and retry counter) driven by bytesWritten(),
+// all sessions read from one shared mapped file buffer, so a slow client only stalls itself.
+// The client sockets are owned by Connection, so this object must live in the main thread.
+class FileFanout : public QObject
+{
+    Q_OBJECT
+public:
+    enum SessionState
+    {
+        Sending = 0,
+        Retrying,
+        Draining, // all data is queued, waiting for the socket to flush it
+        Finished,
+        Failed,
+    };
+
+    struct Argument
+    {
+        // max bytes queued in one socket
+        qint64 windowSize = 262144;
+        qint64 chunkSize = 65536;
+        int maxRetry = 3;
+        int retryInterval = 500; // ms
+    };
+
+    explicit FileFanout(QObject *parent = nullptr);
+    ~FileFanout();
+
+    bool start(const QString& filename, const QList<QTcpSocket*>& clients);
+    void stop();
+    bool isRunning() const;
+    void setArgument(const Argument& arg);
+    qint64 fileSize() const;
+signals:
+    // sum of all clients
+    void dataTransmitted(qint64 num);
+    void clientFinished(const QString& client, bool succeeded, const QString& info);
+    // all sessions are finished or failed
+    void finished();
+private:
+    struct Session
+    {
+        QPointer<QTcpSocket> socket;
+        QString name;
+        SessionState state = Sending;
+        qint64 offset = 0;
+        int retryCount = 0;
+        QTimer* retryTimer = nullptr;
+    };
+
+    QFile m_file;
+    QByteArray m_fileBuffer; // used if the file cannot be mapped
+    const char* m_data = nullptr;
+    qint64 m_size = 0;
+    QList<Session*> m_sessions;
+    Argument m_argument;
+    bool m_isRunning = false;
+
+    void pump(Session* session);
+    void retry(Session* session, const QString& reason);
+    void finishSession(Session* session, SessionState state, const QString& info = QString());
+    void onSocketError(Session* session, QAbstractSocket::SocketError error);
+    void releaseFile();
+};
+
+#endif // FILEFANOUT_H
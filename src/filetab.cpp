@@ -21,6 +21,7 @@ FileTab::FileTab(QWidget *parent) :
     m_checksumCalc = new AsyncCRC();
     m_fileXceiverThread = new QThread(this);
     m_fileXceiver = new FileXceiver();
+    m_fileFanout = new FileFanout(this);
     m_intValidator = new QIntValidator(this);
     m_intValidator->setBottom(0);
 
@@ -40,6 +41,10 @@ FileTab::FileTab(QWidget *parent) :
     connect(m_fileXceiverThread, &QThread::finished, m_fileXceiver, &QObject::deleteLater);
     m_fileXceiverThread->start();
 
+    connect(m_fileFanout, &FileFanout::dataTransmitted, this, &FileTab::onDataTransmitted);
+    connect(m_fileFanout, &FileFanout::clientFinished, this, &FileTab::onFanoutClientFinished);
+    connect(m_fileFanout, &FileFanout::finished, this, &FileTab::onFinished);
+
     m_currInstance = this;
 
 #ifdef Q_OS_ANDROID
@@ -60,12 +65,14 @@ FileTab::FileTab(QWidget *parent) :
     ui->RawTx_throttleByteBox->setValidator(m_intValidator);
     ui->RawTx_throttleMsBox->setValidator(m_intValidator);
     ui->RawTx_throttleWaitMsBox->setValidator(m_intValidator);
+    ui->RawTx_fanoutWindowBox->setValidator(m_intValidator);
     ui->RawRx_autostopByteBox->setValidator(m_intValidator);
 
     on_tipsBackButton_clicked();
 
     connect(ui->protoBox, &QComboBox::currentTextChanged, this, &FileTab::onModeProtocolChanged);
     connect(ui->sendModeButton, &QRadioButton::toggled, this, &FileTab::onModeProtocolChanged); // just set one of them, the slot will be called when setChecked() is called
+    connect(ui->RawTx_fanoutBox, &QCheckBox::toggled, ui->RawTx_fanoutWindowBox, &QComboBox::setEnabled);
 
 
 
@@ -99,6 +106,8 @@ void FileTab::initSettings()
     connect(ui->RawTx_throttleByteBox, &QComboBox::currentTextChanged, this, &FileTab::saveFilePreference);
     connect(ui->RawTx_throttleMsBox, &QComboBox::currentTextChanged, this, &FileTab::saveFilePreference);
     connect(ui->RawTx_throttleWaitMsBox, &QComboBox::currentTextChanged, this, &FileTab::saveFilePreference);
+    connect(ui->RawTx_fanoutBox, &QCheckBox::clicked, this, &FileTab::saveFilePreference);
+    connect(ui->RawTx_fanoutWindowBox, &QComboBox::currentTextChanged, this, &FileTab::saveFilePreference);
 
     connect(ui->RawRx_autostopNoneButton, &QRadioButton::clicked, this, &FileTab::saveFilePreference);
     connect(ui->RawRx_autostopByteButton, &QRadioButton::clicked, this, &FileTab::saveFilePreference);
@@ -112,6 +121,11 @@ FileXceiver *FileTab::fileXceiver()
     return m_fileXceiver;
 }
 
+void FileTab::setConnection(Connection* conn)
+{
+    m_connection = conn;
+}
+
 void FileTab::on_fileBrowseButton_clicked()
 {
     QString fileName;
@@ -232,7 +246,11 @@ void FileTab::on_startStopButton_clicked()
         QMetaObject::invokeMethod(m_fileXceiver, "setProtocol", Qt::QueuedConnection, Q_ARG(FileXceiver::Protocol, currentProtocol()));
         updateFileSize();
 
-        if(ui->sendModeButton->isChecked())
+        if(ui->sendModeButton->isChecked() && currentProtocol() == FileXceiver::RawProtocol && ui->RawTx_fanoutBox->isChecked())
+        {
+            startFanout();
+        }
+        else if(ui->sendModeButton->isChecked())
         {
             if(currentProtocol() == FileXceiver::RawProtocol)
             {
@@ -263,6 +281,42 @@ void FileTab::on_startStopButton_clicked()
     }
 }
 
+void FileTab::startFanout()
+{
+    // the sessions write to the client sockets directly, bypassing Connection::write()
+    if(m_connection == nullptr || m_connection->type() != Connection::TCP_Server || !m_connection->isConnected())
+    {
+        showMessage(tr("Fan-out is only available when some clients are connected to the TCP server."));
+        return;
+    }
+    QList<QTcpSocket*> clients = m_connection->TCPServer_TxClientList();
+    if(clients.isEmpty())
+    {
+        showMessage(tr("The Tx of all clients are disabled."));
+        return;
+    }
+
+    FileFanout::Argument arg;
+    arg.windowSize = ui->RawTx_fanoutWindowBox->currentText().toLongLong();
+    m_fileFanout->setArgument(arg);
+    bool result = m_fileFanout->start(ui->filePathEdit->text(), clients);
+    if(result)
+    {
+        m_fileSize = m_fileFanout->fileSize() * clients.size();
+        ui->sizeLabel->setText(QLocale(QLocale::English).toString(m_handledSize) + "/" + QLocale(QLocale::English).toString(m_fileSize) + " Bytes");
+        showMessage(tr("Pushing to %1 client(s)").arg(clients.size()));
+    }
+    onStartResultArrived(result);
+}
+
+void FileTab::onFanoutClientFinished(const QString& client, bool succeeded, const QString& info)
+{
+    if(succeeded)
+        showMessage(client + " " + tr("Finished"));
+    else
+        showMessage(client + " " + tr("Failed") + (info.isEmpty() ? "" : ": " + info));
+}
+
 void FileTab::onDataTransmitted(qint64 num)
 {
     m_handledSize += num;
@@ -323,6 +377,7 @@ void FileTab::stop()
 {
     m_working = false;
     QMetaObject::invokeMethod(m_fileXceiver, "stop", Qt::QueuedConnection);
+    m_fileFanout->stop();
     ui->startStopButton->setText(tr("Start"));
     setParameterWidgetEnabled(true);
     ui->progressBar->setMaximum(100); // for Raw receive
@@ -413,6 +468,9 @@ void FileTab::loadPreference()
     ui->RawTx_throttleByteBox->setCurrentText(m_settings->value("RawTx_throttleByteNum", "1048576").toString());
     ui->RawTx_throttleMsBox->setCurrentText(m_settings->value("RawTx_throttleTimeMs", "0").toString());
     ui->RawTx_throttleWaitMsBox->setCurrentText(m_settings->value("RawTx_throttleWaitMs", "20").toString());
+    ui->RawTx_fanoutBox->setChecked(m_settings->value("RawTx_fanoutEnabled", false).toBool());
+    ui->RawTx_fanoutWindowBox->setCurrentText(m_settings->value("RawTx_fanoutWindow", "262144").toString());
+    ui->RawTx_fanoutWindowBox->setEnabled(ui->RawTx_fanoutBox->isChecked());
 
     ui->RawRx_autostopNoneButton->setChecked(!(m_settings->value("RawTx_autostopEnabled", false).toBool()));
     ui->RawRx_autostopByteButton->setChecked(m_settings->value("RawTx_autostopEnabled", false).toBool());
@@ -440,6 +498,8 @@ void FileTab::saveFilePreference()
     m_settings->setValue("RawTx_throttleByteNum", ui->RawTx_throttleByteBox->currentText());
     m_settings->setValue("RawTx_throttleTimeMs", ui->RawTx_throttleMsBox->currentText());
     m_settings->setValue("RawTx_throttleWaitMs", ui->RawTx_throttleWaitMsBox->currentText());
+    m_settings->setValue("RawTx_fanoutEnabled", ui->RawTx_fanoutBox->isChecked());
+    m_settings->setValue("RawTx_fanoutWindow", ui->RawTx_fanoutWindowBox->currentText());
 
     m_settings->setValue("RawTx_autostopEnabled", ui->RawRx_autostopByteButton->isChecked());
     m_settings->setValue("RawTx_autostopByteNum", ui->RawRx_autostopByteBox->currentText());
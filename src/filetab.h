@@ -13,6 +13,8 @@
 
 #include "asynccrc.h"
 #include "filexceiver.h"
+#include "filefanout.h"
+#include "connection.h"
 #include "mysettings.h"
 
 namespace Ui
@@ -30,6 +32,7 @@ public:
 
     void initSettings();
     FileXceiver* fileXceiver();
+    void setConnection(Connection* conn);
     bool receiving();
 public slots:
     void onChecksumUpdated(quint64 checksum);
@@ -38,6 +41,7 @@ public slots:
     void onDataReceived(qint64 num);
     void onFinished();
     void onStartResultArrived(bool result);
+    void onFanoutClientFinished(const QString& client, bool succeeded, const QString& info);
     void stop();
 protected:
     void dragEnterEvent(QDragEnterEvent *event) override;
@@ -71,6 +75,8 @@ private:
     AsyncCRC* m_checksumCalc = nullptr;
     QThread* m_fileXceiverThread = nullptr;
     FileXceiver* m_fileXceiver = nullptr;
+    FileFanout* m_fileFanout = nullptr;
+    Connection* m_connection = nullptr;
     bool m_working = false;
     static FileTab* m_currInstance;
     MySettings *m_settings;
@@ -80,6 +86,7 @@ private:
     void onFilePathSet(const QString &path);
     void updateFileSize();
     void setParameterWidgetEnabled(bool state);
+    void startFanout();
 
 #ifdef Q_OS_ANDROID
     static void onSharedFileReceived(JNIEnv *env, jobject thiz, jstring text);
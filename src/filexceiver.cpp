@@ -78,6 +78,11 @@ void FileXceiver::setAutostop(qint64 num)
     m_expectedNum = num;
 }
 
+void FileXceiver::setTxScheduler(const TxScheduler* scheduler)
+{
+    m_TxScheduler = scheduler;
+}
+
 void FileXceiver::newData(const QByteArray &data)
 {
     if(!m_isRunning)
@@ -112,6 +117,12 @@ void FileXceiver::RawTransmitProgress()
         // emit signal?
         return;
     }
+    // the paced data is sent slowly, don't queue the whole file
+    if(m_TxScheduler != nullptr && m_TxScheduler->pendingBytes() > m_batchSize)
+    {
+        QTimer::singleShot(1, this, &FileXceiver::RawTransmitProgress);
+        return;
+    }
     QByteArray buf = m_file.read(m_batchSize);
     m_handledNum += buf.length();
     emit send(buf);
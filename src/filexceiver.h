@@ -7,6 +7,7 @@
 #include <QThread>
 
 #include "asynccrc.h"
+#include "txscheduler.h"
 
 class FileXceiver : public QObject
 {
@@ -37,6 +38,7 @@ public:
     Q_INVOKABLE void setProtocol(FileXceiver::Protocol p);
     Q_INVOKABLE void setThrottleArgument(FileXceiver::ThrottleArgument arg);
     Q_INVOKABLE void setAutostop(qint64 num);
+    void setTxScheduler(const TxScheduler* scheduler);
 
 public slots:
     void newData(const QByteArray& data);
@@ -52,6 +54,7 @@ protected:
     Protocol m_protocol = RawProtocol;
     ThrottleArgument m_throttleArgument;
     AsyncCRC* m_protocolChecksum;
+    const TxScheduler* m_TxScheduler = nullptr;
     QThread* m_protocolChecksumThread;
 
     void RawTransmitProgress();
@@ -0,0 +1,176 @@
+#include "hexformatter.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEXFORMATTER_SSE2
+#include <emmintrin.h>
+#endif
+
+static const char hexDigits[] = "0123456789abcdef";
+
+// 2 digits, a space and a placeholder for every byte, the placeholder is overwritten by the next byte
+struct HexTable
+{
+    HexTable()
+    {
+        for(int i = 0; i < 256; i++)
+        {
+            entry[i][0] = hexDigits[i >> 4];
+            entry[i][1] = hexDigits[i & 0xF];
+            entry[i][2] = ' ';
+            entry[i][3] = 0;
+        }
+    }
+    ushort entry[256][4];
+};
+static const HexTable hexTable;
+
+QString HexFormatter::row(const char* data, int len, qint64 offset, int bytesPerRow, int flags)
+{
+    QString result(rowLength(qMax(len, bytesPerRow), flags), Qt::Uninitialized);
+    ushort* begin = reinterpret_cast<ushort*>(result.data());
+    ushort* end = writeRow(begin, reinterpret_cast<const uchar*>(data), len, offset, bytesPerRow, flags);
+    result.resize(end - begin);
+    return result;
+}
+
+QString HexFormatter::dump(const char* data, qint64 len, qint64 offset, int bytesPerRow, int flags)
+{
+    const qint64 rowNum = (len + bytesPerRow - 1) / bytesPerRow;
+    QString result(rowNum * (rowLength(bytesPerRow, flags) + 1), Qt::Uninitialized);
+    ushort* begin = reinterpret_cast<ushort*>(result.data());
+    ushort* dst = begin;
+    const uchar* src = reinterpret_cast<const uchar*>(data);
+    for(qint64 pos = 0; pos < len; pos += bytesPerRow)
+    {
+        if(pos > 0)
+            *dst++ = '\n';
+        dst = writeRow(dst, src + pos, qMin((qint64)bytesPerRow, len - pos), offset + pos, bytesPerRow, flags);
+    }
+    result.resize(dst - begin);
+    return result;
+}
+
+QString HexFormatter::hex(const char* data, qint64 len)
+{
+    if(len > m_maxHexLen)
+        len = m_maxHexLen;
+    QString result(len * 3 + 1, Qt::Uninitialized);
+    ushort* begin = reinterpret_cast<ushort*>(result.data());
+    ushort* end = writeHex(begin, reinterpret_cast<const uchar*>(data), len);
+    // without the last space
+    result.resize(qMax(end - begin - 1, (ptrdiff_t)0));
+    return result;
+}
+
+int HexFormatter::rowLength(int bytesPerRow, int flags)
+{
+    // offset(up to 16 digits) + 2 spaces + "xx " for every byte + 1 space + ASCII + 1 placeholder
+    int result = bytesPerRow * 3 + 1;
+    if(flags & Offset)
+        result += 16 + 2;
+    if(flags & ASCII)
+        result += 1 + bytesPerRow;
+    return result;
+}
+
+ushort* HexFormatter::writeRow(ushort* dst, const uchar* data, int len, qint64 offset, int bytesPerRow, int flags)
+{
+    if(flags & Offset)
+    {
+        dst = writeOffset(dst, offset);
+        *dst++ = ' ';
+        *dst++ = ' ';
+    }
+    ushort* hexEnd = writeHex(dst, data, len);
+    if(flags & ASCII)
+    {
+        // pad the hex part, so the ASCII part is aligned
+        ushort* ASCIIBegin = dst + bytesPerRow * 3 + 1;
+        while(hexEnd < ASCIIBegin)
+            *hexEnd++ = ' ';
+        return writeASCII(ASCIIBegin, data, len);
+    }
+    // without the last space
+    return (len > 0) ? hexEnd - 1 : hexEnd;
+}
+
+ushort* HexFormatter::writeOffset(ushort* dst, qint64 offset)
+{
+    int digitNum = m_offsetLen;
+    while(digitNum < 16 && ((quint64)offset >> (digitNum * 4)) != 0)
+        digitNum++;
+    for(int i = digitNum - 1; i >= 0; i--)
+        *dst++ = hexDigits[((quint64)offset >> (i * 4)) & 0xF];
+    return dst;
+}
+
+ushort* HexFormatter::writeHex(ushort* dst, const uchar* data, qint64 len)
+{
+    qint64 i = 0;
+#ifdef HEXFORMATTER_SSE2
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i digitBase = _mm_set1_epi8('0');
+    const __m128i letterDelta = _mm_set1_epi8('a' - '0' - 10);
+    const __m128i zero = _mm_setzero_si128();
+    // ' ' and the placeholder as UTF-16
+    const __m128i space = _mm_set1_epi32(' ');
+    for(; i + 16 <= len; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibbleMask);
+        __m128i lo = _mm_and_si128(v, nibbleMask);
+        hi = _mm_add_epi8(_mm_add_epi8(hi, digitBase), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), letterDelta));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, digitBase), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), letterDelta));
+        const __m128i pairs[2] = {_mm_unpacklo_epi8(hi, lo), _mm_unpackhi_epi8(hi, lo)};
+        for(int j = 0; j < 2; j++)
+        {
+            // widen to UTF-16, 4 bytes in every register
+            const __m128i chars[2] = {_mm_unpacklo_epi8(pairs[j], zero), _mm_unpackhi_epi8(pairs[j], zero)};
+            for(int k = 0; k < 2; k++)
+            {
+                // 2 digits + space + placeholder for every byte, the stores overlap by 1 char
+                const __m128i a = _mm_unpacklo_epi32(chars[k], space);
+                const __m128i b = _mm_unpackhi_epi32(chars[k], space);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), a);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 3), _mm_srli_si128(a, 8));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 6), b);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 9), _mm_srli_si128(b, 8));
+                dst += 12;
+            }
+        }
+    }
+#endif
+    for(; i < len; i++)
+    {
+        memcpy(dst, hexTable.entry[data[i]], sizeof(hexTable.entry[0]));
+        dst += 3;
+    }
+    return dst;
+}
+
+ushort* HexFormatter::writeASCII(ushort* dst, const uchar* data, qint64 len)
+{
+    qint64 i = 0;
+#ifdef HEXFORMATTER_SSE2
+    const __m128i low = _mm_set1_epi8(0x1F);
+    const __m128i high = _mm_set1_epi8(0x7F);
+    const __m128i dot = _mm_set1_epi8('.');
+    const __m128i zero = _mm_setzero_si128();
+    for(; i + 16 <= len; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // signed comparison, the bytes >= 0x80 are negative
+        const __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(v, low), _mm_cmplt_epi8(v, high));
+        const __m128i chars = _mm_or_si128(_mm_and_si128(printable, v), _mm_andnot_si128(printable, dot));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(chars, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), _mm_unpackhi_epi8(chars, zero));
+        dst += 16;
+    }
+#endif
+    for(; i < len; i++)
+        *dst++ = (data[i] >= 0x20 && data[i] < 0x7F) ? data[i] : '.';
+    return dst;
+}
@@ -0,0 +1,39 @@
+#ifndef HEXFORMATTER_H
+#define HEXFORMATTER_H
+
+#include <QString>
+
+// Formats bytes as a hex dump row, written to the UTF-16 buffer of QString directly:
+// 00000010  48 65 6c 6c 6f 0d 0a                                Hello..
+// SSE2 is used on x86 if it's available at compile time, otherwise a table based scalar version is used.
+class HexFormatter
+{
+public:
+    enum Flag
+    {
+        NoFlag = 0,
+        Offset = 1,
+        ASCII = 2,
+    };
+
+    // len <= bytesPerRow, the hex part is padded to bytesPerRow bytes if ASCII is set
+    static QString row(const char* data, int len, qint64 offset, int bytesPerRow, int flags);
+    // rows separated by '\n', the offsets start from offset
+    static QString dump(const char* data, qint64 len, qint64 offset, int bytesPerRow, int flags);
+    // "xx xx xx", same as QByteArray::toHex(' '), at most m_maxHexLen bytes are formatted
+    static QString hex(const char* data, qint64 len);
+
+    // 3 chars for every byte, fits in a QString
+    static const qint64 m_maxHexLen = 256 * 1024 * 1024;
+private:
+    static const int m_offsetLen = 8;
+
+    static int rowLength(int bytesPerRow, int flags);
+    // writes "xx " for every byte and 1 extra char after the last "xx ", returns the end of "xx xx ... xx "
+    static ushort* writeHex(ushort* dst, const uchar* data, qint64 len);
+    static ushort* writeASCII(ushort* dst, const uchar* data, qint64 len);
+    static ushort* writeOffset(ushort* dst, qint64 offset);
+    static ushort* writeRow(ushort* dst, const uchar* data, int len, qint64 offset, int bytesPerRow, int flags);
+};
+
+#endif // HEXFORMATTER_H
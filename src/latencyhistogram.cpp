@@ -0,0 +1,80 @@
+#include "latencyhistogram.h"
+
+#include <QtAlgorithms>
+#include <cmath>
+
+void LatencyHistogram::record(qint64 value)
+{
+    value = qMax(value, 0LL);
+    const int bucket = bucketOf(value);
+    if(bucket >= m_counts.size())
+        m_counts.resize(bucket + 1);
+    m_counts[bucket]++;
+    m_min = (m_count == 0) ? value : qMin(m_min, value);
+    m_max = (m_count == 0) ? value : qMax(m_max, value);
+    m_sum += value;
+    m_count++;
+}
+
+void LatencyHistogram::clear()
+{
+    m_counts.clear();
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+    m_sum = 0;
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return m_count;
+}
+
+qint64 LatencyHistogram::min() const
+{
+    return m_min;
+}
+
+qint64 LatencyHistogram::max() const
+{
+    return m_max;
+}
+
+double LatencyHistogram::mean() const
+{
+    return (m_count == 0) ? 0 : m_sum / m_count;
+}
+
+qint64 LatencyHistogram::percentile(double p) const
+{
+    if(m_count == 0)
+        return 0;
+    const quint64 target = qMax((quint64)std::ceil(qBound(0.0, p, 100.0) / 100 * m_count), 1ULL);
+    quint64 count = 0;
+    for(int i = 0; i < m_counts.size(); i++)
+    {
+        count += m_counts[i];
+        if(count >= target)
+            return qMin(highestValueOf(i), m_max);
+    }
+    return m_max;
+}
+
+int LatencyHistogram::bucketOf(qint64 value)
+{
+    if(value < m_subBucketNum)
+        return value;
+    // value >> shift is in [m_subBucketNum / 2, m_subBucketNum)
+    const int shift = 63 - qCountLeadingZeroBits((quint64)value) - (m_subBucketBits - 1);
+    const int top = value >> shift;
+    return m_subBucketNum + (shift - 1) * (m_subBucketNum / 2) + (top - m_subBucketNum / 2);
+}
+
+qint64 LatencyHistogram::highestValueOf(int bucket)
+{
+    if(bucket < m_subBucketNum)
+        return bucket;
+    const int shift = (bucket - m_subBucketNum) / (m_subBucketNum / 2) + 1;
+    const qint64 top = (bucket - m_subBucketNum) % (m_subBucketNum / 2) + m_subBucketNum / 2;
+    return ((top + 1) << shift) - 1;
+}
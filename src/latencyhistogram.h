@@ -0,0 +1,34 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QVector>
+
+// Records the latencies in us with a bounded relative error, like HdrHistogram.
+// The values below m_subBucketNum are exact, the larger ones are counted in m_subBucketNum / 2 linear buckets
+// per power of 2, so the error is less than 2 / m_subBucketNum (1.6%) and the memory grows with log(max).
+class LatencyHistogram
+{
+public:
+    static const int m_subBucketBits = 7;
+    static const int m_subBucketNum = 1 << m_subBucketBits;
+
+    void record(qint64 value);
+    void clear();
+    quint64 count() const;
+    qint64 min() const;
+    qint64 max() const;
+    double mean() const;
+    // p: 0~100, the highest value in the bucket of the percentile, 0 if empty
+    qint64 percentile(double p) const;
+private:
+    QVector<quint64> m_counts;
+    quint64 m_count = 0;
+    qint64 m_min = 0;
+    qint64 m_max = 0;
+    double m_sum = 0;
+
+    static int bucketOf(qint64 value);
+    static qint64 highestValueOf(int bucket);
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,68 @@
+#include "lineindex.h"
+
+#include <algorithm>
+#include <cstring>
+
+LineIndex::LineIndex()
+{
+    m_checkpoints.append(0);
+}
+
+void LineIndex::clear()
+{
+    m_checkpoints.clear();
+    m_checkpoints.append(0);
+    m_newLineNum = 0;
+    m_scannedSize = 0;
+}
+
+void LineIndex::update(const QByteArray& data)
+{
+    // cleared
+    if(data.size() < m_scannedSize)
+        clear();
+    const char* begin = data.constData();
+    const char* end = begin + data.size();
+    const char* p = begin + m_scannedSize;
+    while((p = (const char*)memchr(p, '\n', end - p)) != nullptr)
+    {
+        p++;
+        m_newLineNum++;
+        if(m_newLineNum % m_interval == 0)
+            m_checkpoints.append(p - begin);
+    }
+    m_scannedSize = data.size();
+}
+
+qint64 LineIndex::lineCount() const
+{
+    return m_newLineNum + 1;
+}
+
+qint64 LineIndex::lineBegin(const QByteArray& data, qint64 line) const
+{
+    if(line < 0 || line > m_newLineNum)
+        return -1;
+    const char* begin = data.constData();
+    const char* p = begin + m_checkpoints[line / m_interval];
+    for(qint64 i = line % m_interval; i > 0; i--)
+        p = (const char*)memchr(p, '\n', m_scannedSize - (p - begin)) + 1;
+    return p - begin;
+}
+
+qint64 LineIndex::lineOf(const QByteArray& data, qint64 pos) const
+{
+    if(pos < 0 || pos >= m_scannedSize)
+        return -1;
+    // the last checkpoint at or before pos
+    const int id = std::upper_bound(m_checkpoints.cbegin(), m_checkpoints.cend(), pos) - m_checkpoints.cbegin() - 1;
+    const char* begin = data.constData();
+    const char* p = begin + m_checkpoints[id];
+    qint64 result = (qint64)id * m_interval;
+    while((p = (const char*)memchr(p, '\n', pos - (p - begin))) != nullptr)
+    {
+        p++;
+        result++;
+    }
+    return result;
+}
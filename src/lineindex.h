@@ -0,0 +1,30 @@
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+#include <QByteArray>
+#include <QVector>
+
+// A sparse index of the line starts in the received data, updated incrementally when new data arrives.
+// Only the start of every m_interval-th line is stored, the lines between two checkpoints are found by memchr().
+// Line numbers start from 0, the text after the last '\n' is the last line.
+class LineIndex
+{
+public:
+    static const int m_interval = 1024;
+
+    LineIndex();
+
+    void clear();
+    // scans the data appended since the last call, the index is cleared if the data is cleared
+    void update(const QByteArray& data);
+    qint64 lineCount() const;
+    // the data must be the one passed to update()
+    qint64 lineBegin(const QByteArray& data, qint64 line) const;
+    qint64 lineOf(const QByteArray& data, qint64 pos) const;
+private:
+    QVector<qint64> m_checkpoints; // the start of line i * m_interval
+    qint64 m_newLineNum = 0;
+    qint64 m_scannedSize = 0;
+};
+
+#endif // LINEINDEX_H
@@ -2,6 +2,7 @@
 #include "ui_mainwindow.h"
 #include "util.h"
 #include "filexceiver.h"
+#include "metrics.h"
 
 #include <QDateTime>
 #include <QBluetoothLocalDevice>
@@ -12,6 +13,7 @@
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , m_timeline(&RxMetadata, &TxMetadata)
 {
     ui->setupUi(this);
     // might not be empty(specified by -stylesheet option)
@@ -21,6 +23,8 @@ MainWindow::MainWindow(QWidget *parent)
     IOConnection = new Connection();
     connect(IOConnection, &Connection::connected, this, &MainWindow::onIODeviceConnected);
     connect(IOConnection, &Connection::disconnected, this, &MainWindow::onIODeviceDisconnected);
+    // the scheduler thread must stop using the fd before it's closed
+    connect(IOConnection, &Connection::aboutToClose, this, &MainWindow::onIODeviceAboutToClose, Qt::DirectConnection);
     connect(IOConnection, QOverload<const QString&>::of(&Connection::connectFailed), this, QOverload<const QString&>::of(&MainWindow::onIODeviceConnectFailed));
     connect(IOConnection, QOverload<const QStringList&>::of(&Connection::connectFailed), this, QOverload<const QStringList&>::of(&MainWindow::onIODeviceConnectFailed));
     connect(IOConnection, &Connection::stateChanged, this, &MainWindow::updateStatusBar);
@@ -35,14 +39,42 @@ MainWindow::MainWindow(QWidget *parent)
     stateButton = new QPushButton();
     TxLabel = new QLabel();
     RxLabel = new QLabel();
+    RttLabel = new QLabel();
+    RttLabel->hide();
     connArgsLabel = new QLabel;
     serialPinout = new SerialPinout();
     connect(IOConnection, &Connection::SP_signalsChanged, serialPinout, &SerialPinout::setPinout);
     connect(serialPinout, &SerialPinout::enableStateChanged, IOConnection, &Connection::setPolling);
     serialPinout->initSettings();
 
+    IOBridge = new Bridge(IOConnection, this);
+    // the forwarded data is recorded as Tx data, not in the forwarding path
+    connect(IOBridge, &Bridge::peerDataForwarded, this, &MainWindow::onBridgeDataForwarded, Qt::QueuedConnection);
+
+    // all sent data goes through the scheduler if the Tx gap is set
+    m_TxSchedulerThread = new QThread(this);
+    m_TxScheduler = new TxScheduler();
+    m_TxScheduler->moveToThread(m_TxSchedulerThread);
+    connect(m_TxScheduler, &TxScheduler::writeRequested, this, &MainWindow::onTxSchedulerWriteRequested);
+    connect(m_TxScheduler, &TxScheduler::sent, this, &MainWindow::onTxSchedulerSent);
+    connect(m_TxScheduler, &TxScheduler::sentFrames, this, &MainWindow::onTxSchedulerSentFrames);
+    connect(m_TxScheduler, &TxScheduler::failed, this, &MainWindow::onTxSchedulerFailed);
+    connect(m_TxSchedulerThread, &QThread::finished, m_TxScheduler, &QObject::deleteLater);
+    m_TxSchedulerThread->start();
+
+    // optional, enabled in SettingsTab
+    m_captureIndexThread = new QThread(this);
+    m_captureIndex = new CaptureIndex();
+    m_captureIndex->moveToThread(m_captureIndexThread);
+    connect(m_captureIndexThread, &QThread::finished, m_captureIndex, &QObject::deleteLater);
+    m_captureIndexThread->start();
+    m_captureIndexTimer = new QTimer(this);
+    m_captureIndexTimer->setInterval(100);
+    connect(m_captureIndexTimer, &QTimer::timeout, this, &MainWindow::indexReceivedData);
+
     deviceTab = new DeviceTab();
     deviceTab->setConnection(IOConnection);
+    deviceTab->setBridge(IOBridge);
     connect(deviceTab, &DeviceTab::connTypeChanged, this, &MainWindow::updateStatusBar);
     connect(deviceTab, &DeviceTab::connTypeChanged, this, &MainWindow::updateWindowTitle);
     connect(deviceTab, &DeviceTab::argumentChanged, this, &MainWindow::updateStatusBar);
@@ -53,10 +85,14 @@ MainWindow::MainWindow(QWidget *parent)
     connect(IOConnection, &Connection::TCP_clientDisconnected, deviceTab, &DeviceTab::onClientCountChanged);
     ui->funcTab->insertTab(0, deviceTab, tr("Connect"));
 
-    dataTab = new DataTab(&rawReceivedData, &RxMetadata, &rawSendedData);
+    dataTab = new DataTab(&rawReceivedData, &RxMetadata, &rawSendedData, &m_timeline);
     dataTab->setConnection(IOConnection);
+    dataTab->setCaptureIndex(m_captureIndex);
     connect(deviceTab, &DeviceTab::connTypeChanged, dataTab, &DataTab::onConnTypeChanged);
     connect(dataTab, &DataTab::send, this, &MainWindow::sendData);
+    connect(dataTab, &DataTab::terminalInput, this, &MainWindow::onTerminalInput);
+    connect(dataTab, &DataTab::startRepeat, this, &MainWindow::startRepeat);
+    connect(dataTab, &DataTab::stopRepeat, this, &MainWindow::stopRepeat);
     connect(dataTab, &DataTab::updateRxTxLen, this, &MainWindow::updateRxTxLen);
     connect(dataTab, &DataTab::clearReceivedData, this, &MainWindow::clearReceivedData);
     connect(dataTab, &DataTab::clearSendedData, this, &MainWindow::clearSendedData);
@@ -72,12 +108,16 @@ MainWindow::MainWindow(QWidget *parent)
 
     ctrlTab = new CtrlTab();
     connect(ctrlTab, &CtrlTab::send, this, &MainWindow::sendData);
+    connect(ctrlTab->autoResponder(), &AutoResponder::reply, this, &MainWindow::sendData);
     connect(dataTab, &DataTab::setDataCodec, ctrlTab, &CtrlTab::setDataCodec);
     ui->funcTab->insertTab(3, ctrlTab, tr("Control"));
 
     fileTab = new FileTab();
     connect(fileTab, &FileTab::showUpTab, this, &MainWindow::showUpTab);
     connect(fileTab->fileXceiver(), &FileXceiver::send, this, &MainWindow::sendData);
+    // set before any transmission starts
+    fileTab->fileXceiver()->setTxScheduler(m_TxScheduler);
+    fileTab->setConnection(IOConnection);
     ui->funcTab->insertTab(4, fileTab, tr("File"));
 
     settingsTab = new SettingsTab();
@@ -92,10 +132,19 @@ MainWindow::MainWindow(QWidget *parent)
     connect(settingsTab, &SettingsTab::recordDataChanged, dataTab, &DataTab::onRecordDataChanged);
     connect(settingsTab, &SettingsTab::mergeTimestampChanged, this, &MainWindow::onMergeTimestampChanged);
     connect(settingsTab, &SettingsTab::timestampIntervalChanged, this, &MainWindow::onTimestampIntervalChanged);
+    connect(settingsTab, &SettingsTab::deframerChanged, this, &MainWindow::onDeframerChanged);
+    connect(settingsTab, &SettingsTab::rttChanged, this, &MainWindow::onRttChanged);
     connect(settingsTab, &SettingsTab::clearBehaviorChanged, dataTab, &DataTab::onClearBehaviorChanged);
     connect(settingsTab, &SettingsTab::clearBehaviorChanged, plotTab, &PlotTab::onClearBehaviorChanged);
+    connect(settingsTab, &SettingsTab::TxPacingChanged, m_TxScheduler, &TxScheduler::setPacing, Qt::DirectConnection);
+    connect(settingsTab, &SettingsTab::searchIndexChanged, this, &MainWindow::onSearchIndexChanged);
+    connect(settingsTab, &SettingsTab::metricsChanged, this, &MainWindow::onMetricsChanged);
     ui->funcTab->insertTab(5, settingsTab, tr("Settings"));
 
+    // optional, enabled in SettingsTab
+    m_metricsServer = new MetricsServer(this);
+    initMetrics();
+
     deviceTab->getAvailableTypes(true);
     initTabs();
 
@@ -140,6 +189,13 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    m_TxScheduler->clear();
+    m_TxSchedulerThread->quit();
+    m_TxSchedulerThread->wait();
+    m_captureIndex->reset();
+    m_captureIndexThread->quit();
+    m_captureIndexThread->wait();
+    m_metricsServer->stop();
     delete ui;
 }
 
@@ -214,6 +270,7 @@ void MainWindow::initUI()
     statusBar()->addPermanentWidget(connArgsLabel, 1);
     statusBar()->addPermanentWidget(RxLabel, 0);
     statusBar()->addPermanentWidget(TxLabel, 0);
+    statusBar()->addPermanentWidget(RttLabel, 0);
     statusBar()->addPermanentWidget(serialPinout, 0);
 #ifdef Q_OS_ANDROID
 
@@ -345,6 +402,54 @@ void MainWindow::updateStatusBar()
         }
         connArgsText.append((tr("Remote") + ": (%1, %2) ").arg(netArg.remoteName).arg(netArg.remotePort));
     }
+    else if(type == Connection::Process)
+    {
+        serialPinout->hide();
+        if(IOConnection->isConnected())
+        {
+            connArgsText.append((tr("Program") + ": %1 ").arg(IOConnection->getLocalArgument().name));
+            connArgsText.append((tr("PID") + ": %1 ").arg(IOConnection->Process_processId()));
+        }
+    }
+    else if(type == Connection::LocalSocket)
+    {
+        serialPinout->hide();
+        if(IOConnection->isConnected())
+            connArgsText.append((tr("Server") + ": %1 ").arg(IOConnection->getLocalArgument().name));
+    }
+    else if(type == Connection::SocketCAN)
+    {
+        serialPinout->hide();
+        if(IOConnection->isConnected())
+        {
+            Connection::CANArgument arg = IOConnection->getCANArgument();
+            connArgsText.append((tr("Interface") + ": %1 ").arg(arg.interfaceName));
+            if(arg.FDEnabled)
+                connArgsText.append("CAN FD ");
+        }
+    }
+    else if(type == Connection::RFC2217_Client)
+    {
+        serialPinout->show();
+        if(IOConnection->isConnected())
+        {
+            Connection::NetworkArgument netArg = IOConnection->getNetworkArgument();
+            connArgsText.append((tr("Remote") + ": (%1, %2) ").arg(netArg.remoteName).arg(netArg.remotePort));
+            connArgsText.append((tr("BaudRate") + ": %1 ").arg(IOConnection->SP_baudRate()));
+        }
+    }
+    else if(type == Connection::RFC2217_Server)
+    {
+        serialPinout->show();
+        if(IOConnection->isConnected())
+        {
+            Connection::NetworkArgument netArg = IOConnection->getNetworkArgument();
+            connArgsText.append((tr("Port") + ": %1 ").arg(IOConnection->getSerialPortArgument().name));
+            connArgsText.append((tr("BaudRate") + ": %1 ").arg(IOConnection->SP_baudRate()));
+            connArgsText.append((tr("Local") + ": %1 ").arg(netArg.localPort));
+        }
+        connArgsText.append((tr("Connected Clients") + ": %1 ").arg(IOConnection->TCPServer_clientCount()));
+    }
     connArgsLabel->setText(connArgsText);
     Connection::State currState = IOConnection->state();
     if(currState == Connection::Connected)
@@ -364,6 +469,8 @@ void MainWindow::updateWindowTitle(Connection::Type type)
 void MainWindow::clearSendedData()
 {
     rawSendedData.clear();
+    TxMetadata.clear();
+    m_timeline.remove(Timeline::Tx);
     m_TxCount = 0;
     updateRxTxLen(false, true);
 }
@@ -372,6 +479,11 @@ void MainWindow::clearReceivedData()
 {
     rawReceivedData.clear();
     RxMetadata.clear();
+    m_timeline.remove(Timeline::Rx);
+    m_deframer.reset();
+    m_isRxFrameOpen = false;
+    m_captureIndex->reset();
+    m_indexedChunkNum = 0;
     m_RxCount = 0;
     updateRxTxLen(true, false);
 }
@@ -419,8 +531,12 @@ void MainWindow::onIODeviceConnected()
 {
     qDebug() << "IODevice Connected";
     updateUITimer->start();
+    // the statistics of the new connection
+    m_rttTracker.reset();
+    m_rttShownNum = 1;
+    updateRttLabel();
     Connection::Type type = IOConnection->type();
-    if(type == Connection::SerialPort)
+    if(type == Connection::SerialPort || type == Connection::RFC2217_Server)
     {
         if(serialPinout->getEnableState())
             IOConnection->setPolling(true);
@@ -445,16 +561,30 @@ void MainWindow::onIODeviceConnected()
     }
     updateStatusBar();
     dataTab->onConnEstablished();
+    m_TxScheduler->setFileDescriptor(IOConnection->SP_handle());
 }
 
 void MainWindow::onIODeviceDisconnected()
 {
     qDebug() << "IODevice Disconnected";
     updateUITimer->stop();
+    m_TxScheduler->clear();
+    // the repeating is stopped by clear()
+    dataTab->setRepeat(false);
+    ctrlTab->autoResponder()->reset();
+    m_deframer.reset();
+    m_isRxFrameOpen = false;
     updateStatusBar();
     updateRxUI();
 }
 
+void MainWindow::onIODeviceAboutToClose()
+{
+    // the current write is stopped by clear(), then setFileDescriptor() waits for it
+    m_TxScheduler->clear();
+    m_TxScheduler->setFileDescriptor(-1);
+}
+
 void MainWindow::onIODeviceConnectFailed(const QString& info)
 {
     Connection::Type type = IOConnection->type();
@@ -463,11 +593,11 @@ void MainWindow::onIODeviceConnectFailed(const QString& info)
     {
         msg = tr("Cannot open the serial port.");
     }
-    else if(type == Connection::BT_Client || type == Connection::BLE_Central || type == Connection::TCP_Client)
+    else if(type == Connection::BT_Client || type == Connection::BLE_Central || type == Connection::TCP_Client || type == Connection::LocalSocket || type == Connection::RFC2217_Client)
     {
         msg = tr("Cannot establish the connection.");
     }
-    else if(type == Connection::BT_Server || type == Connection::TCP_Server)
+    else if(type == Connection::BT_Server || type == Connection::TCP_Server || type == Connection::RFC2217_Server)
     {
         msg = tr("Cannot start the server.");
     }
@@ -475,6 +605,14 @@ void MainWindow::onIODeviceConnectFailed(const QString& info)
     {
         msg = tr("Cannot bind to the specified address and port.");
     }
+    else if(type == Connection::Process)
+    {
+        msg = tr("Cannot start the program.");
+    }
+    else if(type == Connection::SocketCAN)
+    {
+        msg = tr("Cannot open the CAN interface.");
+    }
     if(!info.isEmpty())
         msg += "\n" + info;
     QMessageBox::warning(this, tr("Error"), msg);
@@ -493,26 +631,112 @@ void MainWindow::onIODeviceConnectFailed(const QStringList& infoList)
 
 void MainWindow::readData()
 {
-    QByteArray newData = IOConnection->readAll();
-    if(newData.isEmpty())
+    QVector<Metadata> frameList;
+    QByteArray newData = IOConnection->readAll(frameList);
+    if(newData.isEmpty() && frameList.isEmpty())
         return;
-
-    Metadata metadata(rawReceivedData.length(), newData.length(), QDateTime::currentMSecsSinceEpoch());
-    if(m_mergeTimestamp && !RxMetadata.isEmpty() && metadata.timestamp - RxMetadata.last().timestamp < m_timestampInterval)
-        RxMetadata.last().len += metadata.len;
+    const qint64 RttTimestamp = RttTracker::now();
+    // the complete frames for m_rttTracker, [begin, end) in rawReceivedData
+    QVector<QPair<qint64, qint64>> completeFrames;
+    // the frames finished in this chunk, for Metrics
+    int frameNum = 1;
+    const bool isTrackingFrames = (m_rttTracker.mode() == RttTracker::Sequence || m_rttTracker.mode() == RttTracker::RegExp);
+    // reply as soon as possible, not in updateRxUI()
+    ctrlTab->autoResponder()->feed(newData);
+    // the echo of the keystrokes should be shown without the UI buffering delay
+    dataTab->feedTerminal(newData);
+
+    if(!frameList.isEmpty())
+    {
+        // frame-based connection, every frame has its own timestamp, don't merge them
+        const qint64 offset = rawReceivedData.length();
+        for(Metadata& frame : frameList)
+        {
+            frame.pos += offset;
+            m_timeline.append(Timeline::Rx, frame.pos, frame.len, frame.timestamp);
+            if(isTrackingFrames)
+                completeFrames.append(qMakePair(frame.pos, frame.pos + frame.len));
+        }
+        RxMetadata += frameList;
+        RxUIMetadataBuf += frameList;
+        frameNum = frameList.size();
+    }
+    else if(m_deframer.mode() != Deframer::None)
+    {
+        // every frame has its own Metadata, stamped when its first byte is received
+        QVector<qint64> frameEnds;
+        qint64 pos = rawReceivedData.length();
+        const qint64 end = pos + newData.length();
+        const qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+        m_deframer.feed(newData.constData(), newData.length(), pos, &frameEnds);
+        const bool isLastFrameOpen = (frameEnds.isEmpty() || frameEnds.last() != end);
+        frameNum = frameEnds.size();
+        if(isLastFrameOpen)
+            frameEnds.append(end);
+        for(const qint64 frameEnd : qAsConst(frameEnds))
+        {
+            if(isTrackingFrames && !(isLastFrameOpen && frameEnd == end))
+                completeFrames.append(qMakePair(m_isRxFrameOpen ? RxMetadata.last().pos : pos, frameEnd));
+            m_timeline.append(Timeline::Rx, pos, frameEnd - pos, timestamp, m_isRxFrameOpen);
+            if(m_isRxFrameOpen)
+                RxMetadata.last().len += frameEnd - pos;
+            else
+            {
+                RxMetadata.append(Metadata(pos, frameEnd - pos, timestamp));
+                RxUIMetadataBuf += RxMetadata.last();
+            }
+            m_isRxFrameOpen = false;
+            pos = frameEnd;
+        }
+        m_isRxFrameOpen = isLastFrameOpen;
+    }
     else
     {
-        RxMetadata.append(metadata);
-        RxUIMetadataBuf += metadata;
+        Metadata metadata(rawReceivedData.length(), newData.length(), QDateTime::currentMSecsSinceEpoch());
+        // the frames are not split, every chunk is a frame
+        if(isTrackingFrames)
+            completeFrames.append(qMakePair(metadata.pos, metadata.pos + metadata.len));
+        const bool isMerged = (m_mergeTimestamp && !RxMetadata.isEmpty() && metadata.timestamp - RxMetadata.last().timestamp < m_timestampInterval);
+        m_timeline.append(Timeline::Rx, metadata.pos, metadata.len, metadata.timestamp, isMerged);
+        if(isMerged)
+            RxMetadata.last().len += metadata.len;
+        else
+        {
+            RxMetadata.append(metadata);
+            RxUIMetadataBuf += metadata;
+        }
     }
 
     rawReceivedData += newData;
+    m_rttTracker.received(newData.constData(), newData.length(), RttTimestamp);
+    for(const QPair<qint64, qint64>& frame : qAsConst(completeFrames))
+        m_rttTracker.receivedFrame(rawReceivedData.constData() + frame.first, frame.second - frame.first, RttTimestamp);
     m_RxCount += newData.length();
+    Metrics::add(Metrics::RxBytes, newData.length());
+    Metrics::add(Metrics::RxFrames, frameNum);
     updateRxTxLen(true, false);
+    if(RxUIBuf.isEmpty())
+        m_RxUIBufTimer.start();
     RxUIBuf += newData;
     QApplication::processEvents();
 }
 
+void MainWindow::onBridgeDataForwarded(const QByteArray& data)
+{
+    if(m_TxDataRecording)
+    {
+        const qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+        TxMetadata.append(Metadata(rawSendedData.length(), data.length(), timestamp));
+        m_timeline.append(Timeline::Tx, rawSendedData.length(), data.length(), timestamp);
+        rawSendedData += data;
+        dataTab->appendSendedData(data);
+    }
+    m_TxCount += data.length();
+    Metrics::add(Metrics::TxBytes, data.length());
+    Metrics::add(Metrics::TxFrames);
+    updateRxTxLen(false, true);
+}
+
 void MainWindow::sendData(const QByteArray& data)
 {
     if(!IOConnection->isConnected())
@@ -522,33 +746,238 @@ void MainWindow::sendData(const QByteArray& data)
         fileTab->stop();
         return;
     }
+    if(m_TxScheduler->isPacing())
+    {
+        // recorded in onTxSchedulerSent() with the actual timestamp
+        m_TxScheduler->post(data);
+        return;
+    }
     qint64 len = IOConnection->write(data);
     // this happens if an error occurred,
     // or the Tx switch of all clients are disabled.
     if(len <= 0)
         return;
+    m_rttTracker.sent(data, RttTracker::now());
     if(m_TxDataRecording)
     {
+        const qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+        TxMetadata.append(Metadata(rawSendedData.length(), data.length(), timestamp));
+        m_timeline.append(Timeline::Tx, rawSendedData.length(), data.length(), timestamp);
         rawSendedData += data;
         dataTab->appendSendedData(data);
     }
     m_TxCount += len;
+    Metrics::add(Metrics::TxBytes, len);
+    Metrics::add(Metrics::TxFrames);
     updateRxTxLen(false, true);
 }
 
-// TODO:
-// use the same RxDecoder for edit/plot
-// maybe standalone decoder?
+void MainWindow::onTerminalInput(const QByteArray& data)
+{
+    // don't warn on every keystroke
+    if(!IOConnection->isConnected())
+        return;
+    sendData(data);
+}
+
+void MainWindow::startRepeat(const TxFrame& frame, qint64 period)
+{
+    if(!IOConnection->isConnected())
+    {
+        QMessageBox::warning(this, tr("Error"), tr("No port is opened."));
+        dataTab->setRepeat(false);
+        return;
+    }
+    m_TxScheduler->startRepeat(frame, period);
+}
+
+void MainWindow::stopRepeat()
+{
+    m_TxScheduler->stopRepeat();
+}
+
+void MainWindow::onSearchIndexChanged(bool enabled)
+{
+    if(enabled)
+    {
+        indexReceivedData();
+        m_captureIndexTimer->start();
+    }
+    else
+    {
+        m_captureIndexTimer->stop();
+        m_captureIndex->reset();
+        m_indexedChunkNum = 0;
+    }
+}
+
+void MainWindow::onMetricsChanged(bool enabled, int port)
+{
+    if(!enabled)
+    {
+        m_metricsServer->stop();
+        return;
+    }
+    if(!m_metricsServer->start(port))
+        QMessageBox::warning(this, tr("Error"), tr("Cannot start the metrics endpoint.") + "\n" + m_metricsServer->errorString());
+}
+
+void MainWindow::initMetrics()
+{
+    // sampled on scrape, in the main thread
+    const QString queueName = "serialtest_queue_depth_bytes";
+    const QString queueHelp = "Bytes waiting to be processed.";
+    m_metricsServer->addGauge(queueName, queueHelp, "queue=\"rx_ui\"", [ = ]()
+    {
+        return RxUIBuf.size();
+    });
+    m_metricsServer->addGauge(queueName, queueHelp, "queue=\"tx_scheduler\"", [ = ]()
+    {
+        return m_TxScheduler->pendingBytes();
+    });
+    m_metricsServer->addGauge(queueName, queueHelp, "queue=\"capture_index\"", [ = ]()
+    {
+        return (double)(m_indexedChunkNum - m_captureIndex->chunkCount()) * CaptureIndex::m_chunkSize;
+    });
+
+    const QString bufferName = "serialtest_buffer_memory_bytes";
+    const QString bufferHelp = "Memory used by the buffer.";
+    m_metricsServer->addGauge(bufferName, bufferHelp, "buffer=\"rx_data\"", [ = ]()
+    {
+        return rawReceivedData.capacity();
+    });
+    m_metricsServer->addGauge(bufferName, bufferHelp, "buffer=\"rx_metadata\"", [ = ]()
+    {
+        return (double)RxMetadata.capacity() * sizeof(Metadata);
+    });
+    m_metricsServer->addGauge(bufferName, bufferHelp, "buffer=\"tx_data\"", [ = ]()
+    {
+        return rawSendedData.capacity();
+    });
+    m_metricsServer->addGauge(bufferName, bufferHelp, "buffer=\"tx_metadata\"", [ = ]()
+    {
+        return (double)TxMetadata.capacity() * sizeof(Metadata);
+    });
+    m_metricsServer->addGauge(bufferName, bufferHelp, "buffer=\"timeline\"", [ = ]()
+    {
+        return m_timeline.memoryUsage();
+    });
+    m_metricsServer->addGauge(bufferName, bufferHelp, "buffer=\"capture_index\"", [ = ]()
+    {
+        return m_captureIndex->memoryUsage();
+    });
+    m_metricsServer->addGauge(bufferName, bufferHelp, "buffer=\"plot_history\"", [ = ]()
+    {
+        return plotTab->historyMemoryUsage();
+    });
+}
+
+void MainWindow::indexReceivedData()
+{
+    // A chunk is sealed when the first 2 bytes of the next chunk arrive.
+    // The chunks are copied in batches, so the worker won't fall far behind and a huge capture doesn't block the UI.
+    const int generation = m_captureIndex->generation();
+    while(m_indexedChunkNum - m_captureIndex->chunkCount() < 256)
+    {
+        const qint64 begin = (qint64)m_indexedChunkNum * CaptureIndex::m_chunkSize;
+        if(rawReceivedData.length() < begin + CaptureIndex::m_chunkSize + 2)
+            break;
+        QMetaObject::invokeMethod(m_captureIndex, "addChunk", Qt::QueuedConnection, Q_ARG(QByteArray, rawReceivedData.mid(begin, CaptureIndex::m_chunkSize + 2)), Q_ARG(int, m_indexedChunkNum), Q_ARG(int, generation));
+        m_indexedChunkNum++;
+    }
+}
+
+void MainWindow::onTxSchedulerWriteRequested(const QByteArray& data, int generation)
+{
+    // the scheduler waits if too many chunks are queued
+    m_TxScheduler->writeFinished();
+    // queued before clear() or a failure
+    if(generation != m_TxScheduler->generation())
+        return;
+    if(!IOConnection->isConnected())
+    {
+        m_TxScheduler->clear();
+        return;
+    }
+    if(IOConnection->write(data) < 0)
+    {
+        // the chunk is reported by sent() or sentFrames() later, drop the whole generation
+        m_TxFailedGeneration = generation;
+        onTxSchedulerFailed(IOConnection->errorString());
+    }
+}
+
+void MainWindow::onTxSchedulerSent(const QByteArray& data, qint64 timestamp, qint64 sendTime, int generation)
+{
+    if(generation == m_TxFailedGeneration)
+        return;
+    // the time it's written, not the time this signal arrives
+    m_rttTracker.sent(data, sendTime);
+    if(m_TxDataRecording)
+    {
+        TxMetadata.append(Metadata(rawSendedData.length(), data.length(), timestamp));
+        m_timeline.append(Timeline::Tx, rawSendedData.length(), data.length(), timestamp);
+        rawSendedData += data;
+        dataTab->appendSendedData(data);
+    }
+    m_TxCount += data.length();
+    Metrics::add(Metrics::TxBytes, data.length());
+    Metrics::add(Metrics::TxFrames);
+    updateRxTxLen(false, true);
+}
+
+void MainWindow::onTxSchedulerSentFrames(const QByteArray& data, const QVector<Metadata>& frames, const QVector<qint64>& sendTimes, int generation)
+{
+    if(generation == m_TxFailedGeneration)
+        return;
+    if(m_rttTracker.mode() != RttTracker::Disabled)
+    {
+        for(int i = 0; i < frames.size(); i++)
+            m_rttTracker.sent(data.mid(frames[i].pos, frames[i].len), sendTimes[i]);
+    }
+    if(m_TxDataRecording)
+    {
+        const qint64 base = rawSendedData.length();
+        for(const Metadata& frame : frames)
+        {
+            TxMetadata.append(Metadata(base + frame.pos, frame.len, frame.timestamp));
+            m_timeline.append(Timeline::Tx, base + frame.pos, frame.len, frame.timestamp);
+        }
+        rawSendedData += data;
+        dataTab->appendSendedData(data);
+    }
+    m_TxCount += data.length();
+    Metrics::add(Metrics::TxBytes, data.length());
+    Metrics::add(Metrics::TxFrames, frames.size());
+    updateRxTxLen(false, true);
+}
+
+void MainWindow::onTxSchedulerFailed(const QString& info)
+{
+    m_TxScheduler->clear();
+    dataTab->setRepeat(false);
+    fileTab->stop();
+    QMessageBox::warning(this, tr("Error"), tr("Failed to send data:") + "\n" + info);
+}
+
 void MainWindow::updateRxUI()
 {
-    if(RxUIBuf.isEmpty())
+    updateRttLabel();
+    if(RxUIBuf.isEmpty() && RxUIMetadataBuf.isEmpty())
         return;
     if(dataTab->getRxRealtimeState())
         dataTab->appendReceivedData(RxUIBuf, RxUIMetadataBuf);
     if(plotTab->enabled())
-        plotTab->newData(RxUIBuf);
+    {
+        if(IOConnection->type() == Connection::SocketCAN)
+            plotTab->newFrames(RxUIBuf, RxUIMetadataBuf);
+        else
+            plotTab->newData(RxUIBuf);
+    }
     if(fileTab->receiving())
         fileTab->fileXceiver()->newData(RxUIBuf);
+    if(!RxUIBuf.isEmpty())
+        Metrics::observe(Metrics::ReadToDisplayLatency, m_RxUIBufTimer.nsecsElapsed() / 1000);
     RxUIBuf.clear();
     RxUIMetadataBuf.clear();
 }
@@ -644,6 +1073,46 @@ void MainWindow::onTimestampIntervalChanged(int interval)
     m_timestampInterval = interval;
 }
 
+void MainWindow::onRttChanged(int mode, int offset, int size, bool bigEndian, const QString& regExp, int timeout)
+{
+    m_rttTracker.setMode((RttTracker::Mode)mode);
+    m_rttTracker.setSequenceField(offset, size, bigEndian);
+    m_rttTracker.setRegExp(regExp);
+    m_rttTracker.setTimeout(timeout);
+    RttLabel->setVisible(mode != RttTracker::Disabled);
+    m_rttShownNum = 1; // force update
+    updateRttLabel();
+}
+
+void MainWindow::updateRttLabel()
+{
+    const LatencyHistogram& histogram = m_rttTracker.histogram();
+    const quint64 num = histogram.count() + m_rttTracker.timeoutNum();
+    if(RttLabel->isHidden() || num == m_rttShownNum)
+        return;
+    m_rttShownNum = num;
+    auto toMs = [](double us)
+    {
+        return QString::number(us / 1000, 'f', 3);
+    };
+    RttLabel->setText(tr("RTT") + " p50/p99/p99.9: " + toMs(histogram.percentile(50)) + "/" + toMs(histogram.percentile(99)) + "/" + toMs(histogram.percentile(99.9)) + "ms");
+    RttLabel->setToolTip(tr("Responses") + ": " + QString::number(histogram.count()) + "\n"
+                         + tr("Timeouts") + ": " + QString::number(m_rttTracker.timeoutNum()) + "\n"
+                         + tr("Min") + ": " + toMs(histogram.min()) + "ms\n"
+                         + tr("Mean") + ": " + toMs(histogram.mean()) + "ms\n"
+                         + tr("Max") + ": " + toMs(histogram.max()) + "ms");
+}
+
+void MainWindow::onDeframerChanged(int mode, int lengthSize, bool bigEndian, char delimiter)
+{
+    m_deframer.setMode((Deframer::Mode)mode);
+    m_deframer.setLengthField(lengthSize, bigEndian);
+    m_deframer.setDelimiter(delimiter);
+    // the new frames start from the next received data
+    m_isRxFrameOpen = false;
+    dataTab->setFrameSplitEnabled(mode != Deframer::None);
+}
+
 bool MainWindow::eventFilter(QObject *watched, QEvent *event)
 {
     if(dockList.contains((QDockWidget*)watched))
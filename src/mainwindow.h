@@ -8,6 +8,7 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QTimer>
+#include <QElapsedTimer>
 
 #include <QSerialPort>
 #include <QSerialPortInfo>
@@ -28,7 +29,14 @@
 #include "settingstab.h"
 #include "serialpinout.h"
 #include "connection.h"
+#include "bridge.h"
+#include "txscheduler.h"
+#include "captureindex.h"
+#include "metricsserver.h"
 #include "metadata.h"
+#include "deframer.h"
+#include "rtttracker.h"
+#include "timeline.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui
@@ -47,9 +55,13 @@ public:
 
 public slots:
     void sendData(const QByteArray &data);
+    void onTerminalInput(const QByteArray& data);
+    void startRepeat(const TxFrame& frame, qint64 period);
+    void stopRepeat();
     void updateStatusBar();
     void updateWindowTitle(Connection::Type type);
     void updateRxTxLen(bool updateRx = true, bool updateTx = true);
+    void updateRttLabel();
     void clearSendedData();
     void clearReceivedData();
     void setTxDataRecording(bool enabled);
@@ -60,6 +72,10 @@ public slots:
     void onDockTopLevelChanged(bool topLevel); // for opacity
     void onMergeTimestampChanged(bool enabled);
     void onTimestampIntervalChanged(int interval);
+    void onDeframerChanged(int mode, int lengthSize, bool bigEndian, char delimiter);
+    void onRttChanged(int mode, int offset, int size, bool bigEndian, const QString& regExp, int timeout);
+    void onSearchIndexChanged(bool enabled);
+    void onMetricsChanged(bool enabled, int port);
 
 protected:
     bool eventFilter(QObject *watched, QEvent *event) override;
@@ -68,6 +84,12 @@ protected:
     void closeEvent(QCloseEvent* event) override;
 private slots:
     void readData();
+    void onBridgeDataForwarded(const QByteArray& data);
+    void onTxSchedulerWriteRequested(const QByteArray& data, int generation);
+    void onTxSchedulerSent(const QByteArray& data, qint64 timestamp, qint64 sendTime, int generation);
+    void onTxSchedulerSentFrames(const QByteArray& data, const QVector<Metadata>& frames, const QVector<qint64>& sendTimes, int generation);
+    void onTxSchedulerFailed(const QString& info);
+    void indexReceivedData();
     void onStateButtonClicked();
     void updateRxUI();
 
@@ -77,6 +99,7 @@ private slots:
 
     void onIODeviceConnected();
     void onIODeviceDisconnected();
+    void onIODeviceAboutToClose();
     void onIODeviceConnectFailed(const QString& info);
     void onIODeviceConnectFailed(const QStringList& infoList);
 private:
@@ -90,10 +113,20 @@ private:
     QAction* checkUpdate;
 
     Connection* IOConnection = nullptr;
+    Bridge* IOBridge = nullptr;
+    QThread* m_TxSchedulerThread = nullptr;
+    TxScheduler* m_TxScheduler = nullptr;
+    int m_TxFailedGeneration = -1; // the sent reports of it are dropped
+    QThread* m_captureIndexThread = nullptr;
+    CaptureIndex* m_captureIndex = nullptr;
+    QTimer* m_captureIndexTimer = nullptr;
+    int m_indexedChunkNum = 0; // the chunks sent to m_captureIndex
+    MetricsServer* m_metricsServer = nullptr;
 
     QPushButton* stateButton;
     QLabel* TxLabel;
     QLabel* RxLabel;
+    QLabel* RttLabel;
     QLabel* connArgsLabel;
     SerialPinout* serialPinout;
 
@@ -102,12 +135,22 @@ private:
     QVector<Metadata> RxMetadata;
     qint64 m_RxCount = 0;
     QByteArray rawSendedData;
+    QVector<Metadata> TxMetadata;
+    // the chunks in rawReceivedData and rawSendedData, in time order
+    // only recorded while the conversation is shown
+    Timeline m_timeline;
     qint64 m_TxCount = 0;
     QByteArray RxUIBuf;
     QVector<Metadata> RxUIMetadataBuf;
+    QElapsedTimer m_RxUIBufTimer; // started when RxUIBuf becomes non-empty
 
     bool m_mergeTimestamp = true;
     int m_timestampInterval = 10;
+    // replaces the merging of timestamps when enabled
+    Deframer m_deframer;
+    bool m_isRxFrameOpen = false; // RxMetadata.last() is an unfinished frame
+    RttTracker m_rttTracker;
+    quint64 m_rttShownNum = 0; // the matched and timed out requests shown in RttLabel
 
     QTimer* updateUITimer;
 
@@ -131,5 +174,6 @@ private:
 
     void dockInit();
     void initTabs();
+    void initMetrics();
 };
 #endif // MAINWINDOW_H
@@ -1,15 +1,63 @@
 
 #include "metadata.h"
 
+#include <algorithm>
+
 Metadata::Metadata() :
-    pos(0), len(0), timestamp(0)
+    pos(0), len(0), timestamp(0), frameId(0)
 {
 
 }
 
 Metadata::Metadata(qint64 pos, qint64 len, qint64 timestamp) :
-    pos(pos), len(len), timestamp(timestamp)
+    pos(pos), len(len), timestamp(timestamp), frameId(0)
+{
+
+}
+
+Metadata::Metadata(qint64 pos, qint64 len, qint64 timestamp, quint32 frameId) :
+    pos(pos), len(len), timestamp(timestamp), frameId(frameId)
+{
+
+}
+
+int Metadata::indexAt(const QVector<Metadata>& list, qint64 pos)
+{
+    auto it = std::upper_bound(list.cbegin(), list.cend(), pos, [](qint64 val, const Metadata & item)
+    {
+        return val < item.pos;
+    });
+    return (it - list.cbegin()) - 1;
+}
+
+int Metadata::indexAtTime(const QVector<Metadata>& list, qint64 timestamp)
 {
+    auto it = std::lower_bound(list.cbegin(), list.cend(), timestamp, [](const Metadata & item, qint64 val)
+    {
+        return item.timestamp < val;
+    });
+    return it - list.cbegin();
+}
 
+void Metadata::indexRangeOfTime(const QVector<Metadata>& list, qint64 from, qint64 to, int* first, int* end)
+{
+    *first = indexAtTime(list, from);
+    auto it = std::upper_bound(list.cbegin() + *first, list.cend(), to, [](qint64 val, const Metadata & item)
+    {
+        return val < item.timestamp;
+    });
+    *end = it - list.cbegin();
 }
 
+void Metadata::posRangeOfTime(const QVector<Metadata>& list, qint64 from, qint64 to, qint64* begin, qint64* end)
+{
+    int firstId, endId;
+    indexRangeOfTime(list, from, to, &firstId, &endId);
+    if(firstId >= endId)
+    {
+        *begin = *end = 0;
+        return;
+    }
+    *begin = list[firstId].pos;
+    *end = list[endId - 1].pos + list[endId - 1].len;
+}
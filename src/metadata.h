@@ -3,16 +3,35 @@
 #define METADATA_H
 
 #include "qglobal.h"
+#include <QMetaType>
+#include <QVector>
+
 class Metadata
 {
 public:
     Metadata();
     Metadata(qint64 pos, qint64 len, qint64 timestamp);
+    Metadata(qint64 pos, qint64 len, qint64 timestamp, quint32 frameId);
     qint64 pos = 0;
     qint64 len = 0;
     qint64 timestamp = 0;
+    // CAN identifier with EFF/RTR/ERR flags (struct can_frame::can_id), DLC = len
+    quint32 frameId = 0;
+    // CAN remote frames only, they have a DLC but no data, so len is 0
+    quint8 remoteDLC = 0;
     // WebSocket text/binary
     // source clicnt for the TCP/BT server
+
+    // The list is ordered by pos, and by timestamp unless the clock goes back, so binary search is used.
+    // the index of the last Metadata starting at or before pos, -1 if there is no such Metadata
+    static int indexAt(const QVector<Metadata>& list, qint64 pos);
+    // the index of the first Metadata received at or after timestamp, list.size() if there is no such Metadata
+    static int indexAtTime(const QVector<Metadata>& list, qint64 timestamp);
+    // the Metadata received in [from, to] are list[*first] to list[*end - 1]
+    static void indexRangeOfTime(const QVector<Metadata>& list, qint64 from, qint64 to, int* first, int* end);
+    // the bytes received in [from, to] are [*begin, *end), *begin == *end if there is no such Metadata
+    static void posRangeOfTime(const QVector<Metadata>& list, qint64 from, qint64 to, qint64* begin, qint64* end);
 };
+Q_DECLARE_METATYPE(Metadata)
 
 #endif // METADATA_H
@@ -0,0 +1,119 @@
+#include "metrics.h"
+
+#include <QMutexLocker>
+
+const qint64 Metrics::m_bounds[Metrics::m_boundNum] = {100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000};
+QMutex Metrics::m_slotListLock;
+QVector<Metrics::Slot*> Metrics::m_slotList;
+
+static const char* const counterInfo[Metrics::CounterNum][2] =
+{
+    {"serialtest_rx_bytes_total", "Bytes received from the connection."},
+    {"serialtest_tx_bytes_total", "Bytes sent to the connection."},
+    {"serialtest_rx_frames_total", "Received chunks, or frames for a frame-based connection."},
+    {"serialtest_tx_frames_total", "Sent chunks."},
+    {"serialtest_connections_total", "Established connections, including reconnections."},
+    {"serialtest_errors_total", "Errors reported by the connection."},
+    {"serialtest_parse_failures_total", "Plot fields without a number."},
+};
+
+static const char* const histogramInfo[Metrics::HistogramNum][2] =
+{
+    {"serialtest_read_to_display_latency_seconds", "Time from reading the data to handing it over to the tabs."},
+    {"serialtest_gui_stall_seconds", "Lateness of a periodic timer in the main thread."},
+    {"serialtest_round_trip_time_seconds", "Time from sending a request to receiving its echo or response."},
+};
+
+Metrics::Slot::Slot()
+{
+    for(int i = 0; i < CounterNum; i++)
+        counters[i].store(0);
+    for(int i = 0; i < HistogramNum; i++)
+    {
+        for(int j = 0; j <= m_boundNum; j++)
+            buckets[i][j].store(0);
+        sums[i].store(0);
+    }
+}
+
+Metrics::Slot* Metrics::localSlot()
+{
+    static thread_local Slot* slot = nullptr;
+    if(slot == nullptr)
+    {
+        slot = new Slot;
+        QMutexLocker locker(&m_slotListLock);
+        m_slotList.append(slot);
+    }
+    return slot;
+}
+
+void Metrics::increase(std::atomic<quint64>& val, quint64 num)
+{
+    // only the owner thread writes to the slot, no read-modify-write is needed
+    val.store(val.load(std::memory_order_relaxed) + num, std::memory_order_relaxed);
+}
+
+void Metrics::add(Counter counter, quint64 num)
+{
+    increase(localSlot()->counters[counter], num);
+}
+
+void Metrics::observe(Histogram histogram, qint64 value)
+{
+    value = qMax<qint64>(value, 0);
+    int id = 0;
+    while(id < m_boundNum && value > m_bounds[id])
+        id++;
+    Slot* slot = localSlot();
+    increase(slot->buckets[histogram][id], 1);
+    increase(slot->sums[histogram], value);
+}
+
+QByteArray Metrics::exposition()
+{
+    quint64 counters[CounterNum] = {};
+    quint64 buckets[HistogramNum][m_boundNum + 1] = {};
+    quint64 sums[HistogramNum] = {};
+    {
+        QMutexLocker locker(&m_slotListLock);
+        for(const Slot* slot : qAsConst(m_slotList))
+        {
+            for(int i = 0; i < CounterNum; i++)
+                counters[i] += slot->counters[i].load(std::memory_order_relaxed);
+            for(int i = 0; i < HistogramNum; i++)
+            {
+                for(int j = 0; j <= m_boundNum; j++)
+                    buckets[i][j] += slot->buckets[i][j].load(std::memory_order_relaxed);
+                sums[i] += slot->sums[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    QByteArray result;
+    for(int i = 0; i < CounterNum; i++)
+    {
+        const QByteArray name = counterInfo[i][0];
+        result += "# HELP " + name + " " + counterInfo[i][1] + "\n";
+        result += "# TYPE " + name + " counter\n";
+        result += name + " " + QByteArray::number(counters[i]) + "\n";
+    }
+    for(int i = 0; i < HistogramNum; i++)
+    {
+        const QByteArray name = histogramInfo[i][0];
+        result += "# HELP " + name + " " + histogramInfo[i][1] + "\n";
+        result += "# TYPE " + name + " histogram\n";
+        // the buckets are cumulative
+        quint64 count = 0;
+        for(int j = 0; j < m_boundNum; j++)
+        {
+            count += buckets[i][j];
+            result += name + "_bucket{le=\"" + QByteArray::number(m_bounds[j] / 1e6, 'g', 10) + "\"} " + QByteArray::number(count) + "\n";
+        }
+        count += buckets[i][m_boundNum];
+        result += name + "_bucket{le=\"+Inf\"} " + QByteArray::number(count) + "\n";
+        result += name + "_sum " + QByteArray::number(sums[i] / 1e6, 'g', 10) + "\n";
+        result += name + "_count " + QByteArray::number(count) + "\n";
+    }
+    return result;
+}
@@ -0,0 +1,59 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QVector>
+#include <atomic>
+
+// Process-wide counters and histograms, exposed by MetricsServer.
+// Every thread writes to its own slot without any lock, the slots are summed up when scraped.
+class Metrics
+{
+public:
+    enum Counter
+    {
+        RxBytes = 0,
+        TxBytes,
+        RxFrames,
+        TxFrames,
+        Connections,
+        Errors,
+        ParseFailures,
+        CounterNum,
+    };
+    enum Histogram
+    {
+        ReadToDisplayLatency = 0,
+        GUIStall,
+        RoundTripTime,
+        HistogramNum,
+    };
+
+    static void add(Counter counter, quint64 num = 1);
+    // value: in us
+    static void observe(Histogram histogram, qint64 value);
+    // in Prometheus text format
+    static QByteArray exposition();
+private:
+    // upper bounds of the buckets in us, the +Inf bucket is not included
+    static const int m_boundNum = 13;
+    static const qint64 m_bounds[m_boundNum];
+
+    struct Slot
+    {
+        Slot();
+        std::atomic<quint64> counters[CounterNum];
+        std::atomic<quint64> buckets[HistogramNum][m_boundNum + 1];
+        std::atomic<quint64> sums[HistogramNum]; // in us
+    };
+
+    // the slots are kept after the thread exits, so the counters never go backwards
+    static QMutex m_slotListLock;
+    static QVector<Slot*> m_slotList;
+
+    static Slot* localSlot();
+    static void increase(std::atomic<quint64>& val, quint64 num);
+};
+
+#endif // METRICS_H
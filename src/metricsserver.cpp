@@ -0,0 +1,123 @@
+#include "metricsserver.h"
+#include "metrics.h"
+
+#include <QHostAddress>
+
+MetricsServer::MetricsServer(QObject *parent)
+    : QObject{parent}
+{
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+    m_stallTimer = new QTimer(this);
+    m_stallTimer->setTimerType(Qt::PreciseTimer);
+    m_stallTimer->setInterval(m_stallTimerInterval);
+    connect(m_stallTimer, &QTimer::timeout, this, &MetricsServer::onStallTimerTimeout);
+}
+
+bool MetricsServer::start(quint16 port)
+{
+    stop();
+    // never exposed to the network
+    if(!m_server->listen(QHostAddress::LocalHost, port))
+        return false;
+    m_lastTick = -1;
+    m_stallClock.start();
+    m_stallTimer->start();
+    return true;
+}
+
+void MetricsServer::stop()
+{
+    m_stallTimer->stop();
+    m_server->close();
+}
+
+bool MetricsServer::isListening() const
+{
+    return m_server->isListening();
+}
+
+QString MetricsServer::errorString() const
+{
+    return m_server->errorString();
+}
+
+void MetricsServer::addGauge(const QString& name, const QString& help, const QString& labels, std::function<double()> getter)
+{
+    Gauge gauge;
+    gauge.name = name;
+    gauge.help = help;
+    gauge.labels = labels;
+    gauge.getter = getter;
+    m_gauges.append(gauge);
+}
+
+void MetricsServer::onNewConnection()
+{
+    while(m_server->hasPendingConnections())
+    {
+        QTcpSocket* socket = m_server->nextPendingConnection();
+        connect(socket, &QTcpSocket::readyRead, this, &MetricsServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void MetricsServer::onReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    // only the request line is used
+    if(!socket->canReadLine())
+    {
+        if(socket->bytesAvailable() > 8192)
+            socket->abort();
+        return;
+    }
+    const QList<QByteArray> request = socket->readLine(8192).trimmed().split(' ');
+    socket->readAll();
+    disconnect(socket, &QTcpSocket::readyRead, this, &MetricsServer::onReadyRead);
+
+    QByteArray status = "200 OK";
+    QByteArray body;
+    if(request.size() < 2 || request[0] != "GET")
+        status = "405 Method Not Allowed";
+    else if(request[1] != "/metrics" && !request[1].startsWith("/metrics?"))
+        status = "404 Not Found";
+    else
+        body = Metrics::exposition() + gaugeExposition();
+
+    QByteArray response = "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+void MetricsServer::onStallTimerTimeout()
+{
+    const qint64 now = m_stallClock.nsecsElapsed() / 1000;
+    if(m_lastTick >= 0)
+        Metrics::observe(Metrics::GUIStall, now - m_lastTick - m_stallTimerInterval * 1000);
+    m_lastTick = now;
+}
+
+QByteArray MetricsServer::gaugeExposition() const
+{
+    QByteArray result;
+    QString lastName;
+    for(const Gauge& gauge : m_gauges)
+    {
+        if(gauge.name != lastName)
+        {
+            result += "# HELP " + gauge.name.toUtf8() + " " + gauge.help.toUtf8() + "\n";
+            result += "# TYPE " + gauge.name.toUtf8() + " gauge\n";
+            lastName = gauge.name;
+        }
+        result += gauge.name.toUtf8();
+        if(!gauge.labels.isEmpty())
+            result += "{" + gauge.labels.toUtf8() + "}";
+        result += " " + QByteArray::number(gauge.getter(), 'g', 15) + "\n";
+    }
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <functional>
+
+// A minimal HTTP endpoint on localhost, GET /metrics returns Metrics and the registered gauges.
+// It also measures the stall of the main thread while listening.
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+
+    bool start(quint16 port);
+    void stop();
+    bool isListening() const;
+    QString errorString() const;
+    // getter is called in the main thread on every scrape
+    // the gauges with the same name should be added together
+    void addGauge(const QString& name, const QString& help, const QString& labels, std::function<double()> getter);
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onStallTimerTimeout();
+private:
+    struct Gauge
+    {
+        QString name;
+        QString help;
+        QString labels;
+        std::function<double()> getter;
+    };
+
+    static const int m_stallTimerInterval = 100; // in ms
+    QTcpServer* m_server;
+    QTimer* m_stallTimer;
+    QElapsedTimer m_stallClock;
+    qint64 m_lastTick = -1;
+    QList<Gauge> m_gauges;
+
+    QByteArray gaugeExposition() const;
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,369 @@
+#include "plothistory.h"
+
+#include <cstring>
+
+PlotHistory::PlotHistory()
+{
+
+}
+
+void PlotHistory::append(double key, double value)
+{
+    qint64 tick = 0;
+    const bool isTick = toTick(key, &tick);
+    // a block in tick mode cannot store an arbitrary key, start a new one
+    if(m_blocks.isEmpty() || m_blocks.last().count >= m_blockPointNum || (m_blocks.last().tickKeys && !isTick))
+    {
+        if(!m_blocks.isEmpty())
+            m_blocks.last().bits.squeeze();
+        m_blocks.append(Block());
+    }
+
+    Block& block = m_blocks.last();
+    const quint64 valueBits = toBits(value);
+    if(block.count == 0)
+    {
+        block.tickKeys = isTick;
+        if(isTick)
+        {
+            write(block, (quint64)tick, 64);
+            block.lastTick = tick;
+        }
+        else
+        {
+            block.lastKeyBits = toBits(key);
+            write(block, block.lastKeyBits, 64);
+        }
+        write(block, valueBits, 64);
+        block.lastValueBits = valueBits;
+        block.minKey = block.maxKey = key;
+        block.minValue = block.maxValue = value;
+        block.minValueKey = block.maxValueKey = key;
+    }
+    else
+    {
+        if(block.tickKeys)
+        {
+            const qint64 delta = tick - block.lastTick;
+            writeDeltaOfDelta(block, delta - block.lastDelta);
+            block.lastDelta = delta;
+            block.lastTick = tick;
+        }
+        else
+            writeXOR(block, toBits(key), block.lastKeyBits, block.keyLeading, block.keyTrailing);
+        writeXOR(block, valueBits, block.lastValueBits, block.valueLeading, block.valueTrailing);
+
+        block.minKey = qMin(block.minKey, key);
+        block.maxKey = qMax(block.maxKey, key);
+        if(value < block.minValue)
+        {
+            block.minValue = value;
+            block.minValueKey = key;
+        }
+        if(value > block.maxValue)
+        {
+            block.maxValue = value;
+            block.maxValueKey = key;
+        }
+    }
+    block.count++;
+    m_size++;
+}
+
+void PlotHistory::clear()
+{
+    m_blocks.clear();
+    m_size = 0;
+}
+
+bool PlotHistory::isEmpty() const
+{
+    return m_size == 0;
+}
+
+qint64 PlotHistory::size() const
+{
+    return m_size;
+}
+
+qint64 PlotHistory::memoryUsage() const
+{
+    qint64 result = 0;
+    for(const Block& block : m_blocks)
+        result += sizeof(Block) + block.bits.capacity();
+    return result;
+}
+
+QCPRange PlotHistory::keyRange() const
+{
+    QCPRange result;
+    if(m_blocks.isEmpty())
+        return result;
+    result.lower = m_blocks[0].minKey;
+    result.upper = m_blocks[0].maxKey;
+    for(const Block& block : m_blocks)
+    {
+        result.lower = qMin(result.lower, block.minKey);
+        result.upper = qMax(result.upper, block.maxKey);
+    }
+    return result;
+}
+
+QVector<QCPGraphData> PlotHistory::query(double lower, double upper, int maxPoints) const
+{
+    QVector<QCPGraphData> result;
+    if(upper < lower || maxPoints <= 0)
+        return result;
+
+    qint64 total = 0;
+    for(const Block& block : m_blocks)
+    {
+        if(block.maxKey >= lower && block.minKey <= upper)
+            total += block.count;
+    }
+    if(total <= maxPoints || !(upper > lower))
+    {
+        for(const Block& block : m_blocks)
+        {
+            if(block.maxKey >= lower && block.minKey <= upper)
+                decode(block, result, lower, upper);
+        }
+        std::stable_sort(result.begin(), result.end(), qcpLessThanSortKey<QCPGraphData>);
+        return result;
+    }
+
+    // min/max decimation
+    const int bucketNum = qMax(1, maxPoints / 2);
+    const double bucketWidth = (upper - lower) / bucketNum;
+    QVector<QCPGraphData> bucketMin(bucketNum), bucketMax(bucketNum);
+    QVector<bool> bucketUsed(bucketNum, false);
+    auto addPoint = [&](const QCPGraphData & point)
+    {
+        const int id = qBound(0, (int)((point.key - lower) / bucketWidth), bucketNum - 1);
+        if(!bucketUsed[id])
+        {
+            bucketUsed[id] = true;
+            bucketMin[id] = bucketMax[id] = point;
+            return;
+        }
+        if(point.value < bucketMin[id].value)
+            bucketMin[id] = point;
+        if(point.value > bucketMax[id].value)
+            bucketMax[id] = point;
+    };
+
+    QVector<QCPGraphData> decoded;
+    for(const Block& block : m_blocks)
+    {
+        if(block.maxKey < lower || block.minKey > upper)
+            continue;
+        if(block.minKey >= lower && block.maxKey <= upper && block.maxKey - block.minKey < bucketWidth)
+        {
+            // narrower than a bucket, the summary is enough
+            addPoint(QCPGraphData(block.minValueKey, block.minValue));
+            addPoint(QCPGraphData(block.maxValueKey, block.maxValue));
+        }
+        else
+        {
+            decoded.clear();
+            decode(block, decoded, lower, upper);
+            for(const QCPGraphData& point : qAsConst(decoded))
+                addPoint(point);
+        }
+    }
+
+    result.reserve(bucketNum * 2);
+    for(int i = 0; i < bucketNum; i++)
+    {
+        if(!bucketUsed[i])
+            continue;
+        const QCPGraphData& first = (bucketMin[i].key <= bucketMax[i].key) ? bucketMin[i] : bucketMax[i];
+        const QCPGraphData& second = (bucketMin[i].key <= bucketMax[i].key) ? bucketMax[i] : bucketMin[i];
+        result.append(first);
+        if(second.key != first.key || second.value != first.value)
+            result.append(second);
+    }
+    return result;
+}
+
+void PlotHistory::decode(const Block& block, QVector<QCPGraphData>& result, double lower, double upper) const
+{
+    BitReader reader(block.bits);
+    qint64 tick = 0, delta = 0;
+    quint64 keyBits = 0, valueBits = 0;
+    int keyLeading = -1, keyTrailing = 0, valueLeading = -1, valueTrailing = 0;
+    double key;
+    for(int i = 0; i < block.count; i++)
+    {
+        if(i == 0)
+        {
+            if(block.tickKeys)
+                tick = (qint64)reader.read(64);
+            else
+                keyBits = reader.read(64);
+            valueBits = reader.read(64);
+        }
+        else
+        {
+            if(block.tickKeys)
+            {
+                delta += readDeltaOfDelta(reader);
+                tick += delta;
+            }
+            else
+                readXOR(reader, keyBits, keyLeading, keyTrailing);
+            readXOR(reader, valueBits, valueLeading, valueTrailing);
+        }
+        key = block.tickKeys ? (double)tick / m_tickPerKey : fromBits(keyBits);
+        if(key >= lower && key <= upper)
+            result.append(QCPGraphData(key, fromBits(valueBits)));
+    }
+}
+
+void PlotHistory::write(Block& block, quint64 value, int n)
+{
+    // MSB first
+    while(n > 0)
+    {
+        const int used = block.bitNum % 8;
+        if(used == 0)
+            block.bits.append('\0');
+        const int take = qMin(8 - used, n);
+        const quint8 part = (value >> (n - take)) & ((1u << take) - 1);
+        block.bits.data()[block.bits.size() - 1] |= (char)(part << (8 - used - take));
+        block.bitNum += take;
+        n -= take;
+    }
+}
+
+void PlotHistory::writeXOR(Block& block, quint64 value, quint64& last, int& leading, int& trailing)
+{
+    const quint64 diff = value ^ last;
+    last = value;
+    if(diff == 0)
+    {
+        write(block, 0, 1);
+        return;
+    }
+    write(block, 1, 1);
+    const int currLeading = qCountLeadingZeroBits(diff);
+    const int currTrailing = qCountTrailingZeroBits(diff);
+    if(leading >= 0 && currLeading >= leading && currTrailing >= trailing)
+    {
+        // the meaningful bits fit in the previous window
+        write(block, 0, 1);
+        write(block, diff >> trailing, 64 - leading - trailing);
+    }
+    else
+    {
+        leading = currLeading;
+        trailing = currTrailing;
+        const int len = 64 - leading - trailing;
+        write(block, 1, 1);
+        write(block, leading, 6);
+        write(block, len - 1, 6);
+        write(block, diff >> trailing, len);
+    }
+}
+
+quint64 PlotHistory::readXOR(BitReader& reader, quint64& last, int& leading, int& trailing)
+{
+    if(!reader.readBit())
+        return last;
+    if(reader.readBit())
+    {
+        leading = reader.read(6);
+        const int len = reader.read(6) + 1;
+        trailing = 64 - leading - len;
+    }
+    last ^= reader.read(64 - leading - trailing) << trailing;
+    return last;
+}
+
+void PlotHistory::writeDeltaOfDelta(Block& block, qint64 dod)
+{
+    if(dod == 0)
+        write(block, 0, 1);
+    else if(dod >= -63 && dod <= 64)
+    {
+        write(block, 0x2, 2);
+        write(block, dod + 63, 7);
+    }
+    else if(dod >= -255 && dod <= 256)
+    {
+        write(block, 0x6, 3);
+        write(block, dod + 255, 9);
+    }
+    else if(dod >= -2047 && dod <= 2048)
+    {
+        write(block, 0xE, 4);
+        write(block, dod + 2047, 12);
+    }
+    else
+    {
+        write(block, 0xF, 4);
+        write(block, (quint64)dod, 64);
+    }
+}
+
+qint64 PlotHistory::readDeltaOfDelta(BitReader& reader)
+{
+    if(!reader.readBit())
+        return 0;
+    if(!reader.readBit())
+        return (qint64)reader.read(7) - 63;
+    if(!reader.readBit())
+        return (qint64)reader.read(9) - 255;
+    if(!reader.readBit())
+        return (qint64)reader.read(12) - 2047;
+    return (qint64)reader.read(64);
+}
+
+bool PlotHistory::toTick(double key, qint64* tick)
+{
+    // NaN is rejected there
+    if(!(qAbs(key) < 1e15))
+        return false;
+    *tick = qRound64(key * m_tickPerKey);
+    // the key must be restored exactly
+    return (double)*tick / m_tickPerKey == key;
+}
+
+quint64 PlotHistory::toBits(double val)
+{
+    quint64 result;
+    memcpy(&result, &val, sizeof(result));
+    return result;
+}
+
+double PlotHistory::fromBits(quint64 bits)
+{
+    double result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+PlotHistory::BitReader::BitReader(const QByteArray& bits) : m_bits(bits)
+{
+
+}
+
+quint64 PlotHistory::BitReader::read(int n)
+{
+    quint64 result = 0;
+    while(n > 0)
+    {
+        const int used = m_pos % 8;
+        const int take = qMin(8 - used, n);
+        const quint8 byte = m_bits[(int)(m_pos / 8)];
+        result = (result << take) | ((byte >> (8 - used - take)) & ((1u << take) - 1));
+        m_pos += take;
+        n -= take;
+    }
+    return result;
+}
+
+bool PlotHistory::BitReader::readBit()
+{
+    return read(1) != 0;
+}
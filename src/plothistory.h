@@ -0,0 +1,83 @@
+#ifndef PLOTHISTORY_H
+#define PLOTHISTORY_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include "qcustomplot.h"
+
+// Compressed history of one plot channel, Gorilla-style(delta-of-delta keys and XOR encoded values).
+// The points are split into blocks, the min/max of each block is kept uncompressed,
+// so a wide range can be drawn from the block summaries without decoding the blocks.
+class PlotHistory
+{
+public:
+    PlotHistory();
+
+    void append(double key, double value);
+    void clear();
+    bool isEmpty() const;
+    qint64 size() const;
+    // compressed size in bytes
+    qint64 memoryUsage() const;
+    QCPRange keyRange() const;
+    // Return the points in [lower, upper].
+    // If there are more than maxPoints points, the range is split into maxPoints/2 buckets and the min/max of each bucket is returned.
+    QVector<QCPGraphData> query(double lower, double upper, int maxPoints) const;
+private:
+    struct Block
+    {
+        QByteArray bits;
+        qint64 bitNum = 0;
+        int count = 0;
+        // keys like counters and msecs/1000.0 are stored as integral ticks with delta-of-delta encoding,
+        // other keys are XOR encoded like values
+        bool tickKeys = true;
+
+        double minKey = 0;
+        double maxKey = 0;
+        double minValue = 0;
+        double minValueKey = 0;
+        double maxValue = 0;
+        double maxValueKey = 0;
+
+        // encoder state
+        qint64 lastTick = 0;
+        qint64 lastDelta = 0;
+        quint64 lastKeyBits = 0;
+        int keyLeading = -1;
+        int keyTrailing = 0;
+        quint64 lastValueBits = 0;
+        int valueLeading = -1;
+        int valueTrailing = 0;
+    };
+
+    class BitReader
+    {
+    public:
+        explicit BitReader(const QByteArray& bits);
+        quint64 read(int n);
+        bool readBit();
+    private:
+        const QByteArray& m_bits;
+        qint64 m_pos = 0;
+    };
+
+    static const int m_blockPointNum = 1024;
+    static const qint64 m_tickPerKey = 1000;
+
+    QVector<Block> m_blocks;
+    qint64 m_size = 0;
+
+    static void write(Block& block, quint64 value, int n);
+    static void writeXOR(Block& block, quint64 value, quint64& last, int& leading, int& trailing);
+    static quint64 readXOR(BitReader& reader, quint64& last, int& leading, int& trailing);
+    static void writeDeltaOfDelta(Block& block, qint64 dod);
+    static qint64 readDeltaOfDelta(BitReader& reader);
+    static bool toTick(double key, qint64* tick);
+    static quint64 toBits(double val);
+    static double fromBits(quint64 bits);
+    void decode(const Block& block, QVector<QCPGraphData>& result, double lower, double upper) const;
+};
+
+#endif // PLOTHISTORY_H
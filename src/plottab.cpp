@@ -2,6 +2,9 @@
 #include "ui_plottab.h"
 
 #include "legenditemdialog.h"
+#include "metrics.h"
+
+#include <QDateTime>
 
 PlotTab::PlotTab(QWidget *parent) :
     QWidget(parent),
@@ -38,6 +41,7 @@ void PlotTab::initSettings()
     connect(ui->plot_clearFlagTypeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &PlotTab::savePlotPreference);
     connect(ui->plot_clearFlagEdit, &QLineEdit::editingFinished, this, &PlotTab::savePlotPreference);
     connect(ui->plot_plotStyleBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &PlotTab::savePlotPreference);
+    connect(ui->plot_CANSignalEdit, &QLineEdit::editingFinished, this, &PlotTab::savePlotPreference);
 
 }
 
@@ -202,6 +206,7 @@ void PlotTab::changeGraphNum(int newNum)
         for(int i = 0; i < delta; i++)
             ui->qcpWidget->removeGraph(ui->qcpWidget->graphCount() - 1);
     }
+    m_history.resize(ui->qcpWidget->graphCount());
 }
 
 void PlotTab::on_plot_clearButton_clicked()
@@ -218,6 +223,9 @@ void PlotTab::clearGraph()
     num = ui->qcpWidget->graphCount();
     for(int i = 0; i < num; i++)
         ui->qcpWidget->graph(i)->data()->clear(); // use data()->clear() rather than data().clear()
+    for(PlotHistory& history : m_history)
+        history.clear();
+    m_historyLoaded = false;
     plotBuf->clear();
     ui->qcpWidget->replot();
 }
@@ -263,7 +271,23 @@ void PlotTab::on_plot_tracerCheckBox_stateChanged(int arg1)
 
 void PlotTab::on_plot_fitXButton_clicked()
 {
-    ui->qcpWidget->xAxis->rescale(true);
+    // rescale() only sees the points in the graphs, the older points are in the history
+    bool hasHistory = false;
+    QCPRange range;
+    for(const PlotHistory& history : qAsConst(m_history))
+    {
+        if(history.isEmpty())
+            continue;
+        if(hasHistory)
+            range.expand(history.keyRange());
+        else
+            range = history.keyRange();
+        hasHistory = true;
+    }
+    if(hasHistory && isHistoryNeeded(range.lower))
+        ui->qcpWidget->xAxis->setRange(range); // the history is loaded in onXAxisChangedByUser()
+    else
+        ui->qcpWidget->xAxis->rescale(true);
     ui->qcpWidget->replot();
 }
 
@@ -429,6 +453,48 @@ void PlotTab::on_plot_plotStyleBox_currentIndexChanged(int index)
 void PlotTab::onXAxisChangedByUser(const QCPRange &newRange)
 {
     plotXAxisWidth = newRange.size();
+    if(m_historyLoaded)
+    {
+        // reload if the range is moved out or zoomed in too much
+        if(newRange.lower >= m_historyRange.lower && newRange.upper <= m_historyRange.upper && newRange.size() * 6 >= m_historyRange.size())
+            return;
+    }
+    else if(!isHistoryNeeded(newRange.lower))
+        return;
+    // load one more screen on each side, so a small drag doesn't trigger decoding
+    const double margin = newRange.size();
+    loadHistory(QCPRange(newRange.lower - margin, newRange.upper + margin), ui->qcpWidget->axisRect()->width() * 3 * 2);
+    m_historyLoaded = true;
+}
+
+bool PlotTab::isHistoryNeeded(double lower)
+{
+    for(int i = 0; i < ui->qcpWidget->graphCount() && i < m_history.size(); i++)
+    {
+        QSharedPointer<QCPGraphDataContainer> data = ui->qcpWidget->graph(i)->data();
+        // some points are trimmed from the graph
+        if(m_history[i].size() > data->size() && (data->isEmpty() || lower < data->constBegin()->key))
+            return true;
+    }
+    return false;
+}
+
+void PlotTab::loadHistory(const QCPRange& range, int maxPoints)
+{
+    for(int i = 0; i < ui->qcpWidget->graphCount() && i < m_history.size(); i++)
+        ui->qcpWidget->graph(i)->data()->set(m_history[i].query(range.lower, range.upper, maxPoints), true);
+    m_historyRange = range;
+}
+
+void PlotTab::trimGraph()
+{
+    for(int i = 0; i < ui->qcpWidget->graphCount(); i++)
+    {
+        QSharedPointer<QCPGraphDataContainer> data = ui->qcpWidget->graph(i)->data();
+        // trim in batches, removeBefore() moves the data
+        if(data->size() > m_hotPointNum + m_hotPointNum / 4)
+            data->removeBefore((data->constEnd() - m_hotPointNum)->key);
+    }
 }
 
 void PlotTab::saveGraphProperty()
@@ -472,6 +538,7 @@ void PlotTab::savePlotPreference()
     settings->setValue("ClearF_Type", ui->plot_clearFlagTypeBox->currentIndex());
     settings->setValue("ClearF_Context", ui->plot_clearFlagEdit->text());
     settings->setValue("PlotStyle", ui->plot_plotStyleBox->currentIndex());
+    settings->setValue("CAN_Signals", ui->plot_CANSignalEdit->text());
     settings->endGroup();
 }
 
@@ -505,6 +572,7 @@ void PlotTab::loadPreference()
     ui->plot_clearFlagTypeBox->setCurrentIndex(settings->value("ClearF_Type", 1).toInt());
     ui->plot_clearFlagEdit->setText(settings->value("ClearF_Context", "cls").toString());
     ui->plot_plotStyleBox->setCurrentIndex(settings->value("PlotStyle", 0).toInt());
+    ui->plot_CANSignalEdit->setText(settings->value("CAN_Signals", "").toString());
     colorList = settings->value("GraphColor", QStringList()).toStringList();
     nameList = settings->value("GraphName", QStringList()).toStringList();
     settings->endGroup();
@@ -514,6 +582,7 @@ void PlotTab::loadPreference()
     on_plot_frameSpTypeBox_currentIndexChanged(ui->plot_frameSpTypeBox->currentIndex());
     on_plot_dataSpTypeBox_currentIndexChanged(ui->plot_dataSpTypeBox->currentIndex());
     on_plot_clearFlagTypeBox_currentIndexChanged(ui->plot_clearFlagTypeBox->currentIndex());
+    on_plot_CANSignalEdit_editingFinished();
     // don't use ui->plot_dataNumBox->value() there, the actural num of graphs might be value() or value()-1
     nameNum = ui->qcpWidget->graphCount();
     colorNum = nameNum < colorList.size() ? nameNum : colorList.size();
@@ -530,6 +599,14 @@ bool PlotTab::enabled()
     return ui->plot_enaBox->isChecked();
 }
 
+qint64 PlotTab::historyMemoryUsage() const
+{
+    qint64 result = 0;
+    for(const PlotHistory& history : m_history)
+        result += history.memoryUsage();
+    return result;
+}
+
 void PlotTab::newData(const QByteArray& data)
 {
     plotBuf->append(decoder->toUnicode(data));
@@ -559,19 +636,19 @@ void PlotTab::processData()
         {
             currKey = plotCounter;
             for(i = 0; i < ui->plot_dataNumBox->value() && i < dataList.length(); i++)
-                ui->qcpWidget->graph(i)->addData(currKey, toDouble(dataList[i]));
+                addPoint(i, currKey, toDouble(dataList[i]));
         }
         else if(ui->plot_XTypeBox->currentIndex() == 1)
         {
             currKey = toDouble(dataList[0]);
             for(i = 1; i < ui->plot_dataNumBox->value() && i < dataList.length(); i++)
-                ui->qcpWidget->graph(i - 1)->addData(currKey, toDouble(dataList[i]));
+                addPoint(i - 1, currKey, toDouble(dataList[i]));
         }
         else if(ui->plot_XTypeBox->currentIndex() == 2)
         {
             currKey = plotTime.msecsTo(QTime::currentTime()) / 1000.0;
             for(i = 0; i < ui->plot_dataNumBox->value() && i < dataList.length(); i++)
-                ui->qcpWidget->graph(i)->addData(currKey, toDouble(dataList[i]));
+                addPoint(i, currKey, toDouble(dataList[i]));
         }
         QApplication::processEvents();
 
@@ -585,18 +662,167 @@ void PlotTab::processData()
         }
         return;
     }
-    else if(ui->plot_latestBox->isChecked())
+    afterDataAdded(currKey);
+}
+
+void PlotTab::afterDataAdded(double currKey)
+{
+    if(ui->plot_latestBox->isChecked())
     {
+        // the graphs show an older range, switch back to the latest points
+        if(m_historyLoaded)
+        {
+            loadHistory(QCPRange(currKey - plotXAxisWidth * 2, currKey), m_hotPointNum);
+            m_historyLoaded = false;
+        }
+        trimGraph();
         ui->qcpWidget->xAxis->blockSignals(true);
         ui->qcpWidget->xAxis->setRange(currKey, plotXAxisWidth, Qt::AlignRight);
         ui->qcpWidget->xAxis->blockSignals(false);
         if(ui->plot_tracerCheckBox->isChecked())
             updateTracer(currKey);
     }
+    else if(!m_historyLoaded)
+    {
+        // the graphs never keep more than the hot points, PlotHistory is the only full copy
+        trimGraph();
+        // the trimmed points might be in the view
+        onXAxisChangedByUser(ui->qcpWidget->xAxis->range());
+    }
     ui->qcpWidget->replot(QCustomPlot::rpQueuedReplot);
 }
 
-void PlotTab::setDecoder(QTextDecoder *decoder)
+void PlotTab::newFrames(const QByteArray& data, const QVector<Metadata>& frames)
+{
+    // Frames are decoded with m_CANSignals directly, the text parser is bypassed.
+    // The i-th signal is drawn in the i-th graph.
+    double currKey = 0, value;
+    bool hasData = false;
+    qint64 offset = 0;
+    const int graphNum = ui->qcpWidget->graphCount();
+    if(m_CANSignals.isEmpty())
+        return;
+    for(const Metadata& frame : frames)
+    {
+        const char* payload = data.constData() + offset;
+        offset += frame.len;
+        // CAN_ERR_FLAG, CAN_RTR_FLAG, the error frames and the remote frames carry no signal
+        if(frame.frameId & (0x20000000u | 0x40000000u))
+            continue;
+        const bool isExtended = frame.frameId & 0x80000000u; // CAN_EFF_FLAG
+        const quint32 id = frame.frameId & (isExtended ? 0x1FFFFFFFu : 0x7FFu); // CAN_EFF_MASK, CAN_SFF_MASK
+        bool counted = false;
+        for(int i = 0; i < m_CANSignals.size() && i < graphNum; i++)
+        {
+            const CANSignal& sig = m_CANSignals[i];
+            if(sig.isExtended != isExtended || sig.frameId != id || !extractCANSignal(sig, payload, frame.len, &value))
+                continue;
+            if(!counted)
+            {
+                plotCounter++;
+                counted = true;
+            }
+            if(ui->plot_XTypeBox->currentIndex() == 2)
+                currKey = plotTime.msecsTo(QDateTime::fromMSecsSinceEpoch(frame.timestamp).time()) / 1000.0;
+            else // there is no "first data" in a CAN frame, use counter
+                currKey = plotCounter;
+            addPoint(i, currKey, value);
+            hasData = true;
+        }
+    }
+    if(hasData)
+        afterDataAdded(currKey);
+}
+
+void PlotTab::addPoint(int graphId, double key, double value)
+{
+    // the range decoded from the history is not mixed with the raw points,
+    // the new points are shown after switching back to the latest points or reloading the range
+    if(!m_historyLoaded)
+        ui->qcpWidget->graph(graphId)->addData(key, value);
+    m_history[graphId].append(key, value);
+}
+
+bool PlotTab::extractCANSignal(const CANSignal& sig, const char* data, int len, double* value)
+{
+    quint64 raw = 0;
+    int pos = sig.startBit;
+    if(sig.length <= 0 || sig.length > 64)
+        return false;
+    for(int i = 0; i < sig.length; i++)
+    {
+        if(pos < 0 || pos / 8 >= len)
+            return false;
+        const quint64 bit = ((quint8)data[pos / 8] >> (pos % 8)) & 1;
+        if(sig.bigEndian)
+        {
+            // DBC Motorola order: MSB first, walk from bit 0 of a byte to bit 7 of the next byte
+            raw = (raw << 1) | bit;
+            pos = (pos % 8 == 0) ? pos + 15 : pos - 1;
+        }
+        else
+        {
+            raw |= bit << i;
+            pos++;
+        }
+    }
+    if(sig.isSigned && sig.length < 64 && (raw >> (sig.length - 1)) & 1)
+        raw |= ~0ULL << sig.length; // sign extension
+    *value = (sig.isSigned ? (double)(qint64)raw : (double)raw) * sig.factor + sig.offset;
+    return true;
+}
+
+void PlotTab::on_plot_CANSignalEdit_editingFinished()
+{
+    // ID:StartBit:Length[:le/be][:u/s][:Factor][:Offset];...
+    // like CAN_write(), an ID with 8 hex digits is an extended ID, so is an ID with 'x' suffix or above 0x7FF
+    m_CANSignals.clear();
+    const QStringList defList = ui->plot_CANSignalEdit->text().split(';');
+    for(const QString& def : defList)
+    {
+        if(def.trimmed().isEmpty())
+            continue;
+        const QStringList fields = def.trimmed().split(':');
+        CANSignal sig;
+        bool ok = (fields.size() >= 3);
+        if(ok)
+        {
+            QString id = fields[0].trimmed().toLower();
+            sig.isExtended = id.endsWith('x');
+            if(sig.isExtended)
+                id.chop(1);
+            if(id.startsWith("0x") && id.length() == 10)
+                sig.isExtended = true;
+            sig.frameId = id.toUInt(&ok, 0);
+            if(sig.frameId > 0x7FFu)
+                sig.isExtended = true;
+            ok = ok && sig.frameId <= 0x1FFFFFFFu;
+        }
+        if(ok)
+            sig.startBit = fields[1].toInt(&ok);
+        if(ok)
+            sig.length = fields[2].toInt(&ok);
+        int numIndex = 0; // the 1st number is factor, the 2nd number is offset
+        for(int i = 3; ok && i < fields.size(); i++)
+        {
+            const QString field = fields[i].trimmed().toLower();
+            if(field == "le" || field == "be")
+                sig.bigEndian = (field == "be");
+            else if(field == "u" || field == "s")
+                sig.isSigned = (field == "s");
+            else if(numIndex++ == 0)
+                sig.factor = field.toDouble(&ok);
+            else
+                sig.offset = field.toDouble(&ok);
+        }
+        if(ok && sig.length > 0 && sig.length <= 64)
+            m_CANSignals.append(sig);
+        else
+            qDebug() << "Invalid CAN signal definition:" << def;
+    }
+}
+
+void PlotTab::setDecoder(StreamDecoder *decoder)
 {
     if(this->decoder != nullptr)
         delete this->decoder;
@@ -659,5 +885,8 @@ void PlotTab::setGraphProperty(QCPAbstractLegendItem *item)
 
 inline double PlotTab::toDouble(const QString& str)
 {
-    return doubleRegex->match(str).captured().toDouble();
+    const QRegularExpressionMatch match = doubleRegex->match(str);
+    if(!match.hasMatch())
+        Metrics::add(Metrics::ParseFailures);
+    return match.captured().toDouble();
 }
@@ -6,6 +6,9 @@
 
 #include "mysettings.h"
 #include "mycustomplot.h"
+#include "metadata.h"
+#include "plothistory.h"
+#include "streamdecoder.h"
 
 namespace Ui
 {
@@ -24,9 +27,11 @@ public:
     void initSettings();
     void setReplotInterval(int msec);
     bool enabled();
+    qint64 historyMemoryUsage() const;
 public slots:
     void newData(const QByteArray &data);
-    void setDecoder(QTextDecoder* decoder);
+    void newFrames(const QByteArray &data, const QVector<Metadata>& frames);
+    void setDecoder(StreamDecoder* decoder);
     void onThemeChanged(const QString& themeName);
     void onClearBehaviorChanged(bool clearBoth);
     void onClearSignalReceived();
@@ -57,11 +62,24 @@ private slots:
     void on_plot_clearFlagTypeBox_currentIndexChanged(int index);
     void on_plot_clearFlagEdit_editingFinished();
     void on_plot_XTypeBox_currentIndexChanged(int index);
+    void on_plot_CANSignalEdit_editingFinished();
     void savePlotPreference();
     void loadPreference();
     void processData();
 
 private:
+    struct CANSignal
+    {
+        quint32 frameId = 0; // without EFF/RTR/ERR flags
+        bool isExtended = false; // 29-bit ID
+        int startBit = 0;
+        int length = 0;
+        bool bigEndian = false; // Motorola byte order, startBit is the MSB
+        bool isSigned = false;
+        double factor = 1.0;
+        double offset = 0.0;
+    };
+
     Ui::PlotTab *ui;
 
     QString* plotBuf;
@@ -80,7 +98,7 @@ private:
 
     QMap<QCPAbstractLegendItem*, ulong> longPressCounter;
 
-    QTextDecoder* decoder = nullptr;
+    StreamDecoder* decoder = nullptr;
     MySettings *settings;
     QRegularExpression* doubleRegex;
 
@@ -89,6 +107,15 @@ private:
 
     bool acceptClearSignal = false;
 
+    QVector<CANSignal> m_CANSignals;
+
+    // The full history of each graph is compressed there,
+    // the graphs only keep the latest m_hotPointNum points, or the range decoded from the history when the user views older data.
+    QVector<PlotHistory> m_history;
+    bool m_historyLoaded = false;
+    QCPRange m_historyRange;
+    static const int m_hotPointNum = 100000;
+
     void updateTracer(double x);
     QCPAbstractLegendItem *getLegendItemByPos(const QPointF &pos);
     void setGraphProperty(QCPAbstractLegendItem *item);
@@ -96,6 +123,12 @@ private:
     void saveGraphProperty();
     void changeGraphNum(int newNum);
     void clearGraph();
+    void afterDataAdded(double currKey);
+    void addPoint(int graphId, double key, double value);
+    bool isHistoryNeeded(double lower);
+    void loadHistory(const QCPRange& range, int maxPoints);
+    void trimGraph();
+    static bool extractCANSignal(const CANSignal& sig, const char* data, int len, double* value);
 };
 
 #endif // PLOTTAB_H
@@ -0,0 +1,355 @@
+#include "rfc2217.h"
+
+#include <QtEndian>
+
+RFC2217::RFC2217(bool isServer)
+{
+    m_isServer = isServer;
+}
+
+void RFC2217::reset()
+{
+    m_state = DataState;
+    m_verb = 0;
+    m_subnegotiation.clear();
+    m_reply.clear();
+    m_commands.clear();
+    m_comPortEnabled = false;
+    m_sentWill.clear();
+    m_sentDo.clear();
+}
+
+QByteArray RFC2217::decode(const char* data, qint64 len)
+{
+    QByteArray result;
+    result.reserve(len);
+    const char* begin = data; // start of the current plain data run
+    for(qint64 i = 0; i < len; i++)
+    {
+        const quint8 c = data[i];
+        const State lastState = m_state;
+        switch(m_state)
+        {
+        case DataState:
+            if(c == IAC)
+            {
+                result.append(begin, data + i - begin);
+                m_state = IACState;
+            }
+            break;
+        case IACState:
+            if(c == IAC)
+            {
+                result.append((char)IAC);
+                m_state = DataState;
+            }
+            else if(c == WILL || c == WONT || c == DO || c == DONT)
+            {
+                m_verb = c;
+                m_state = NegotiationState;
+            }
+            else if(c == SB)
+            {
+                m_subnegotiation.clear();
+                m_state = SubnegotiationState;
+            }
+            else // NOP, GA and other single byte commands
+                m_state = DataState;
+            break;
+        case NegotiationState:
+            handleNegotiation(m_verb, c);
+            m_state = DataState;
+            break;
+        case SubnegotiationState:
+            if(c == IAC)
+                m_state = SubnegotiationIACState;
+            else
+                m_subnegotiation.append((char)c);
+            break;
+        case SubnegotiationIACState:
+            if(c == SE)
+            {
+                handleSubnegotiation();
+                m_state = DataState;
+            }
+            else
+            {
+                // IAC IAC in subnegotiation
+                m_subnegotiation.append((char)c);
+                m_state = SubnegotiationState;
+            }
+            break;
+        }
+        if(lastState != DataState && m_state == DataState)
+            begin = data + i + 1;
+    }
+    if(m_state == DataState)
+        result.append(begin, data + len - begin);
+    return result;
+}
+
+QByteArray RFC2217::takeReply()
+{
+    QByteArray result = m_reply;
+    m_reply.clear();
+    return result;
+}
+
+QList<RFC2217::ComPortCommand> RFC2217::takeCommands()
+{
+    QList<ComPortCommand> result = m_commands;
+    m_commands.clear();
+    return result;
+}
+
+bool RFC2217::comPortEnabled() const
+{
+    return m_comPortEnabled;
+}
+
+QByteArray RFC2217::encode(const char* data, qint64 len)
+{
+    QByteArray result;
+    result.reserve(len);
+    const char* begin = data;
+    for(qint64 i = 0; i < len; i++)
+    {
+        if((quint8)data[i] == IAC)
+        {
+            result.append(begin, data + i + 1 - begin);
+            result.append((char)IAC);
+            begin = data + i + 1;
+        }
+    }
+    result.append(begin, data + len - begin);
+    return result;
+}
+
+QByteArray RFC2217::comPortCommand(quint8 command, const QByteArray& value)
+{
+    QByteArray result;
+    result.append((char)IAC);
+    result.append((char)SB);
+    result.append((char)COM_PORT_OPTION);
+    result.append((char)command);
+    result.append(encode(value.constData(), value.size()));
+    result.append((char)IAC);
+    result.append((char)SE);
+    return result;
+}
+
+QByteArray RFC2217::comPortCommand(quint8 command, quint8 value)
+{
+    return comPortCommand(command, QByteArray(1, (char)value));
+}
+
+QByteArray RFC2217::comPortCommand(quint8 command, quint32 value)
+{
+    QByteArray buf(4, '\0');
+    qToBigEndian(value, buf.data());
+    return comPortCommand(command, buf);
+}
+
+QByteArray RFC2217::startNegotiation()
+{
+    QByteArray result;
+    const quint8 options[] = {BINARY, SGA, COM_PORT_OPTION};
+    for(quint8 option : options)
+    {
+        // the client offers the com port option, the server requests it
+        if(option != COM_PORT_OPTION || !m_isServer)
+        {
+            result.append((char)IAC).append((char)WILL).append((char)option);
+            m_sentWill.insert(option);
+        }
+        if(option != COM_PORT_OPTION || m_isServer)
+        {
+            result.append((char)IAC).append((char)DO).append((char)option);
+            m_sentDo.insert(option);
+        }
+    }
+    return result;
+}
+
+void RFC2217::handleNegotiation(quint8 verb, quint8 option)
+{
+    const bool supported = (option == BINARY || option == SGA || option == COM_PORT_OPTION);
+    // reply only when the state changes, otherwise both sides loop forever
+    if(verb == DO)
+    {
+        if(!supported)
+            m_reply.append((char)IAC).append((char)WONT).append((char)option);
+        else if(!m_sentWill.contains(option))
+        {
+            m_reply.append((char)IAC).append((char)WILL).append((char)option);
+            m_sentWill.insert(option);
+        }
+        if(option == COM_PORT_OPTION && !m_isServer)
+            m_comPortEnabled = true;
+    }
+    else if(verb == WILL)
+    {
+        if(!supported)
+            m_reply.append((char)IAC).append((char)DONT).append((char)option);
+        else if(!m_sentDo.contains(option))
+        {
+            m_reply.append((char)IAC).append((char)DO).append((char)option);
+            m_sentDo.insert(option);
+        }
+        if(option == COM_PORT_OPTION && m_isServer)
+            m_comPortEnabled = true;
+    }
+    else if(verb == DONT)
+    {
+        if(m_sentWill.remove(option))
+            m_reply.append((char)IAC).append((char)WONT).append((char)option);
+        if(option == COM_PORT_OPTION && !m_isServer)
+            m_comPortEnabled = false;
+    }
+    else if(verb == WONT)
+    {
+        if(m_sentDo.remove(option))
+            m_reply.append((char)IAC).append((char)DONT).append((char)option);
+        if(option == COM_PORT_OPTION && m_isServer)
+            m_comPortEnabled = false;
+    }
+}
+
+void RFC2217::handleSubnegotiation()
+{
+    if(m_subnegotiation.size() < 2 || (quint8)m_subnegotiation[0] != COM_PORT_OPTION)
+        return;
+    ComPortCommand command;
+    command.command = m_subnegotiation[1];
+    command.value = m_subnegotiation.mid(2);
+    m_commands.append(command);
+}
+
+quint8 RFC2217::fromParity(QSerialPort::Parity parity)
+{
+    switch(parity)
+    {
+    case QSerialPort::OddParity:
+        return 2;
+    case QSerialPort::EvenParity:
+        return 3;
+    case QSerialPort::MarkParity:
+        return 4;
+    case QSerialPort::SpaceParity:
+        return 5;
+    default:
+        return 1;
+    }
+}
+
+QSerialPort::Parity RFC2217::toParity(quint8 value)
+{
+    switch(value)
+    {
+    case 2:
+        return QSerialPort::OddParity;
+    case 3:
+        return QSerialPort::EvenParity;
+    case 4:
+        return QSerialPort::MarkParity;
+    case 5:
+        return QSerialPort::SpaceParity;
+    default:
+        return QSerialPort::NoParity;
+    }
+}
+
+quint8 RFC2217::fromStopBits(QSerialPort::StopBits stopBits)
+{
+    switch(stopBits)
+    {
+    case QSerialPort::TwoStop:
+        return 2;
+    case QSerialPort::OneAndHalfStop:
+        return 3;
+    default:
+        return 1;
+    }
+}
+
+QSerialPort::StopBits RFC2217::toStopBits(quint8 value)
+{
+    switch(value)
+    {
+    case 2:
+        return QSerialPort::TwoStop;
+    case 3:
+        return QSerialPort::OneAndHalfStop;
+    default:
+        return QSerialPort::OneStop;
+    }
+}
+
+quint8 RFC2217::fromFlowControl(QSerialPort::FlowControl flowControl)
+{
+    switch(flowControl)
+    {
+    case QSerialPort::SoftwareControl:
+        return FLOW_XONXOFF;
+    case QSerialPort::HardwareControl:
+        return FLOW_HARDWARE;
+    default:
+        return FLOW_NONE;
+    }
+}
+
+QSerialPort::FlowControl RFC2217::toFlowControl(quint8 value)
+{
+    switch(value)
+    {
+    case FLOW_XONXOFF:
+        return QSerialPort::SoftwareControl;
+    case FLOW_HARDWARE:
+        return QSerialPort::HardwareControl;
+    default:
+        return QSerialPort::NoFlowControl;
+    }
+}
+
+QSerialPort::PinoutSignals RFC2217::toPinoutSignals(quint8 modemState)
+{
+    QSerialPort::PinoutSignals result = QSerialPort::NoSignal;
+    if(modemState & CTS)
+        result |= QSerialPort::ClearToSendSignal;
+    if(modemState & DSR)
+        result |= QSerialPort::DataSetReadySignal;
+    if(modemState & RI)
+        result |= QSerialPort::RingIndicatorSignal;
+    if(modemState & CD)
+        result |= QSerialPort::DataCarrierDetectSignal;
+    return result;
+}
+
+quint8 RFC2217::fromPinoutSignals(QSerialPort::PinoutSignals signal)
+{
+    quint8 result = 0;
+    if(signal & QSerialPort::ClearToSendSignal)
+        result |= CTS;
+    if(signal & QSerialPort::DataSetReadySignal)
+        result |= DSR;
+    if(signal & QSerialPort::RingIndicatorSignal)
+        result |= RI;
+    if(signal & QSerialPort::DataCarrierDetectSignal)
+        result |= CD;
+    return result;
+}
+
+quint8 RFC2217::modemState(quint8 oldState, quint8 newState)
+{
+    quint8 result = newState & (CTS | DSR | RI | CD);
+    const quint8 changed = oldState ^ newState;
+    if(changed & CTS)
+        result |= DELTA_CTS;
+    if(changed & DSR)
+        result |= DELTA_DSR;
+    if(changed & CD)
+        result |= DELTA_CD;
+    if((oldState & RI) && !(newState & RI))
+        result |= TRAILING_EDGE_RI;
+    return result;
+}
@@ -0,0 +1,142 @@
+#ifndef RFC2217_H
+#define RFC2217_H
+
+#include <QByteArray>
+#include <QList>
+#include <QSet>
+#include <QSerialPort>
+
+// Telnet stream codec for RFC 2217 (Telnet Com Port Control Option)
+// This class doesn't own any socket, Connection feeds the raw stream into it.
+class RFC2217
+{
+public:
+    enum Telnet : quint8
+    {
+        SE = 240,
+        NOP = 241,
+        SB = 250,
+        WILL = 251,
+        WONT = 252,
+        DO = 253,
+        DONT = 254,
+        IAC = 255,
+    };
+
+    enum Option : quint8
+    {
+        BINARY = 0,
+        SGA = 3, // suppress go ahead
+        COM_PORT_OPTION = 44,
+    };
+
+    // client to server, server to client is (command + SERVER_OFFSET)
+    enum Command : quint8
+    {
+        SIGNATURE = 0,
+        SET_BAUDRATE = 1,
+        SET_DATASIZE = 2,
+        SET_PARITY = 3,
+        SET_STOPSIZE = 4,
+        SET_CONTROL = 5,
+        NOTIFY_LINESTATE = 6,
+        NOTIFY_MODEMSTATE = 7,
+        FLOWCONTROL_SUSPEND = 8,
+        FLOWCONTROL_RESUME = 9,
+        SET_LINESTATE_MASK = 10,
+        SET_MODEMSTATE_MASK = 11,
+        PURGE_DATA = 12,
+    };
+    static const quint8 SERVER_OFFSET = 100;
+
+    // values of SET_CONTROL
+    enum Control : quint8
+    {
+        FLOW_REQUEST = 0,
+        FLOW_NONE = 1,
+        FLOW_XONXOFF = 2,
+        FLOW_HARDWARE = 3,
+        BREAK_REQUEST = 4,
+        BREAK_ON = 5,
+        BREAK_OFF = 6,
+        DTR_REQUEST = 7,
+        DTR_ON = 8,
+        DTR_OFF = 9,
+        RTS_REQUEST = 10,
+        RTS_ON = 11,
+        RTS_OFF = 12,
+    };
+
+    // bits of NOTIFY_MODEMSTATE
+    enum ModemState : quint8
+    {
+        DELTA_CTS = 0x01,
+        DELTA_DSR = 0x02,
+        TRAILING_EDGE_RI = 0x04,
+        DELTA_CD = 0x08,
+        CTS = 0x10,
+        DSR = 0x20,
+        RI = 0x40,
+        CD = 0x80,
+    };
+
+    struct ComPortCommand
+    {
+        quint8 command;
+        QByteArray value;
+    };
+
+    explicit RFC2217(bool isServer = false);
+
+    void reset();
+    // remove Telnet commands from the raw stream and return the data
+    // replies for the option negotiation and the com port commands are collected, fetch them with takeReply() and takeCommands()
+    QByteArray decode(const char* data, qint64 len);
+    QByteArray takeReply();
+    QList<ComPortCommand> takeCommands();
+    bool comPortEnabled() const;
+
+    // escape IAC in data
+    static QByteArray encode(const char* data, qint64 len);
+    static QByteArray comPortCommand(quint8 command, const QByteArray& value);
+    static QByteArray comPortCommand(quint8 command, quint8 value);
+    static QByteArray comPortCommand(quint8 command, quint32 value);
+    // initial WILL/DO requests, the client offers COM-PORT-OPTION and the server requests it
+    QByteArray startNegotiation();
+
+    // conversions between QSerialPort enums and RFC 2217 values
+    static quint8 fromParity(QSerialPort::Parity parity);
+    static QSerialPort::Parity toParity(quint8 value);
+    static quint8 fromStopBits(QSerialPort::StopBits stopBits);
+    static QSerialPort::StopBits toStopBits(quint8 value);
+    static quint8 fromFlowControl(QSerialPort::FlowControl flowControl);
+    static QSerialPort::FlowControl toFlowControl(quint8 value);
+    static QSerialPort::PinoutSignals toPinoutSignals(quint8 modemState);
+    static quint8 fromPinoutSignals(QSerialPort::PinoutSignals signal);
+    // fill the delta bits for NOTIFY_MODEMSTATE
+    static quint8 modemState(quint8 oldState, quint8 newState);
+private:
+    enum State
+    {
+        DataState = 0,
+        IACState,
+        NegotiationState, // after WILL/WONT/DO/DONT
+        SubnegotiationState,
+        SubnegotiationIACState,
+    };
+
+    bool m_isServer;
+    State m_state = DataState;
+    quint8 m_verb = 0;
+    QByteArray m_subnegotiation;
+    QByteArray m_reply;
+    QList<ComPortCommand> m_commands;
+    bool m_comPortEnabled = false;
+    QSet<quint8> m_sentWill;
+    QSet<quint8> m_sentDo;
+
+    void handleNegotiation(quint8 verb, quint8 option);
+    void handleSubnegotiation();
+};
+
+#endif // RFC2217_H
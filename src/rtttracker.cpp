@@ -0,0 +1,249 @@
+#include "rtttracker.h"
+#include "metrics.h"
+
+#include <QElapsedTimer>
+#include <cstring>
+
+void RttTracker::setMode(Mode mode)
+{
+    m_mode = mode;
+    reset();
+}
+
+RttTracker::Mode RttTracker::mode() const
+{
+    return m_mode;
+}
+
+void RttTracker::setSequenceField(int offset, int size, bool bigEndian)
+{
+    m_offset = offset;
+    m_size = size;
+    m_bigEndian = bigEndian;
+    reset();
+}
+
+void RttTracker::setRegExp(const QString& pattern)
+{
+    m_regExp.setPattern(pattern);
+    m_regExp.optimize();
+    reset();
+}
+
+void RttTracker::setTimeout(int timeout)
+{
+    m_timeout = timeout * 1000000LL;
+}
+
+void RttTracker::reset()
+{
+    m_pending.clear();
+    m_earlyResponses.clear();
+    m_echoMatchedLen = 0;
+    m_echoChunks.clear();
+    m_echoOffset = 0;
+    m_echoBufSize = 0;
+    m_histogram.clear();
+    m_timeoutNum = 0;
+}
+
+qint64 RttTracker::now()
+{
+    // the initialization of a local static is thread safe
+    static const QElapsedTimer clock = []()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
+
+void RttTracker::sent(const QByteArray& data, qint64 timestamp)
+{
+    if(m_mode == Disabled || data.isEmpty())
+        return;
+    expire(timestamp);
+    Request request;
+    request.sequence = 0;
+    request.timestamp = timestamp;
+    if(m_mode == Echo)
+        request.data = data;
+    else if(m_mode == Sequence && !readSequence(data.constData(), data.size(), &request.sequence))
+        return;
+
+    // the response might be processed before the request
+    for(int i = 0; i < m_earlyResponses.size(); i++)
+    {
+        const Request& response = m_earlyResponses[i];
+        if(response.timestamp >= timestamp && (m_mode != Sequence || response.sequence == request.sequence))
+        {
+            record(response.timestamp - timestamp);
+            m_earlyResponses.removeAt(i);
+            return;
+        }
+    }
+    if(m_pending.size() >= m_maxPendingNum)
+    {
+        m_pending.dequeue();
+        m_echoMatchedLen = 0;
+        m_timeoutNum++;
+    }
+    m_pending.enqueue(request);
+    // the echo might be processed before the request
+    if(m_mode == Echo)
+        matchEcho();
+}
+
+void RttTracker::received(const char* data, qint64 len, qint64 timestamp)
+{
+    if(m_mode != Echo || len <= 0)
+        return;
+    expire(timestamp);
+    Chunk chunk;
+    chunk.data = QByteArray(data, len);
+    chunk.timestamp = timestamp;
+    m_echoChunks.enqueue(chunk);
+    m_echoBufSize += len;
+    matchEcho();
+    // the unmatched data is kept only if no request is pending
+    while(m_echoBufSize > m_maxEchoBufSize)
+        dropEchoChunk();
+}
+
+void RttTracker::matchEcho()
+{
+    while(!m_pending.isEmpty() && !m_echoChunks.isEmpty())
+    {
+        const Chunk& chunk = m_echoChunks.head();
+        const char* data = chunk.data.constData();
+        const qint64 len = chunk.data.size();
+        const QByteArray expected = m_pending.head().data;
+        qint64 i = m_echoOffset;
+        // received before the request is sent, not the echo of it
+        if(chunk.timestamp < m_pending.head().timestamp)
+            i = len;
+        while(i < len)
+        {
+            if(m_echoMatchedLen == 0)
+            {
+                // skip to the first byte of the echo
+                const char* found = (const char*)memchr(data + i, expected[0], len - i);
+                if(found == nullptr)
+                {
+                    i = len;
+                    break;
+                }
+                i = found - data;
+            }
+            if(data[i] == expected[m_echoMatchedLen])
+            {
+                i++;
+                if(++m_echoMatchedLen == expected.size())
+                {
+                    record(chunk.timestamp - m_pending.dequeue().timestamp);
+                    m_echoMatchedLen = 0;
+                    // the next request might be sent later than this chunk
+                    break;
+                }
+            }
+            else
+                m_echoMatchedLen = 0; // this byte might be the start of the echo
+        }
+        m_echoBufSize -= i - m_echoOffset;
+        m_echoOffset = i;
+        if(m_echoOffset >= len)
+        {
+            m_echoChunks.dequeue();
+            m_echoOffset = 0;
+        }
+    }
+}
+
+void RttTracker::dropEchoChunk()
+{
+    m_echoBufSize -= m_echoChunks.dequeue().data.size() - m_echoOffset;
+    m_echoOffset = 0;
+    m_echoMatchedLen = 0;
+}
+
+void RttTracker::receivedFrame(const char* data, qint64 len, qint64 timestamp)
+{
+    if(m_mode != Sequence && m_mode != RegExp)
+        return;
+    expire(timestamp);
+    Request response;
+    response.sequence = 0;
+    response.timestamp = timestamp;
+    if(m_mode == Sequence)
+    {
+        if(!readSequence(data, len, &response.sequence))
+            return;
+        for(int i = 0; i < m_pending.size(); i++)
+        {
+            if(m_pending[i].sequence == response.sequence)
+            {
+                record(timestamp - m_pending[i].timestamp);
+                m_pending.removeAt(i);
+                return;
+            }
+        }
+    }
+    else
+    {
+        if(!m_regExp.match(QString::fromUtf8(data, len)).hasMatch())
+            return;
+        if(!m_pending.isEmpty())
+        {
+            record(timestamp - m_pending.dequeue().timestamp);
+            return;
+        }
+    }
+    if(m_earlyResponses.size() < m_maxPendingNum)
+        m_earlyResponses.enqueue(response);
+}
+
+const LatencyHistogram& RttTracker::histogram() const
+{
+    return m_histogram;
+}
+
+quint64 RttTracker::timeoutNum() const
+{
+    return m_timeoutNum;
+}
+
+void RttTracker::expire(qint64 timestamp)
+{
+    while(!m_pending.isEmpty() && timestamp - m_pending.head().timestamp > m_timeout)
+    {
+        m_pending.dequeue();
+        m_echoMatchedLen = 0;
+        m_timeoutNum++;
+    }
+    while(!m_earlyResponses.isEmpty() && timestamp - m_earlyResponses.head().timestamp > m_earlyResponseWindow)
+        m_earlyResponses.dequeue();
+    // a pending request consumes the chunks, so only the early echoes are dropped
+    while(m_pending.isEmpty() && !m_echoChunks.isEmpty() && timestamp - m_echoChunks.head().timestamp > m_earlyResponseWindow)
+        dropEchoChunk();
+}
+
+void RttTracker::record(qint64 rtt)
+{
+    // in us
+    m_histogram.record(rtt / 1000);
+    Metrics::observe(Metrics::RoundTripTime, rtt / 1000);
+}
+
+bool RttTracker::readSequence(const char* data, qint64 len, quint64* sequence) const
+{
+    if(m_offset + m_size > len)
+        return false;
+    *sequence = 0;
+    for(int i = 0; i < m_size; i++)
+    {
+        const quint8 byte = data[m_offset + (m_bigEndian ? i : m_size - 1 - i)];
+        *sequence = (*sequence << 8) | byte;
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef RTTTRACKER_H
+#define RTTTRACKER_H
+
+#include <QByteArray>
+#include <QQueue>
+#include <QRegularExpression>
+
+#include "latencyhistogram.h"
+
+// Matches the sent requests with the echoes or the responses that follow in the received data,
+// and records the round-trip times in a LatencyHistogram.
+// Echo and RegExp: a response is for the oldest pending request, the echo is expected in order.
+// Sequence: the response has the same sequence field as the request, so they can be out of order.
+// The timestamps are in ns from now(), a monotonic clock shared by the sending thread and the main thread.
+// The repeated requests are reported by TxScheduler in batches, so the responses and the echo bytes
+// received before their requests are kept for a short while.
+class RttTracker
+{
+public:
+    enum Mode
+    {
+        Disabled = 0,
+        Echo,
+        Sequence,
+        RegExp,
+    };
+
+    void setMode(Mode mode);
+    Mode mode() const;
+    // the field is at the same offset in the requests and the responses, size: 1, 2 or 4
+    void setSequenceField(int offset, int size, bool bigEndian);
+    // a received frame matching it is a response, in UTF-8
+    void setRegExp(const QString& pattern);
+    // the requests without response are dropped after timeout(ms)
+    void setTimeout(int timeout);
+    void reset();
+
+    // thread safe, ns since an unspecified reference
+    static qint64 now();
+    void sent(const QByteArray& data, qint64 timestamp);
+    // Echo, the received stream chunk by chunk
+    void received(const char* data, qint64 len, qint64 timestamp);
+    // Sequence and RegExp, a received frame, or a chunk if the frames are not split
+    void receivedFrame(const char* data, qint64 len, qint64 timestamp);
+
+    const LatencyHistogram& histogram() const;
+    quint64 timeoutNum() const;
+private:
+    struct Request
+    {
+        QByteArray data; // Echo only
+        quint64 sequence;
+        qint64 timestamp;
+    };
+    struct Chunk
+    {
+        QByteArray data;
+        qint64 timestamp;
+    };
+    static const int m_maxPendingNum = 65536;
+    static const qint64 m_maxEchoBufSize = 65536;
+    // in ns, longer than the reporting interval of TxScheduler
+    static const qint64 m_earlyResponseWindow = 200000000;
+
+    Mode m_mode = Disabled;
+    int m_offset = 0;
+    int m_size = 1;
+    bool m_bigEndian = false;
+    QRegularExpression m_regExp;
+    qint64 m_timeout = 5000000000;
+
+    QQueue<Request> m_pending;
+    // the responses without a pending request, Request::data is not used
+    QQueue<Request> m_earlyResponses;
+    int m_echoMatchedLen = 0;
+    // the received data not matched yet, Echo only
+    QQueue<Chunk> m_echoChunks;
+    qint64 m_echoOffset = 0; // in m_echoChunks.head()
+    qint64 m_echoBufSize = 0;
+    LatencyHistogram m_histogram;
+    quint64 m_timeoutNum = 0;
+
+    void expire(qint64 timestamp);
+    void matchEcho();
+    void dropEchoChunk();
+    void record(qint64 rtt);
+    bool readSequence(const char* data, qint64 len, quint64* sequence) const;
+};
+
+#endif // RTTTRACKER_H
@@ -0,0 +1,629 @@
+#include "rxdatamodel.h"
+#include "rxindexbuilder.h"
+#include "rxsearcher.h"
+#include "captureindex.h"
+#include "hexformatter.h"
+#include "streamdecoder.h"
+
+#include <QColor>
+#include <algorithm>
+#include <cstring>
+
+RxDataModel::RxDataModel(const QByteArray* RxBuf, const QVector<Metadata>* RxMetadataBuf, QObject *parent)
+    : QAbstractListModel{parent}
+{
+    m_RxBuf = RxBuf;
+    m_RxMetadataBuf = RxMetadataBuf;
+    m_rowBegin.append(0);
+
+    m_builderThread = new QThread(this);
+    m_builder = new RxIndexBuilder();
+    m_builder->moveToThread(m_builderThread);
+    connect(m_builder, &RxIndexBuilder::rowsIndexed, this, &RxDataModel::onRowsIndexed);
+    connect(m_builderThread, &QThread::finished, m_builder, &QObject::deleteLater);
+    m_builderThread->start();
+
+    m_searcherThread = new QThread(this);
+    m_searcher = new RxSearcher();
+    m_searcher->moveToThread(m_searcherThread);
+    connect(m_searcher, &RxSearcher::found, this, &RxDataModel::onMatchesFound);
+    connect(m_searcherThread, &QThread::finished, m_searcher, &QObject::deleteLater);
+    m_searcherThread->start();
+}
+
+RxDataModel::~RxDataModel()
+{
+    m_builder->restart();
+    m_builderThread->quit();
+    m_builderThread->wait();
+    m_searcher->restart();
+    m_searcherThread->quit();
+    m_searcherThread->wait();
+}
+
+int RxDataModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return m_rowCount;
+}
+
+QVariant RxDataModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= m_rowCount)
+        return QVariant();
+    if(role == Qt::DisplayRole)
+        return rowText(index.row());
+    else if(role == Qt::BackgroundRole && !m_matches.isEmpty())
+    {
+        qint64 begin, end;
+        rowRange(index.row(), &begin, &end);
+        const int id = matchIn(begin, end);
+        if(id == -1)
+            return QVariant();
+        // the current match might not be the first one in this row
+        const bool isCurrent = m_currentMatch >= 0 && m_matches[m_currentMatch].first < end && m_matches[m_currentMatch].second > begin;
+        return QColor(255, 192, 0, isCurrent ? 192 : 64);
+    }
+    return QVariant();
+}
+
+void RxDataModel::setHexEnabled(bool enabled)
+{
+    m_hexEnabled = enabled;
+    rebuild();
+}
+
+void RxDataModel::setTimestampEnabled(bool enabled)
+{
+    m_timestampEnabled = enabled;
+    rebuild();
+}
+
+void RxDataModel::setFrameSplitEnabled(bool enabled)
+{
+    if(m_frameSplitEnabled == enabled)
+        return;
+    m_frameSplitEnabled = enabled;
+    rebuild();
+}
+
+void RxDataModel::setCodec(QTextCodec* codec)
+{
+    // the rows are not changed
+    beginResetModel();
+    m_codec = codec;
+    endResetModel();
+}
+
+void RxDataModel::setLatestFirst(bool enabled)
+{
+    m_latestFirst = enabled;
+}
+
+bool RxDataModel::isBuilding() const
+{
+    return m_isBuilding;
+}
+
+QString RxDataModel::rowText(int row) const
+{
+    qint64 begin, end;
+    rowRange(row, &begin, &end);
+    QString result;
+    if(m_hexEnabled)
+    {
+        // the timestamp takes the place of the offset
+        const int flags = m_timestampEnabled ? HexFormatter::ASCII : (HexFormatter::Offset | HexFormatter::ASCII);
+        result = HexFormatter::row(m_RxBuf->constData() + begin, end - begin, begin, m_hexRowLen, flags);
+    }
+    else
+    {
+        // A character split at the end of the previous row (a Metadata boundary or a wrapped long row)
+        // is shown at the beginning of this row, so the previous row is decoded first to get the state.
+        // The whole row gives GBK/Shift-JIS enough context to find the lead bytes.
+        StreamDecoder decoder(m_codec);
+        if(row > 0)
+        {
+            qint64 prevBegin, prevEnd;
+            rowRange(row - 1, &prevBegin, &prevEnd);
+            decoder.toUnicode(m_RxBuf->constData() + prevBegin, prevEnd - prevBegin);
+        }
+        result = decoder.toUnicode(m_RxBuf->constData() + begin, end - begin);
+        if(result.endsWith('\n'))
+            result.chop(1);
+        if(result.endsWith('\r'))
+            result.chop(1);
+    }
+    if(m_timestampEnabled)
+    {
+        // only the first row of a Metadata has the timestamp
+        const Metadata* item = metadataAt(begin);
+        if(item != nullptr && item->pos == begin)
+            result = m_timestampFormatter.withTimestamp(result, item->timestamp);
+    }
+    return result;
+}
+
+QString RxDataModel::rowsText(int first, int last) const
+{
+    QString result;
+    for(int i = first; i <= last && i < m_rowCount; i++)
+    {
+        result += rowText(i);
+        if(i != last)
+            result += '\n';
+    }
+    return result;
+}
+
+void RxDataModel::sync()
+{
+    const qint64 size = m_RxBuf->size();
+    if(size < m_indexedSize || size < m_fedSize || m_RxMetadataBuf->size() < m_metadataNum)
+    {
+        // cleared
+        m_lineIndex.clear();
+        m_lineIndex.update(*m_RxBuf);
+        // the new data is searched with the same pattern
+        if(!m_searchPattern.isEmpty())
+            startSearch(m_searchPattern, m_isRegExpSearch);
+        rebuild();
+        return;
+    }
+    m_metadataNum = m_RxMetadataBuf->size();
+    m_lineIndex.update(*m_RxBuf);
+    if(!m_searchPattern.isEmpty() && size > m_searchEnd && m_matches.size() < m_maxMatchNum)
+        searchNewData(size);
+    // the rows are added by m_builder
+    if(m_isBuilding && m_buildEnd < 0)
+        return;
+    if(size == m_indexedSize)
+        return;
+    indexData(size);
+    insertNewRows();
+}
+
+void RxDataModel::rebuild()
+{
+    beginResetModel();
+    m_generation = m_builder->restart();
+    m_pendingChunkNum = 0;
+    m_fedSize = 0;
+    m_headRowBegin.clear();
+    m_metadataNum = m_RxMetadataBuf->size();
+    const qint64 size = m_RxBuf->size();
+    m_isBuilding = isIndexed() && size > m_syncBuildSize;
+    m_buildEnd = (m_isBuilding && m_latestFirst) ? findTailBegin(size) : -1;
+    // the tail is indexed there, then shown before the rest is ready
+    const qint64 begin = qMax(m_buildEnd, (qint64)0);
+    m_rowBegin.clear();
+    m_rowBegin.append(begin);
+    m_scanner = RowScanner(m_hexEnabled, isSplitAtMetadata(), begin);
+    m_indexedSize = begin;
+    if(!m_isBuilding || m_buildEnd >= 0)
+        indexData(size);
+    m_rowCount = indexedRowCount();
+    endResetModel();
+
+    if(m_isBuilding)
+    {
+        if(m_buildEnd >= 0)
+            m_headRowBegin.append(0);
+        QMetaObject::invokeMethod(m_builder, "start", Qt::QueuedConnection, Q_ARG(bool, m_hexEnabled), Q_ARG(bool, isSplitAtMetadata()), Q_ARG(int, m_generation));
+        feedBuilder();
+    }
+}
+
+void RxDataModel::onRowsIndexed(const QVector<qint64>& boundaries, qint64 end, int generation)
+{
+    if(generation != m_generation)
+        return;
+    m_pendingChunkNum--;
+    if(m_buildEnd >= 0)
+    {
+        m_headRowBegin += boundaries;
+        if(end < m_buildEnd)
+        {
+            feedBuilder();
+            return;
+        }
+        // put the head before the tail
+        beginResetModel();
+        while(!m_headRowBegin.isEmpty() && m_headRowBegin.last() >= m_buildEnd)
+            m_headRowBegin.removeLast();
+        m_headRowBegin += m_rowBegin;
+        m_rowBegin.swap(m_headRowBegin);
+        m_headRowBegin.clear();
+        m_headRowBegin.squeeze();
+        m_isBuilding = false;
+        m_buildEnd = -1;
+        m_fedSize = 0;
+        m_rowCount = indexedRowCount();
+        endResetModel();
+        return;
+    }
+
+    m_rowBegin += boundaries;
+    m_indexedSize = end;
+    if(end >= m_RxBuf->size() && m_pendingChunkNum == 0)
+    {
+        // caught up, the new data is indexed in sync() again
+        m_isBuilding = false;
+        m_fedSize = 0;
+        m_scanner = RowScanner(m_hexEnabled, isSplitAtMetadata(), m_rowBegin.last());
+    }
+    else
+        feedBuilder();
+    insertNewRows();
+}
+
+void RxDataModel::insertNewRows()
+{
+    const int oldCount = m_rowCount;
+    const int newCount = indexedRowCount();
+    // the last row might get longer
+    if(oldCount > 0)
+        emit dataChanged(index(oldCount - 1), index(oldCount - 1));
+    if(newCount > oldCount)
+    {
+        beginInsertRows(QModelIndex(), oldCount, newCount - 1);
+        m_rowCount = newCount;
+        endInsertRows();
+    }
+}
+
+void RxDataModel::feedBuilder()
+{
+    // copy a few chunks at a time, so the main thread stays responsive and a cancelled job stops quickly
+    const qint64 end = (m_buildEnd >= 0) ? m_buildEnd : m_RxBuf->size();
+    while(m_pendingChunkNum < m_maxPendingChunkNum && m_fedSize < end)
+    {
+        const qint64 len = qMin((qint64)m_builderChunkSize, end - m_fedSize);
+        const QVector<qint64> itemPos = isSplitAtMetadata() ? metadataPos(m_fedSize - 1, m_fedSize + len) : QVector<qint64>();
+        QMetaObject::invokeMethod(m_builder, "addChunk", Qt::QueuedConnection, Q_ARG(QByteArray, m_RxBuf->mid(m_fedSize, len)), Q_ARG(qint64, m_fedSize), Q_ARG(QVector<qint64>, itemPos), Q_ARG(int, m_generation));
+        m_fedSize += len;
+        m_pendingChunkNum++;
+    }
+}
+
+void RxDataModel::setCaptureIndex(const CaptureIndex* index)
+{
+    m_captureIndex = index;
+}
+
+void RxDataModel::startSearch(const QByteArray& pattern, bool isRegExp)
+{
+    stopSearch();
+    m_matches.clear();
+    m_currentMatch = -1;
+    updateHighlight();
+
+    const qint64 size = m_RxBuf->size();
+    m_searchPattern = pattern;
+    m_isRegExpSearch = isRegExp;
+    m_searchEnd = size;
+    m_searchRanges.clear();
+    // an empty pattern only clears the matches
+    if(!pattern.isEmpty())
+    {
+        if(!isRegExp && m_captureIndex != nullptr)
+            m_searchRanges = m_captureIndex->candidateRanges(pattern, size);
+        else
+            m_searchRanges.append(qMakePair((qint64)0, size));
+    }
+    m_searchSize = 0;
+    for(const auto& range : qAsConst(m_searchRanges))
+        m_searchSize += range.second - range.first;
+    m_searchedSize = 0;
+    m_searchRangeId = 0;
+    m_searchFedPos = m_searchRanges.isEmpty() ? 0 : m_searchRanges.first().first;
+    // a match starting at the end of a chunk continues in the next one
+    m_searchOverlap = isRegExp ? RxSearcher::m_regExpOverlap : qMax(pattern.size() - 1, 0);
+    m_isSearching = true;
+    // the data is matched as Latin-1, see RxSearcher::bytePattern()
+    const QByteArray searcherPattern = isRegExp ? RxSearcher::bytePattern(QString::fromUtf8(pattern), m_codec).toUtf8() : pattern;
+    QMetaObject::invokeMethod(m_searcher, "start", Qt::QueuedConnection, Q_ARG(QByteArray, searcherPattern), Q_ARG(bool, isRegExp), Q_ARG(int, m_searchGeneration));
+    feedSearcher();
+    if(m_searchPendingChunkNum == 0)
+        m_isSearching = false;
+    emit matchesChanged();
+}
+
+void RxDataModel::stopSearch()
+{
+    m_searchGeneration = m_searcher->restart();
+    m_searchPendingChunkNum = 0;
+    m_isSearching = false;
+}
+
+bool RxDataModel::isSearching() const
+{
+    return m_isSearching;
+}
+
+int RxDataModel::searchProgress() const
+{
+    if(m_searchSize == 0)
+        return 100;
+    return m_searchedSize * 100 / m_searchSize;
+}
+
+const QVector<QPair<qint64, qint64>>& RxDataModel::matches() const
+{
+    return m_matches;
+}
+
+int RxDataModel::currentMatch() const
+{
+    return m_currentMatch;
+}
+
+void RxDataModel::setCurrentMatch(int id)
+{
+    m_currentMatch = (id >= 0 && id < m_matches.size()) ? id : -1;
+    updateHighlight();
+}
+
+void RxDataModel::onMatchesFound(const QVector<QPair<qint64, qint64>>& matches, qint64 end, int generation)
+{
+    Q_UNUSED(end)
+    if(generation != m_searchGeneration)
+        return;
+    m_searchPendingChunkNum--;
+    for(const auto& match : matches)
+    {
+        // the chunks overlap, a match might be found twice or overlap the last one
+        if(!m_matches.isEmpty() && match.first < m_matches.last().second)
+            continue;
+        m_matches.append(match);
+    }
+    if(m_matches.size() >= m_maxMatchNum)
+    {
+        m_matches.resize(m_maxMatchNum);
+        stopSearch();
+    }
+    else
+    {
+        feedSearcher();
+        if(m_searchPendingChunkNum == 0)
+            m_isSearching = false;
+    }
+    if(!matches.isEmpty())
+        updateHighlight();
+    emit matchesChanged();
+}
+
+void RxDataModel::feedSearcher()
+{
+    // the data might be cleared while searching
+    const qint64 size = m_RxBuf->size();
+    while(m_searchPendingChunkNum < m_maxPendingChunkNum && m_searchRangeId < m_searchRanges.size())
+    {
+        const qint64 end = qMin(m_searchRanges[m_searchRangeId].second, qMin(m_searchFedPos + m_builderChunkSize, size));
+        if(m_searchFedPos >= end)
+        {
+            if(++m_searchRangeId < m_searchRanges.size())
+                m_searchFedPos = m_searchRanges[m_searchRangeId].first;
+            continue;
+        }
+        const qint64 len = qMin(end + m_searchOverlap, size) - m_searchFedPos;
+        QMetaObject::invokeMethod(m_searcher, "addChunk", Qt::QueuedConnection, Q_ARG(QByteArray, m_RxBuf->mid(m_searchFedPos, len)), Q_ARG(qint64, m_searchFedPos), Q_ARG(qint64, end), Q_ARG(int, m_searchGeneration));
+        // counted when it's fed, it's a few chunks ahead at most
+        m_searchedSize += end - m_searchFedPos;
+        m_searchPendingChunkNum++;
+        m_searchFedPos = end;
+    }
+}
+
+void RxDataModel::searchNewData(qint64 size)
+{
+    const bool isFed = (m_searchRangeId >= m_searchRanges.size());
+    if(!isFed && m_searchRanges.last().second == m_searchEnd)
+    {
+        // the last chunk is not fed yet
+        m_searchSize += size - m_searchEnd;
+        m_searchRanges.last().second = size;
+    }
+    else
+    {
+        if(isFed)
+        {
+            m_searchRanges.clear();
+            m_searchRangeId = 0;
+        }
+        // the matches crossing the old end are found again, they are dropped in onMatchesFound()
+        const qint64 begin = qMax(m_searchEnd - m_searchOverlap, (qint64)0);
+        m_searchSize += size - begin;
+        m_searchRanges.append(qMakePair(begin, size));
+        if(isFed)
+            m_searchFedPos = begin;
+    }
+    m_searchEnd = size;
+    feedSearcher();
+}
+
+void RxDataModel::updateHighlight()
+{
+    if(m_rowCount > 0)
+        emit dataChanged(index(0), index(m_rowCount - 1), {Qt::BackgroundRole});
+}
+
+qint64 RxDataModel::findTailBegin(qint64 size) const
+{
+    // The rows after a hard boundary don't depend on the data before it.
+    // In timestamp or frame mode, every Metadata starts a row, otherwise every '\n' ends a row.
+    const qint64 from = size - m_tailSize;
+    if(isSplitAtMetadata())
+    {
+        const QVector<qint64> itemPos = metadataPos(from - 1, size - 1);
+        return itemPos.isEmpty() ? -1 : itemPos.first();
+    }
+    const char* data = m_RxBuf->constData();
+    const char* newLine = (const char*)memchr(data + from, '\n', size - from);
+    if(newLine == nullptr || newLine - data + 1 >= size)
+        return -1;
+    return newLine - data + 1;
+}
+
+QVector<qint64> RxDataModel::metadataPos(qint64 after, qint64 end) const
+{
+    // the start positions in (after, end]
+    QVector<qint64> result;
+    auto it = std::upper_bound(m_RxMetadataBuf->cbegin(), m_RxMetadataBuf->cend(), after, [](qint64 val, const Metadata & item)
+    {
+        return val < item.pos;
+    });
+    for(; it != m_RxMetadataBuf->cend() && it->pos <= end; ++it)
+        result.append(it->pos);
+    return result;
+}
+
+bool RxDataModel::isSplitAtMetadata() const
+{
+    return m_timestampEnabled || m_frameSplitEnabled;
+}
+
+bool RxDataModel::isIndexed() const
+{
+    return !m_hexEnabled || isSplitAtMetadata();
+}
+
+int RxDataModel::indexedRowCount() const
+{
+    if(!isIndexed())
+        return (m_indexedSize + m_hexRowLen - 1) / m_hexRowLen;
+    return m_rowBegin.size() - (m_rowBegin.last() >= m_indexedSize ? 1 : 0);
+}
+
+void RxDataModel::indexData(qint64 end)
+{
+    if(isIndexed())
+    {
+        const QVector<qint64> itemPos = isSplitAtMetadata() ? metadataPos(m_scanner.rowBegin(), end) : QVector<qint64>();
+        m_scanner.scan(m_RxBuf->constData(), 0, m_indexedSize, end, itemPos, m_rowBegin);
+    }
+    m_indexedSize = end;
+}
+
+void RxDataModel::rowRange(int row, qint64* begin, qint64* end) const
+{
+    if(!isIndexed())
+    {
+        *begin = (qint64)row * m_hexRowLen;
+        *end = qMin(*begin + m_hexRowLen, m_indexedSize);
+        return;
+    }
+    *begin = m_rowBegin[row];
+    *end = (row + 1 < m_rowBegin.size()) ? m_rowBegin[row + 1] : m_indexedSize;
+}
+
+int RxDataModel::rowOf(qint64 pos) const
+{
+    if(pos < 0 || pos >= m_indexedSize)
+        return -1;
+    if(!isIndexed())
+        return pos / m_hexRowLen;
+    // the head is not indexed yet while the tail is shown
+    if(pos < m_rowBegin.first())
+        return -1;
+    const int row = std::upper_bound(m_rowBegin.cbegin(), m_rowBegin.cend(), pos) - m_rowBegin.cbegin() - 1;
+    return row < m_rowCount ? row : -1;
+}
+
+qint64 RxDataModel::posOf(int row) const
+{
+    qint64 begin, end;
+    rowRange(row, &begin, &end);
+    return begin;
+}
+
+qint64 RxDataModel::lineCount() const
+{
+    return m_lineIndex.lineCount();
+}
+
+qint64 RxDataModel::lineBegin(qint64 line) const
+{
+    return m_lineIndex.lineBegin(*m_RxBuf, line);
+}
+
+qint64 RxDataModel::lineOf(qint64 pos) const
+{
+    return m_lineIndex.lineOf(*m_RxBuf, pos);
+}
+
+int RxDataModel::matchIn(qint64 begin, qint64 end) const
+{
+    // the first match ending after begin
+    auto it = std::upper_bound(m_matches.cbegin(), m_matches.cend(), begin, [](qint64 val, const QPair<qint64, qint64>& match)
+    {
+        return val < match.second;
+    });
+    if(it == m_matches.cend() || it->first >= end)
+        return -1;
+    return it - m_matches.cbegin();
+}
+
+const Metadata* RxDataModel::metadataAt(qint64 pos) const
+{
+    const int id = Metadata::indexAt(*m_RxMetadataBuf, pos);
+    return (id >= 0) ? &m_RxMetadataBuf->at(id) : nullptr;
+}
+
+RxDataModel::RowScanner::RowScanner(bool hexEnabled, bool splitAtMetadata, qint64 rowBegin)
+{
+    m_hexEnabled = hexEnabled;
+    m_splitAtMetadata = splitAtMetadata;
+    m_rowBegin = rowBegin;
+}
+
+qint64 RxDataModel::RowScanner::rowBegin() const
+{
+    return m_rowBegin;
+}
+
+void RxDataModel::RowScanner::scan(const char* data, qint64 base, qint64 pos, qint64 end, const QVector<qint64>& itemPos, QVector<qint64>& boundaries)
+{
+    // The boundaries are found once, only the new data is scanned.
+    const int maxLen = m_hexEnabled ? m_hexRowLen : m_textRowLen;
+    const qint64 scanBegin = pos;
+    int itemId = 0;
+    while(pos < end)
+    {
+        qint64 boundary = m_rowBegin + maxLen;
+        bool isWrapped = true;
+        if(m_splitAtMetadata)
+        {
+            while(itemId < itemPos.size() && itemPos[itemId] <= m_rowBegin)
+                itemId++;
+            if(itemId < itemPos.size() && itemPos[itemId] < boundary)
+            {
+                boundary = itemPos[itemId];
+                isWrapped = false;
+            }
+        }
+        if(!m_hexEnabled)
+        {
+            const qint64 searchEnd = qMin(boundary, end);
+            const char* newLine = (const char*)memchr(data + (pos - base), '\n', searchEnd - pos);
+            if(newLine != nullptr)
+            {
+                boundary = newLine - data + base + 1;
+                isWrapped = false;
+            }
+        }
+        if(boundary > end || (isWrapped && boundary == end))
+            break; // wait for more data
+        if(isWrapped && !m_hexEnabled)
+        {
+            // don't split a UTF-8 sequence, the data before scanBegin might be unavailable
+            const qint64 limit = qMax(boundary - 3, scanBegin);
+            while(boundary > limit && (data[boundary - base] & 0xC0) == 0x80)
+                boundary--;
+        }
+        boundaries.append(boundary);
+        m_rowBegin = boundary;
+        pos = boundary;
+    }
+}
@@ -0,0 +1,169 @@
+#ifndef RXDATAMODEL_H
+#define RXDATAMODEL_H
+
+#include <QAbstractListModel>
+#include <QTextCodec>
+#include <QThread>
+
+#include "metadata.h"
+#include "lineindex.h"
+#include "timestampformatter.h"
+
+class RxIndexBuilder;
+class RxSearcher;
+class CaptureIndex;
+
+// A read-only view of the received data as text or hex rows, for QListView with uniform item sizes.
+// Only the start offsets of the rows are stored, the text of a row is generated from rawReceivedData when it's visible.
+// In hex mode without timestamps or frames, the rows have fixed length and nothing is stored.
+// The search matches are stored as byte ranges, the rows containing them are highlighted.
+class RxDataModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    static const int m_hexRowLen = 16;
+    // longer lines are wrapped
+    static const int m_textRowLen = 256;
+
+    // Finds the row boundaries incrementally, shared with RxIndexBuilder.
+    // A row ends after '\n', before the next Metadata in timestamp or frame mode, or when it's too long.
+    class RowScanner
+    {
+    public:
+        RowScanner(bool hexEnabled = false, bool splitAtMetadata = false, qint64 rowBegin = 0);
+        // data[0] is at base, the bytes in [pos, end) are scanned
+        // itemPos: the start positions of the Metadata in (rowBegin(), end], in order
+        void scan(const char* data, qint64 base, qint64 pos, qint64 end, const QVector<qint64>& itemPos, QVector<qint64>& boundaries);
+        qint64 rowBegin() const;
+    private:
+        bool m_hexEnabled;
+        bool m_splitAtMetadata;
+        qint64 m_rowBegin;
+    };
+
+    explicit RxDataModel(const QByteArray* RxBuf, const QVector<Metadata>* RxMetadataBuf, QObject *parent = nullptr);
+    ~RxDataModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setHexEnabled(bool enabled);
+    void setTimestampEnabled(bool enabled);
+    // every Metadata is a received frame, it starts a row even if the timestamps are hidden
+    void setFrameSplitEnabled(bool enabled);
+    void setCodec(QTextCodec* codec);
+    // the view is following the latest data, index the tail first when rebuilding
+    void setLatestFirst(bool enabled);
+    bool isBuilding() const;
+    // the bytes of an incomplete character at the end of a row are shown in the next row
+    QString rowText(int row) const;
+    // rows in [first, last], separated by '\n'
+    QString rowsText(int first, int last) const;
+
+    // call it after the buffers are changed
+    void sync();
+    // call it after the mode is changed
+    void rebuild();
+
+    // optional, the chunks without the pattern are skipped
+    void setCaptureIndex(const CaptureIndex* index);
+    // the regular expression is in UTF-8, it matches the bytes in the codec
+    // the data received later is searched in sync() until the search is restarted, even if it's cleared
+    void startSearch(const QByteArray& pattern, bool isRegExp);
+    void stopSearch();
+    bool isSearching() const;
+    // 0~100
+    int searchProgress() const;
+    // sorted and not overlapping
+    const QVector<QPair<qint64, qint64>>& matches() const;
+    int currentMatch() const;
+    void setCurrentMatch(int id);
+    // -1 if the row is not indexed yet
+    int rowOf(qint64 pos) const;
+    // the start position of the row
+    qint64 posOf(int row) const;
+    // line numbers start from 0, the lines are indexed in sync()
+    qint64 lineCount() const;
+    qint64 lineBegin(qint64 line) const;
+    qint64 lineOf(qint64 pos) const;
+    const Metadata* metadataAt(qint64 pos) const;
+signals:
+    // emitted when new matches are found or the search is finished
+    void matchesChanged();
+private slots:
+    void onRowsIndexed(const QVector<qint64>& boundaries, qint64 end, int generation);
+    void onMatchesFound(const QVector<QPair<qint64, qint64>>& matches, qint64 end, int generation);
+private:
+    // smaller data is indexed in the main thread directly
+    static const int m_syncBuildSize = 1024 * 1024;
+    static const int m_builderChunkSize = 1024 * 1024;
+    static const int m_maxPendingChunkNum = 4;
+    static const int m_tailSize = 256 * 1024;
+    static const int m_maxMatchNum = 1000000;
+
+    const QByteArray* m_RxBuf;
+    const QVector<Metadata>* m_RxMetadataBuf;
+    QTextCodec* m_codec = nullptr;
+    bool m_hexEnabled = false;
+    bool m_timestampEnabled = false;
+    bool m_frameSplitEnabled = false;
+    bool m_latestFirst = true;
+    // rowText() is const, the cache is not a part of the state
+    mutable TimestampFormatter m_timestampFormatter;
+
+    int m_rowCount = 0;
+    qint64 m_indexedSize = 0;
+    int m_metadataNum = 0;
+    // the last row is not shown if it starts at m_indexedSize
+    QVector<qint64> m_rowBegin;
+    RowScanner m_scanner;
+    LineIndex m_lineIndex;
+
+    // background rebuilding
+    QThread* m_builderThread;
+    RxIndexBuilder* m_builder;
+    bool m_isBuilding = false;
+    int m_generation = 0;
+    qint64 m_fedSize = 0; // the data sent to m_builder
+    int m_pendingChunkNum = 0;
+    // the tail from m_buildEnd is indexed first and shown while m_builder indexes [0, m_buildEnd)
+    // -1: the rows are shown progressively from the beginning
+    qint64 m_buildEnd = -1;
+    QVector<qint64> m_headRowBegin;
+
+    // searching
+    QThread* m_searcherThread;
+    RxSearcher* m_searcher;
+    const CaptureIndex* m_captureIndex = nullptr;
+    QByteArray m_searchPattern; // empty if no search is active
+    bool m_isRegExpSearch = false;
+    bool m_isSearching = false; // the data before the start is being searched
+    int m_searchGeneration = 0;
+    int m_searchOverlap = 0;
+    int m_searchPendingChunkNum = 0;
+    QVector<QPair<qint64, qint64>> m_searchRanges; // the ranges to be fed
+    int m_searchRangeId = 0;
+    qint64 m_searchFedPos = 0;
+    qint64 m_searchedSize = 0;
+    qint64 m_searchSize = 0;
+    qint64 m_searchEnd = 0; // the end of m_searchRanges
+    QVector<QPair<qint64, qint64>> m_matches;
+    int m_currentMatch = -1;
+
+    bool isIndexed() const;
+    int indexedRowCount() const;
+    void indexData(qint64 end);
+    void insertNewRows();
+    void feedBuilder();
+    void feedSearcher();
+    void searchNewData(qint64 size);
+    // the first match overlapping [begin, end), -1 if there is no such match
+    int matchIn(qint64 begin, qint64 end) const;
+    void updateHighlight();
+    qint64 findTailBegin(qint64 size) const;
+    QVector<qint64> metadataPos(qint64 after, qint64 end) const;
+    bool isSplitAtMetadata() const;
+    void rowRange(int row, qint64* begin, qint64* end) const;
+};
+
+#endif // RXDATAMODEL_H
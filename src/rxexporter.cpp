@@ -0,0 +1,174 @@
+#include "rxexporter.h"
+#include "hexformatter.h"
+#include "streamdecoder.h"
+#include "timelinemodel.h"
+
+#include <QJsonObject>
+#include <QJsonDocument>
+
+RxExporter::RxExporter(QObject *parent)
+    : QObject{parent}
+{
+    qRegisterMetaType<QVector<Metadata>>("QVector<Metadata>");
+    qRegisterMetaType<QVector<Timeline::Entry>>("QVector<Timeline::Entry>");
+}
+
+int RxExporter::restart()
+{
+    return m_generation.fetchAndAddOrdered(1) + 1;
+}
+
+void RxExporter::start(const QString& fileName, int format, const QByteArray& codecName, int generation)
+{
+    if(generation != m_generation.loadAcquire())
+        return;
+    m_format = (Format)format;
+    m_codec = QTextCodec::codecForName(codecName);
+    m_failed = false;
+    m_file.setFileName(fileName);
+    if(!m_file.open(QFile::WriteOnly))
+    {
+        fail(generation);
+        return;
+    }
+    if(m_format == CSV)
+        m_failed = m_file.write("timestamp,length,hex,text\n") == -1;
+    else if(m_format == ConversationCSV)
+        m_failed = m_file.write("timestamp,direction,length,hex,text\n") == -1;
+    if(m_failed)
+        fail(generation);
+}
+
+void RxExporter::addChunk(const QByteArray& data, qint64 pos, const QVector<Metadata>& items, int generation)
+{
+    // the chunks of a cancelled job are skipped quickly
+    if(generation != m_generation.loadAcquire() || m_failed)
+        return;
+    QByteArray result;
+    if(m_format == Raw)
+        result = data;
+    else if(m_format == HexDump)
+        result = HexFormatter::dump(data.constData(), data.size(), pos, 16, HexFormatter::Offset | HexFormatter::ASCII).toLatin1() + '\n';
+    else if(m_format == CSV)
+        result = toCSV(data, pos, items);
+    else if(m_format == JSONLines)
+        result = toJSONLines(data, pos, items);
+    if(m_file.write(result) == -1)
+    {
+        fail(generation);
+        return;
+    }
+    emit written(pos + data.size(), generation);
+}
+
+void RxExporter::addTimelineChunk(const QByteArray& data, const QVector<Timeline::Entry>& entries, qint64 end, int generation)
+{
+    if(generation != m_generation.loadAcquire() || m_failed)
+        return;
+    if(m_file.write(toConversation(data, entries)) == -1)
+    {
+        fail(generation);
+        return;
+    }
+    emit written(end, generation);
+}
+
+void RxExporter::finish(int generation)
+{
+    if(generation != m_generation.loadAcquire() || m_failed)
+        return;
+    m_file.close();
+    if(m_file.error() != QFile::NoError)
+    {
+        fail(generation);
+        return;
+    }
+    emit finished(true, QString(), generation);
+}
+
+void RxExporter::abort()
+{
+    if(m_file.isOpen())
+    {
+        m_file.close();
+        m_file.remove();
+    }
+}
+
+void RxExporter::fail(int generation)
+{
+    m_failed = true;
+    const QString errorString = m_file.errorString();
+    if(m_file.isOpen())
+        m_file.close();
+    emit finished(false, errorString, generation);
+}
+
+QByteArray RxExporter::toCSV(const QByteArray& data, qint64 pos, const QVector<Metadata>& items)
+{
+    QByteArray result;
+    for(const Metadata& item : items)
+    {
+        const char* begin = data.constData() + (item.pos - pos);
+        QString text = StreamDecoder::decode(m_codec, begin, item.len);
+        // RFC 4180, the quotes are doubled
+        text.replace('"', "\"\"");
+        result += m_timestampFormatter.toString(item.timestamp).toLatin1();
+        result += ',' + QByteArray::number(item.len) + ',';
+        result += HexFormatter::hex(begin, item.len).toLatin1();
+        result += ",\"" + text.toUtf8() + "\"\n";
+    }
+    return result;
+}
+
+QByteArray RxExporter::toJSONLines(const QByteArray& data, qint64 pos, const QVector<Metadata>& items)
+{
+    QByteArray result;
+    for(const Metadata& item : items)
+    {
+        const char* begin = data.constData() + (item.pos - pos);
+        QJsonObject record;
+        record["timestamp"] = (double)item.timestamp;
+        record["length"] = (double)item.len;
+        record["hex"] = HexFormatter::hex(begin, item.len);
+        record["text"] = StreamDecoder::decode(m_codec, begin, item.len);
+        result += QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+    }
+    return result;
+}
+
+QByteArray RxExporter::toConversation(const QByteArray& data, const QVector<Timeline::Entry>& entries)
+{
+    QByteArray result;
+    for(const Timeline::Entry& entry : entries)
+    {
+        const char* begin = data.constData() + entry.pos;
+        const char* direction = (entry.direction == Timeline::Rx) ? "rx" : "tx";
+        if(m_format == ConversationText || m_format == ConversationHex)
+        {
+            // the same as the rows in the conversation view
+            const QString text = TimelineModel::entryText(begin, entry.len, entry.direction, m_format == ConversationHex, m_codec);
+            result += m_codec->fromUnicode(m_timestampFormatter.withTimestamp(text, entry.timestamp)) + '\n';
+        }
+        else if(m_format == ConversationCSV)
+        {
+            QString text = StreamDecoder::decode(m_codec, begin, entry.len);
+            text.replace('"', "\"\"");
+            result += m_timestampFormatter.toString(entry.timestamp).toLatin1();
+            result += ',' + QByteArray(direction) + ',' + QByteArray::number(entry.len) + ',';
+            result += HexFormatter::hex(begin, entry.len).toLatin1();
+            result += ",\"" + text.toUtf8() + "\"\n";
+        }
+        else if(m_format == ConversationJSONLines)
+        {
+            QJsonObject record;
+            record["timestamp"] = (double)entry.timestamp;
+            record["direction"] = direction;
+            record["length"] = (double)entry.len;
+            record["hex"] = HexFormatter::hex(begin, entry.len);
+            record["text"] = StreamDecoder::decode(m_codec, begin, entry.len);
+            result += QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+        }
+    }
+    return result;
+}
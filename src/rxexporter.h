@@ -0,0 +1,62 @@
+#ifndef RXEXPORTER_H
+#define RXEXPORTER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QFile>
+#include <QTextCodec>
+
+#include "metadata.h"
+#include "timeline.h"
+#include "timestampformatter.h"
+
+// Writes the received data to a file in a worker thread, the data is fed in chunks like RxIndexBuilder.
+// CSV and JSON lines have one record per Metadata, so their chunks contain whole Metadata.
+// The conversation formats have one record per Timeline entry, fed by addTimelineChunk().
+class RxExporter : public QObject
+{
+    Q_OBJECT
+public:
+    enum Format
+    {
+        Raw,
+        HexDump,
+        CSV,
+        JSONLines,
+        ConversationText,
+        ConversationHex,
+        ConversationCSV,
+        ConversationJSONLines,
+    };
+
+    explicit RxExporter(QObject *parent = nullptr);
+
+    // thread safe, the queued chunks of the running job are dropped
+    int restart();
+public slots:
+    void start(const QString& fileName, int format, const QByteArray& codecName, int generation);
+    // data[0] is at pos, items: the Metadata in data, only for CSV and JSON lines
+    void addChunk(const QByteArray& data, qint64 pos, const QVector<Metadata>& items, int generation);
+    // Entry::pos is the offset in data, end: the progress reported by written()
+    void addTimelineChunk(const QByteArray& data, const QVector<Timeline::Entry>& entries, qint64 end, int generation);
+    void finish(int generation);
+    // closes and removes the file
+    void abort();
+signals:
+    void written(qint64 end, int generation);
+    void finished(bool succeeded, const QString& errorString, int generation);
+private:
+    QAtomicInt m_generation = 0;
+    QFile m_file;
+    Format m_format = Raw;
+    QTextCodec* m_codec = nullptr;
+    bool m_failed = false;
+    TimestampFormatter m_timestampFormatter;
+
+    QByteArray toCSV(const QByteArray& data, qint64 pos, const QVector<Metadata>& items);
+    QByteArray toJSONLines(const QByteArray& data, qint64 pos, const QVector<Metadata>& items);
+    QByteArray toConversation(const QByteArray& data, const QVector<Timeline::Entry>& entries);
+    void fail(int generation);
+};
+
+#endif // RXEXPORTER_H
@@ -0,0 +1,29 @@
+#include "rxindexbuilder.h"
+
+RxIndexBuilder::RxIndexBuilder(QObject *parent)
+    : QObject{parent}
+{
+    qRegisterMetaType<QVector<qint64>>("QVector<qint64>");
+}
+
+int RxIndexBuilder::restart()
+{
+    return m_generation.fetchAndAddOrdered(1) + 1;
+}
+
+void RxIndexBuilder::start(bool hexEnabled, bool splitAtMetadata, int generation)
+{
+    if(generation != m_generation.loadAcquire())
+        return;
+    m_scanner = RxDataModel::RowScanner(hexEnabled, splitAtMetadata, 0);
+}
+
+void RxIndexBuilder::addChunk(const QByteArray& data, qint64 pos, const QVector<qint64>& itemPos, int generation)
+{
+    // the chunks of a cancelled job are skipped quickly
+    if(generation != m_generation.loadAcquire())
+        return;
+    QVector<qint64> boundaries;
+    m_scanner.scan(data.constData(), pos, pos, pos + data.size(), itemPos, boundaries);
+    emit rowsIndexed(boundaries, pos + data.size(), generation);
+}
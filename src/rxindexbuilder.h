@@ -0,0 +1,29 @@
+#ifndef RXINDEXBUILDER_H
+#define RXINDEXBUILDER_H
+
+#include <QObject>
+#include <QAtomicInt>
+
+#include "rxdatamodel.h"
+
+// Rebuilds the row index of RxDataModel in a worker thread after the display mode is changed.
+// The data is fed in chunks, the boundaries of every chunk are sent back as soon as it's scanned.
+class RxIndexBuilder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RxIndexBuilder(QObject *parent = nullptr);
+
+    // thread safe, the running job is dropped
+    int restart();
+public slots:
+    void start(bool hexEnabled, bool splitAtMetadata, int generation);
+    void addChunk(const QByteArray& data, qint64 pos, const QVector<qint64>& itemPos, int generation);
+signals:
+    void rowsIndexed(const QVector<qint64>& boundaries, qint64 end, int generation);
+private:
+    QAtomicInt m_generation = 0;
+    RxDataModel::RowScanner m_scanner;
+};
+
+#endif // RXINDEXBUILDER_H
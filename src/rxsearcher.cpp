@@ -0,0 +1,121 @@
+#include "rxsearcher.h"
+
+#include <QTextCodec>
+#include <cstring>
+
+RxSearcher::RxSearcher(QObject *parent)
+    : QObject{parent}
+{
+    qRegisterMetaType<QVector<QPair<qint64, qint64>>>("QVector<QPair<qint64,qint64>>");
+}
+
+int RxSearcher::restart()
+{
+    return m_generation.fetchAndAddOrdered(1) + 1;
+}
+
+QString RxSearcher::bytePattern(const QString& pattern, QTextCodec* codec)
+{
+    QString result;
+    bool isInClass = false;
+    for(int i = 0; i < pattern.size(); i++)
+    {
+        QChar c = pattern[i];
+        if(c == '\\' && i + 1 < pattern.size())
+        {
+            // an escaped non-ASCII character is the character itself
+            if(isInClass || pattern[i + 1].unicode() < 0x80)
+            {
+                result += c;
+                result += pattern[++i];
+                continue;
+            }
+            c = pattern[++i];
+        }
+        else if(c == '[' && !isInClass)
+        {
+            isInClass = true;
+            result += c;
+            // the ']' right after "[" or "[^" is a literal
+            if(i + 1 < pattern.size() && pattern[i + 1] == '^')
+                result += pattern[++i];
+            if(i + 1 < pattern.size() && pattern[i + 1] == ']')
+                result += pattern[++i];
+            continue;
+        }
+        else if(c == ']' && isInClass)
+            isInClass = false;
+        // a class matches one byte, so the multibyte characters in it are kept as is
+        if(c.unicode() < 0x80 || isInClass || codec == nullptr)
+        {
+            result += c;
+            continue;
+        }
+        QString character = c;
+        if(c.isHighSurrogate() && i + 1 < pattern.size() && pattern[i + 1].isLowSurrogate())
+            character += pattern[++i];
+        // the trailing bytes of GBK or Shift-JIS might be "\\" or "[", so they are escaped
+        result += "(?:" + QRegularExpression::escape(QString::fromLatin1(codec->fromUnicode(character))) + ")";
+    }
+    return result;
+}
+
+void RxSearcher::start(const QByteArray& pattern, bool isRegExp, int generation)
+{
+    if(generation != m_generation.loadAcquire())
+        return;
+    m_pattern = pattern;
+    m_isRegExp = isRegExp;
+    if(isRegExp)
+    {
+        m_regExp.setPattern(QString::fromUtf8(pattern));
+        m_regExp.optimize();
+    }
+    else
+        m_matcher.setPattern(pattern);
+}
+
+void RxSearcher::addChunk(const QByteArray& data, qint64 pos, qint64 end, int generation)
+{
+    // the chunks of a cancelled job are skipped quickly
+    if(generation != m_generation.loadAcquire())
+        return;
+    QVector<QPair<qint64, qint64>> matches;
+    const int len = end - pos;
+    if(m_isRegExp)
+    {
+        const QString text = QString::fromLatin1(data);
+        QRegularExpressionMatchIterator it = m_regExp.globalMatch(text);
+        while(it.hasNext())
+        {
+            const QRegularExpressionMatch match = it.next();
+            if(match.capturedStart() >= len)
+                break;
+            // the empty matches are useless for navigation
+            if(match.capturedLength() > 0)
+                matches.append(qMakePair(pos + match.capturedStart(), pos + match.capturedEnd()));
+        }
+    }
+    else if(m_pattern.size() == 1)
+    {
+        // memchr() is vectorized in libc
+        const char* begin = data.constData();
+        const char* p = begin;
+        while((p = (const char*)memchr(p, m_pattern[0], len - (p - begin))) != nullptr)
+        {
+            matches.append(qMakePair(pos + (p - begin), pos + (p - begin) + 1));
+            p++;
+        }
+    }
+    else if(!m_pattern.isEmpty())
+    {
+        int i = 0;
+        while((i = m_matcher.indexIn(data.constData(), data.size(), i)) != -1 && i < len)
+        {
+            matches.append(qMakePair(pos + i, pos + i + m_pattern.size()));
+            // the overlapping matches are skipped
+            i += m_pattern.size();
+        }
+    }
+    emit found(matches, end, generation);
+}
@@ -0,0 +1,46 @@
+#ifndef RXSEARCHER_H
+#define RXSEARCHER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QVector>
+#include <QPair>
+#include <QByteArrayMatcher>
+#include <QRegularExpression>
+
+class QTextCodec;
+
+// Finds the matches in the received data in a worker thread, the data is fed in chunks like RxIndexBuilder.
+// The regular expressions run on the bytes as Latin-1 characters, so the offsets are kept and "\xff" matches 0xFF.
+// The non-ASCII characters in the pattern are replaced by their bytes in the data codec, see bytePattern().
+class RxSearcher : public QObject
+{
+    Q_OBJECT
+public:
+    // the regular expression matches crossing the chunks are found if they are shorter than this
+    static const int m_regExpOverlap = 4096;
+
+    explicit RxSearcher(QObject *parent = nullptr);
+
+    // thread safe, the running job is dropped
+    int restart();
+    // the non-ASCII characters out of the character classes are replaced by (?:their bytes as Latin-1 characters),
+    // so "温度+" matches the bytes of "温度度" in UTF-8 or GBK, "." still matches a byte
+    static QString bytePattern(const QString& pattern, QTextCodec* codec);
+public slots:
+    // the regular expression is in UTF-8
+    void start(const QByteArray& pattern, bool isRegExp, int generation);
+    // data[0] is at pos, only the matches starting before end are reported, the data after end overlaps the next chunk
+    void addChunk(const QByteArray& data, qint64 pos, qint64 end, int generation);
+signals:
+    // [begin, end) of every match
+    void found(const QVector<QPair<qint64, qint64>>& matches, qint64 end, int generation);
+private:
+    QAtomicInt m_generation = 0;
+    QByteArray m_pattern;
+    QByteArrayMatcher m_matcher;
+    QRegularExpression m_regExp;
+    bool m_isRegExp = false;
+};
+
+#endif // RXSEARCHER_H
@@ -101,6 +101,24 @@ void SettingsTab::initSettings()
     connect(ui->Data_recordDataBox, &QCheckBox::clicked, this, &SettingsTab::savePreference);
     connect(ui->Data_mergeTimestampBox, &QCheckBox::clicked, this, &SettingsTab::savePreference);
     connect(ui->Data_mergeTimestampIntervalBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsTab::savePreference);
+    connect(ui->Data_frameModeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SettingsTab::savePreference);
+    connect(ui->Data_frameLengthBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SettingsTab::savePreference);
+    connect(ui->Data_frameDelimiterEdit, &QLineEdit::editingFinished, this, &SettingsTab::savePreference);
+    connect(ui->Data_rttModeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SettingsTab::savePreference);
+    connect(ui->Data_rttOffsetBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsTab::savePreference);
+    connect(ui->Data_rttTypeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SettingsTab::savePreference);
+    connect(ui->Data_rttRegExpEdit, &QLineEdit::editingFinished, this, &SettingsTab::savePreference);
+    connect(ui->Data_rttTimeoutBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsTab::savePreference);
+    connect(ui->Data_rttModeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SettingsTab::updateRttTracker);
+    connect(ui->Data_rttOffsetBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsTab::updateRttTracker);
+    connect(ui->Data_rttTypeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SettingsTab::updateRttTracker);
+    connect(ui->Data_rttRegExpEdit, &QLineEdit::editingFinished, this, &SettingsTab::updateRttTracker);
+    connect(ui->Data_rttTimeoutBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsTab::updateRttTracker);
+    connect(ui->Data_TxByteGapBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsTab::savePreference);
+    connect(ui->Data_TxFrameGapBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsTab::savePreference);
+    connect(ui->Data_searchIndexBox, &QCheckBox::clicked, this, &SettingsTab::savePreference);
+    connect(ui->Metrics_enabledBox, &QCheckBox::clicked, this, &SettingsTab::savePreference);
+    connect(ui->Metrics_portBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsTab::savePreference);
 }
 
 
@@ -185,12 +203,25 @@ void SettingsTab::savePreference()
     m_settings->setValue("Opacity", ui->Opacity_Box->value());
 #endif
     m_settings->setValue("TouchScroll", ui->General_touchScrollBox->isChecked());
+    m_settings->setValue("Metrics_Enabled", ui->Metrics_enabledBox->isChecked());
+    m_settings->setValue("Metrics_Port", ui->Metrics_portBox->value());
     m_settings->endGroup();
     // Android_HWSerialBox will handle the preference itself.
     m_settings->beginGroup("SerialTest_Data");
     m_settings->setValue("RecordData", ui->Data_recordDataBox->isChecked());
     m_settings->setValue("MergeTimestamp", ui->Data_mergeTimestampBox->isChecked());
     m_settings->setValue("TimestampInterval", ui->Data_mergeTimestampIntervalBox->value());
+    m_settings->setValue("FrameMode", ui->Data_frameModeBox->currentIndex());
+    m_settings->setValue("FrameLength", ui->Data_frameLengthBox->currentIndex());
+    m_settings->setValue("FrameDelimiter", ui->Data_frameDelimiterEdit->text());
+    m_settings->setValue("RttMode", ui->Data_rttModeBox->currentIndex());
+    m_settings->setValue("RttOffset", ui->Data_rttOffsetBox->value());
+    m_settings->setValue("RttType", ui->Data_rttTypeBox->currentIndex());
+    m_settings->setValue("RttRegExp", ui->Data_rttRegExpEdit->text());
+    m_settings->setValue("RttTimeout", ui->Data_rttTimeoutBox->value());
+    m_settings->setValue("TxByteGap", ui->Data_TxByteGapBox->value());
+    m_settings->setValue("TxFrameGap", ui->Data_TxFrameGapBox->value());
+    m_settings->setValue("SearchIndex", ui->Data_searchIndexBox->isChecked());
     m_settings->endGroup();
 }
 
@@ -206,6 +237,8 @@ void SettingsTab::loadPreference()
     ui->Android_forceLandscapeBox->setChecked(m_settings->value("Android_ForceLandscape", true).toBool());
     ui->Android_dockBox->setChecked(m_settings->value("Android_Dock", false).toBool());
     ui->General_touchScrollBox->setChecked(m_settings->value("TouchScroll", true).toBool());
+    ui->Metrics_enabledBox->setChecked(m_settings->value("Metrics_Enabled", false).toBool());
+    ui->Metrics_portBox->setValue(m_settings->value("Metrics_Port", 9464).toInt());
     ui->Opacity_Box->setValue(m_settings->value("Opacity", 100).toInt());
     ui->General_simultaneousClearBox->setChecked(m_settings->value("ClearBothRxDataAndGraph", false).toBool());
     int themeId = ui->Theme_nameBox->findData(m_settings->value("Theme_Name", "(none)").toString());
@@ -244,6 +277,17 @@ void SettingsTab::loadPreference()
     ui->Data_recordDataBox->setChecked(m_settings->value("RecordData", false).toBool());
     ui->Data_mergeTimestampBox->setChecked(m_settings->value("MergeTimestamp", true).toBool());
     ui->Data_mergeTimestampIntervalBox->setValue(m_settings->value("TimestampInterval", 10).toInt());
+    ui->Data_frameModeBox->setCurrentIndex(m_settings->value("FrameMode", 0).toInt());
+    ui->Data_frameLengthBox->setCurrentIndex(m_settings->value("FrameLength", 0).toInt());
+    ui->Data_frameDelimiterEdit->setText(m_settings->value("FrameDelimiter", "0A").toString());
+    ui->Data_rttModeBox->setCurrentIndex(m_settings->value("RttMode", 0).toInt());
+    ui->Data_rttOffsetBox->setValue(m_settings->value("RttOffset", 0).toInt());
+    ui->Data_rttTypeBox->setCurrentIndex(m_settings->value("RttType", 0).toInt());
+    ui->Data_rttRegExpEdit->setText(m_settings->value("RttRegExp", "").toString());
+    ui->Data_rttTimeoutBox->setValue(m_settings->value("RttTimeout", 5000).toInt());
+    ui->Data_TxByteGapBox->setValue(m_settings->value("TxByteGap", 0).toInt());
+    ui->Data_TxFrameGapBox->setValue(m_settings->value("TxFrameGap", 0).toInt());
+    ui->Data_searchIndexBox->setChecked(m_settings->value("SearchIndex", false).toBool());
     m_settings->endGroup();
 
     // Language is applied in main.cpp, not there.
@@ -260,6 +304,11 @@ void SettingsTab::loadPreference()
     on_Data_recordDataBox_clicked();
     on_Data_mergeTimestampBox_clicked();
     on_Data_mergeTimestampIntervalBox_valueChanged(ui->Data_mergeTimestampIntervalBox->value());
+    updateDeframer();
+    updateRttTracker();
+    on_Data_TxByteGapBox_valueChanged(ui->Data_TxByteGapBox->value());
+    on_Data_searchIndexBox_clicked();
+    on_Metrics_enabledBox_clicked();
     on_General_simultaneousClearBox_clicked();
 
     if(fontValid)
@@ -393,6 +442,95 @@ void SettingsTab::on_Data_mergeTimestampIntervalBox_valueChanged(int arg1)
 }
 
 
+void SettingsTab::on_Data_frameModeBox_currentIndexChanged(int index)
+{
+    Q_UNUSED(index)
+    updateDeframer();
+}
+
+
+void SettingsTab::on_Data_frameLengthBox_currentIndexChanged(int index)
+{
+    Q_UNUSED(index)
+    updateDeframer();
+}
+
+
+void SettingsTab::on_Data_frameDelimiterEdit_editingFinished()
+{
+    updateDeframer();
+}
+
+
+void SettingsTab::updateDeframer()
+{
+    // the indexes of Data_frameModeBox are the same as Deframer::Mode
+    const int mode = ui->Data_frameModeBox->currentIndex();
+    const int lengthType = ui->Data_frameLengthBox->currentIndex();
+    const QByteArray delimiter = QByteArray::fromHex(ui->Data_frameDelimiterEdit->text().toLatin1());
+    ui->Data_frameLengthBox->setVisible(mode == 3);
+    ui->Data_frameDelimiterEdit->setVisible(mode == 4);
+    int lengthSize;
+    bool bigEndian;
+    parseIntType(lengthType, &lengthSize, &bigEndian);
+    emit deframerChanged(mode, lengthSize, bigEndian, delimiter.isEmpty() ? '\n' : delimiter[0]);
+}
+
+
+void SettingsTab::updateRttTracker()
+{
+    // the indexes of Data_rttModeBox are the same as RttTracker::Mode
+    const int mode = ui->Data_rttModeBox->currentIndex();
+    ui->Data_rttOffsetBox->setVisible(mode == 2);
+    ui->Data_rttTypeBox->setVisible(mode == 2);
+    ui->Data_rttRegExpEdit->setVisible(mode == 3);
+    int size;
+    bool bigEndian;
+    parseIntType(ui->Data_rttTypeBox->currentIndex(), &size, &bigEndian);
+    emit rttChanged(mode, ui->Data_rttOffsetBox->value(), size, bigEndian, ui->Data_rttRegExpEdit->text(), ui->Data_rttTimeoutBox->value());
+}
+
+
+void SettingsTab::parseIntType(int index, int* size, bool* bigEndian)
+{
+    // u8, u16 LE, u16 BE, u32 LE, u32 BE
+    *size = (index == 0) ? 1 : ((index <= 2) ? 2 : 4);
+    *bigEndian = (index == 2 || index == 4);
+}
+
+
+void SettingsTab::on_Data_TxByteGapBox_valueChanged(int arg1)
+{
+    emit TxPacingChanged(arg1, ui->Data_TxFrameGapBox->value());
+}
+
+
+void SettingsTab::on_Data_TxFrameGapBox_valueChanged(int arg1)
+{
+    emit TxPacingChanged(ui->Data_TxByteGapBox->value(), arg1);
+}
+
+
+void SettingsTab::on_Data_searchIndexBox_clicked()
+{
+    emit searchIndexChanged(ui->Data_searchIndexBox->isChecked());
+}
+
+
+void SettingsTab::on_Metrics_enabledBox_clicked()
+{
+    emit metricsChanged(ui->Metrics_enabledBox->isChecked(), ui->Metrics_portBox->value());
+}
+
+
+void SettingsTab::on_Metrics_portBox_editingFinished()
+{
+    // restart the server on the new port
+    if(ui->Metrics_enabledBox->isChecked())
+        on_Metrics_enabledBox_clicked();
+}
+
+
 void SettingsTab::on_General_simultaneousClearBox_clicked()
 {
     bool clearBoth = ui->General_simultaneousClearBox->isChecked();
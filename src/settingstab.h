@@ -62,6 +62,24 @@ private slots:
 
     void on_Data_mergeTimestampIntervalBox_valueChanged(int arg1);
 
+    void on_Data_frameModeBox_currentIndexChanged(int index);
+
+    void on_Data_frameLengthBox_currentIndexChanged(int index);
+
+    void on_Data_frameDelimiterEdit_editingFinished();
+
+    void updateRttTracker();
+
+    void on_Data_TxByteGapBox_valueChanged(int arg1);
+
+    void on_Data_TxFrameGapBox_valueChanged(int arg1);
+
+    void on_Data_searchIndexBox_clicked();
+
+    void on_Metrics_enabledBox_clicked();
+
+    void on_Metrics_portBox_editingFinished();
+
     void on_General_simultaneousClearBox_clicked();
 
     void on_General_touchScrollBox_clicked();
@@ -70,6 +88,9 @@ private:
     Ui::SettingsTab *ui;
     MySettings* m_settings;
     void createConfFile(const QString &path, bool overwrite = false);
+    void updateDeframer();
+    // the items of Data_frameLengthBox and Data_rttTypeBox
+    static void parseIntType(int index, int* size, bool* bigEndian);
 signals:
     void themeChanged(const QString& themeName);
     void opacityChanged(qreal value);
@@ -81,7 +102,15 @@ signals:
     void recordDataChanged(bool enabled);
     void mergeTimestampChanged(bool enabled);
     void timestampIntervalChanged(int interval);
+    // mode: Deframer::Mode
+    void deframerChanged(int mode, int lengthSize, bool bigEndian, char delimiter);
+    // mode: RttTracker::Mode, timeout: in ms
+    void rttChanged(int mode, int offset, int size, bool bigEndian, const QString& regExp, int timeout);
     void clearBehaviorChanged(bool clearBoth);
+    // in us
+    void TxPacingChanged(qint64 byteGap, qint64 frameGap);
+    void searchIndexChanged(bool enabled);
+    void metricsChanged(bool enabled, int port);
 };
 
 #endif // SETTINGSTAB_H
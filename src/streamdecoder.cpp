@@ -0,0 +1,210 @@
+#include "streamdecoder.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STREAMDECODER_SSE2
+#include <emmintrin.h>
+#endif
+
+StreamDecoder::StreamDecoder(QTextCodec* codec)
+{
+    m_codec = codec;
+    m_type = typeOf(codec);
+    if(m_type == Other)
+        m_decoder = codec->makeDecoder();
+}
+
+StreamDecoder::~StreamDecoder()
+{
+    delete m_decoder;
+}
+
+QString StreamDecoder::toUnicode(const char* data, int len)
+{
+    if(m_type == Latin1)
+        return QString::fromLatin1(data, len);
+    else if(m_type == Other)
+        return m_decoder->toUnicode(data, len);
+
+    const uchar* src = reinterpret_cast<const uchar*>(data);
+    QString result(m_pendingLen + len, Qt::Uninitialized);
+    ushort* begin = reinterpret_cast<ushort*>(result.data());
+    ushort* dst = begin;
+    int pos = 0;
+    if(m_pendingLen > 0)
+    {
+        // complete the sequence split from the last chunk, it needs 3 more bytes at most
+        uchar buf[sizeof(m_pending) + 3];
+        const int oldPendingLen = m_pendingLen;
+        const int copyLen = qMin(len, 3);
+        memcpy(buf, m_pending, oldPendingLen);
+        memcpy(buf + oldPendingLen, src, copyLen);
+        const int consumed = decodeUTF8(&dst, buf, oldPendingLen + copyLen, false);
+        if(consumed < oldPendingLen)
+        {
+            // still incomplete, all data is pending
+            m_pendingLen = oldPendingLen + copyLen - consumed;
+            memmove(m_pending, buf + consumed, m_pendingLen);
+            pos = len;
+        }
+        else
+        {
+            // the rest of buf is decoded again with the following data
+            m_pendingLen = 0;
+            pos = consumed - oldPendingLen;
+        }
+    }
+    if(pos < len)
+    {
+        pos += decodeUTF8(&dst, src + pos, len - pos, false);
+        m_pendingLen = len - pos;
+        memcpy(m_pending, src + pos, m_pendingLen);
+    }
+    result.resize(dst - begin);
+    return result;
+}
+
+QString StreamDecoder::toUnicode(const QByteArray& data)
+{
+    return toUnicode(data.constData(), data.size());
+}
+
+void StreamDecoder::reset()
+{
+    m_pendingLen = 0;
+    if(m_decoder != nullptr)
+    {
+        delete m_decoder;
+        m_decoder = m_codec->makeDecoder();
+    }
+}
+
+QString StreamDecoder::decode(QTextCodec* codec, const char* data, int len)
+{
+    const Type type = typeOf(codec);
+    if(type == Latin1)
+        return QString::fromLatin1(data, len);
+    else if(type == Other)
+        return codec->toUnicode(data, len);
+
+    QString result(len, Qt::Uninitialized);
+    ushort* begin = reinterpret_cast<ushort*>(result.data());
+    ushort* dst = begin;
+    decodeUTF8(&dst, reinterpret_cast<const uchar*>(data), len, true);
+    result.resize(dst - begin);
+    return result;
+}
+
+QString StreamDecoder::decode(QTextCodec* codec, const QByteArray& data)
+{
+    return decode(codec, data.constData(), data.size());
+}
+
+StreamDecoder::Type StreamDecoder::typeOf(QTextCodec* codec)
+{
+    // MIBenum from IANA
+    if(codec == nullptr || codec->mibEnum() == 4)
+        return Latin1;
+    else if(codec->mibEnum() == 106)
+        return UTF8;
+    else
+        return Other;
+}
+
+int StreamDecoder::decodeUTF8(ushort** dst, const uchar* src, int len, bool flush)
+{
+    ushort* out = *dst;
+    int i = 0;
+    while(i < len)
+    {
+#ifdef STREAMDECODER_SSE2
+        // widen the ASCII runs 16 bytes at a time
+        const __m128i zero = _mm_setzero_si128();
+        while(i + 16 <= len)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            if(_mm_movemask_epi8(v) != 0)
+                break;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(v, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(v, zero));
+            out += 16;
+            i += 16;
+        }
+        if(i >= len)
+            break;
+#endif
+        if(src[i] < 0x80)
+        {
+            *out++ = src[i++];
+            continue;
+        }
+        uint ucs;
+        const int seqLen = sequenceLength(src + i, len - i, &ucs);
+        if(seqLen > 0)
+        {
+            if(QChar::requiresSurrogates(ucs))
+            {
+                *out++ = QChar::highSurrogate(ucs);
+                *out++ = QChar::lowSurrogate(ucs);
+            }
+            else
+                *out++ = ucs;
+            i += seqLen;
+        }
+        else if(seqLen == 0 && !flush)
+            break;
+        else
+        {
+            // one replacement character for the incomplete tail or the invalid bytes
+            *out++ = QChar::ReplacementCharacter;
+            i += (seqLen == 0) ? len - i : -seqLen;
+        }
+    }
+    *dst = out;
+    return i;
+}
+
+int StreamDecoder::sequenceLength(const uchar* src, int len, uint* ucs)
+{
+    // the ranges of the second byte exclude the overlong forms, the surrogates and the code points above U+10FFFF
+    const uchar lead = src[0];
+    int seqLen;
+    uchar min = 0x80, max = 0xBF;
+    if(lead >= 0xC2 && lead <= 0xDF)
+    {
+        seqLen = 2;
+        *ucs = lead & 0x1F;
+    }
+    else if(lead >= 0xE0 && lead <= 0xEF)
+    {
+        seqLen = 3;
+        *ucs = lead & 0x0F;
+        if(lead == 0xE0)
+            min = 0xA0;
+        else if(lead == 0xED)
+            max = 0x9F;
+    }
+    else if(lead >= 0xF0 && lead <= 0xF4)
+    {
+        seqLen = 4;
+        *ucs = lead & 0x07;
+        if(lead == 0xF0)
+            min = 0x90;
+        else if(lead == 0xF4)
+            max = 0x8F;
+    }
+    else
+        return -1;
+    for(int i = 1; i < seqLen; i++)
+    {
+        if(i >= len)
+            return 0;
+        if(src[i] < min || src[i] > max)
+            return -i;
+        *ucs = (*ucs << 6) | (src[i] & 0x3F);
+        min = 0x80;
+        max = 0xBF;
+    }
+    return seqLen;
+}
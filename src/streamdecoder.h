@@ -0,0 +1,48 @@
+#ifndef STREAMDECODER_H
+#define STREAMDECODER_H
+
+#include <QString>
+#include <QTextCodec>
+
+// Converts the received bytes to UTF-16 chunk by chunk.
+// UTF-8 and Latin-1 are decoded directly(with an SSE2 fast path for ASCII runs),
+// the multibyte sequences split across chunks are kept until the next chunk arrives.
+// Other encodings fall back to QTextDecoder.
+class StreamDecoder
+{
+public:
+    explicit StreamDecoder(QTextCodec* codec = nullptr);
+    ~StreamDecoder();
+
+    QString toUnicode(const char* data, int len);
+    QString toUnicode(const QByteArray& data);
+    // drops the pending bytes
+    void reset();
+
+    // stateless, an incomplete sequence at the end is replaced
+    static QString decode(QTextCodec* codec, const char* data, int len);
+    static QString decode(QTextCodec* codec, const QByteArray& data);
+private:
+    enum Type
+    {
+        Latin1,
+        UTF8,
+        Other,
+    };
+
+    Type m_type;
+    QTextCodec* m_codec;
+    QTextDecoder* m_decoder = nullptr;
+    // the incomplete UTF-8 sequence at the end of the last chunk
+    uchar m_pending[4];
+    int m_pendingLen = 0;
+
+    static Type typeOf(QTextCodec* codec);
+    // returns the number of consumed bytes, less than len only if flush is false and the data ends with an incomplete sequence
+    // every byte produces 1 UTF-16 unit at most
+    static int decodeUTF8(ushort** dst, const uchar* src, int len, bool flush);
+    // returns the length of the sequence at src, 0 if it's incomplete, -n if the first n bytes are invalid
+    static int sequenceLength(const uchar* src, int len, uint* ucs);
+};
+
+#endif // STREAMDECODER_H
@@ -0,0 +1,671 @@
+#include "terminalscreen.h"
+
+#include <QTextCodec>
+#include <algorithm>
+
+TerminalScreen::TerminalScreen(int columns, int rows)
+{
+    m_columns = qMax(columns, 1);
+    m_rows = qMax(rows, 1);
+    setCodec(nullptr);
+    reset();
+}
+
+TerminalScreen::~TerminalScreen()
+{
+    delete m_decoder;
+}
+
+void TerminalScreen::setCodec(QTextCodec* codec)
+{
+    m_codec = (codec != nullptr) ? codec : QTextCodec::codecForName("UTF-8");
+    delete m_decoder;
+    m_decoder = m_codec->makeDecoder();
+}
+
+void TerminalScreen::setMaxScrollback(int lines)
+{
+    m_maxScrollback = lines;
+    while(m_scrollback.size() > m_maxScrollback)
+        m_scrollback.removeFirst();
+}
+
+void TerminalScreen::resize(int columns, int rows)
+{
+    columns = qMax(columns, 1);
+    rows = qMax(rows, 1);
+    if(columns == m_columns && rows == m_rows)
+        return;
+    // keep the cursor line on the screen, the lines above it go to the scrollback
+    const int removedNum = qMax(m_row + 1 - rows, 0);
+    for(int i = 0; i < removedNum; i++)
+    {
+        if(!m_isAltScreen)
+            appendScrollback(m_lines.first());
+        m_lines.removeFirst();
+    }
+    m_row -= removedNum;
+    // the new cells are blank
+    m_lines.resize(rows);
+    for(Line& line : m_lines)
+        line.resize(columns);
+    m_mainLines.resize(m_isAltScreen ? rows : 0);
+    for(Line& line : m_mainLines)
+        line.resize(columns);
+    m_columns = columns;
+    m_rows = rows;
+    m_top = 0;
+    m_bottom = m_rows - 1;
+    m_savedRow = qMin(m_savedRow, m_rows - 1);
+    m_savedColumn = qMin(m_savedColumn, m_columns - 1);
+    moveCursor(m_row, m_column);
+    m_dirtyCursorRow = m_row;
+    m_dirtyCursorColumn = m_column;
+    markAllDirty();
+}
+
+void TerminalScreen::reset()
+{
+    m_pen = Cell();
+    m_savedPen = Cell();
+    m_isAltScreen = false;
+    m_mainLines.clear();
+    m_lines.fill(blankLine(), m_rows);
+    m_scrollback.clear();
+    m_row = m_column = 0;
+    m_savedRow = m_savedColumn = 0;
+    m_wrapPending = false;
+    m_autoWrap = true;
+    m_cursorVisible = true;
+    m_top = 0;
+    m_bottom = m_rows - 1;
+    m_state = Ground;
+    setCodec(m_codec);
+    m_dirtyCursorRow = m_dirtyCursorColumn = 0;
+    m_response.clear();
+    markAllDirty();
+}
+
+void TerminalScreen::feed(const char* data, qint64 len)
+{
+    qint64 i = 0;
+    while(i < len)
+    {
+        const quint8 c = data[i];
+        if(m_state == Ground)
+        {
+            if(c >= 0x20 && c != 0x7F)
+            {
+                // the printable run is decoded at once, the decoder keeps the incomplete multibyte characters
+                qint64 end = i + 1;
+                while(end < len && (quint8)data[end] >= 0x20 && (quint8)data[end] != 0x7F)
+                    end++;
+                printText(m_decoder->toUnicode(data + i, end - i));
+                i = end;
+                continue;
+            }
+            control(c);
+        }
+        else if(m_state == OSC)
+        {
+            if(c == 0x07)
+                m_state = Ground;
+            else if(c == 0x1B)
+                m_state = OSCEscape;
+        }
+        else if(m_state == OSCEscape)
+            m_state = (c == 0x1B) ? OSCEscape : ((c == '\\') ? Ground : OSC);
+        else if(c == 0x18 || c == 0x1A) // CAN, SUB
+            m_state = Ground;
+        else if(c == 0x1B)
+            m_state = Escape;
+        else if(c < 0x20)
+            control(c); // executed in the middle of the sequence
+        else if(m_state == Escape)
+            escape(c);
+        else if(m_state == EscapeIntermediate)
+            m_state = Ground; // the character set designations are ignored
+        else if(m_state == CSI)
+            csi(c);
+        i++;
+    }
+}
+
+int TerminalScreen::columns() const
+{
+    return m_columns;
+}
+
+int TerminalScreen::rows() const
+{
+    return m_rows;
+}
+
+const TerminalScreen::Line& TerminalScreen::line(int row) const
+{
+    return m_lines[row];
+}
+
+int TerminalScreen::scrollbackSize() const
+{
+    return m_scrollback.size();
+}
+
+const TerminalScreen::Line& TerminalScreen::scrollbackLine(int id) const
+{
+    return m_scrollback[id];
+}
+
+int TerminalScreen::cursorRow() const
+{
+    return m_row;
+}
+
+int TerminalScreen::cursorColumn() const
+{
+    return m_column;
+}
+
+bool TerminalScreen::isCursorVisible() const
+{
+    return m_cursorVisible;
+}
+
+QVector<QPair<int, int>> TerminalScreen::takeDirty()
+{
+    if(m_dirtyCursorRow != m_row || m_dirtyCursorColumn != m_column)
+    {
+        markDirty(m_dirtyCursorRow, m_dirtyCursorColumn, m_dirtyCursorColumn + 1);
+        markDirty(m_row, m_column, m_column + 1);
+        m_dirtyCursorRow = m_row;
+        m_dirtyCursorColumn = m_column;
+    }
+    const QVector<QPair<int, int>> result = m_dirty;
+    m_dirty.fill(qMakePair(m_columns, 0));
+    return result;
+}
+
+QByteArray TerminalScreen::takeResponse()
+{
+    const QByteArray result = m_response;
+    m_response.clear();
+    return result;
+}
+
+TerminalScreen::Cell TerminalScreen::blankCell() const
+{
+    // the erased cells have the current background color
+    Cell cell;
+    cell.bg = m_pen.bg;
+    return cell;
+}
+
+TerminalScreen::Line TerminalScreen::blankLine() const
+{
+    return Line(m_columns, blankCell());
+}
+
+void TerminalScreen::markDirty(int row, int begin, int end)
+{
+    QPair<int, int>& range = m_dirty[row];
+    range.first = qMin(range.first, begin);
+    range.second = qMax(range.second, end);
+}
+
+void TerminalScreen::markAllDirty()
+{
+    m_dirty.fill(qMakePair(0, m_columns), m_rows);
+}
+
+int TerminalScreen::param(int id, int defaultValue) const
+{
+    return (id < m_params.size() && m_params[id] >= 0) ? m_params[id] : defaultValue;
+}
+
+void TerminalScreen::moveCursor(int row, int column)
+{
+    m_row = qBound(0, row, m_rows - 1);
+    m_column = qBound(0, column, m_columns - 1);
+    m_wrapPending = false;
+}
+
+void TerminalScreen::printText(const QString& text)
+{
+    for(const QChar ch : text)
+    {
+        if(m_wrapPending)
+        {
+            m_column = 0;
+            lineFeed();
+            m_wrapPending = false;
+        }
+        Cell& cell = m_lines[m_row][m_column];
+        cell = m_pen;
+        cell.ch = ch;
+        markDirty(m_row, m_column, m_column + 1);
+        if(m_column + 1 < m_columns)
+            m_column++;
+        else if(m_autoWrap)
+            m_wrapPending = true;
+    }
+}
+
+void TerminalScreen::control(quint8 c)
+{
+    if(c == 0x08) // BS
+        moveCursor(m_row, m_column - 1);
+    else if(c == 0x09) // HT, the tab stops are fixed
+        moveCursor(m_row, (m_column / 8 + 1) * 8);
+    else if(c == 0x0A || c == 0x0B || c == 0x0C) // LF, VT, FF
+    {
+        lineFeed();
+        m_wrapPending = false;
+    }
+    else if(c == 0x0D) // CR
+        moveCursor(m_row, 0);
+    else if(c == 0x1B)
+        m_state = Escape;
+    // BEL and the others are ignored
+}
+
+void TerminalScreen::escape(quint8 c)
+{
+    m_state = Ground;
+    if(c == '[')
+    {
+        m_state = CSI;
+        m_params.clear();
+        m_params.append(-1);
+        m_isParamOverflow = false;
+        m_private = 0;
+    }
+    else if(c == ']' || c == 'P' || c == 'X' || c == '^' || c == '_')
+        m_state = OSC;
+    else if(c == '(' || c == ')' || c == '*' || c == '+' || c == '#' || c == '%')
+        m_state = EscapeIntermediate;
+    else if(c == '7')
+        saveCursor();
+    else if(c == '8')
+        restoreCursor();
+    else if(c == 'D') // IND
+    {
+        lineFeed();
+        m_wrapPending = false;
+    }
+    else if(c == 'E') // NEL
+    {
+        lineFeed();
+        moveCursor(m_row, 0);
+    }
+    else if(c == 'M') // RI
+        reverseIndex();
+    else if(c == 'c') // RIS
+        reset();
+}
+
+void TerminalScreen::csi(quint8 c)
+{
+    if(c >= '0' && c <= '9')
+    {
+        if(m_isParamOverflow)
+            return;
+        int& value = m_params.last();
+        value = qMax(value, 0) * 10 + (c - '0');
+        if(value > m_maxParamValue)
+            value = m_maxParamValue;
+    }
+    else if(c == ';' || c == ':')
+    {
+        if(m_params.size() < m_maxParamNum)
+            m_params.append(-1);
+        else
+            m_isParamOverflow = true;
+    }
+    else if(c >= 0x3C && c <= 0x3F) // "<=>?"
+        m_private = c;
+    else if(c >= 0x40 && c <= 0x7E)
+    {
+        m_state = Ground;
+        executeCSI(c);
+    }
+    // the intermediate bytes are ignored
+}
+
+void TerminalScreen::executeCSI(quint8 final)
+{
+    if(m_private == '?')
+    {
+        if(final == 'h' || final == 'l')
+            setPrivateModes(final == 'h');
+        return;
+    }
+    else if(m_private != 0)
+        return;
+
+    const int n = qMax(param(0, 1), 1);
+    switch(final)
+    {
+    case 'A': // CUU
+        moveCursor(qMax(m_row - n, (m_row >= m_top) ? m_top : 0), m_column);
+        break;
+    case 'B': // CUD
+        moveCursor(qMin(m_row + n, (m_row <= m_bottom) ? m_bottom : m_rows - 1), m_column);
+        break;
+    case 'C': // CUF
+        moveCursor(m_row, m_column + n);
+        break;
+    case 'D': // CUB
+        moveCursor(m_row, m_column - n);
+        break;
+    case 'E': // CNL
+        moveCursor(qMin(m_row + n, (m_row <= m_bottom) ? m_bottom : m_rows - 1), 0);
+        break;
+    case 'F': // CPL
+        moveCursor(qMax(m_row - n, (m_row >= m_top) ? m_top : 0), 0);
+        break;
+    case 'G': // CHA
+    case '`': // HPA
+        moveCursor(m_row, n - 1);
+        break;
+    case 'H': // CUP
+    case 'f': // HVP
+        moveCursor(n - 1, qMax(param(1, 1), 1) - 1);
+        break;
+    case 'd': // VPA
+        moveCursor(n - 1, m_column);
+        break;
+    case 'J': // ED
+        eraseDisplay(param(0, 0));
+        break;
+    case 'K': // EL
+        eraseLine(param(0, 0));
+        break;
+    case 'L': // IL
+        if(m_row >= m_top && m_row <= m_bottom)
+            scrollDown(m_row, m_bottom, n);
+        moveCursor(m_row, 0);
+        break;
+    case 'M': // DL
+        if(m_row >= m_top && m_row <= m_bottom)
+            scrollUp(m_row, m_bottom, n);
+        moveCursor(m_row, 0);
+        break;
+    case 'P': // DCH
+    case '@': // ICH
+    {
+        Line& line = m_lines[m_row];
+        const int num = qMin(n, m_columns - m_column);
+        if(final == 'P')
+        {
+            std::copy(line.begin() + m_column + num, line.end(), line.begin() + m_column);
+            fill(m_row, m_columns - num, m_columns);
+        }
+        else
+        {
+            std::copy_backward(line.begin() + m_column, line.end() - num, line.end());
+            fill(m_row, m_column, m_column + num);
+        }
+        markDirty(m_row, m_column, m_columns);
+        m_wrapPending = false;
+        break;
+    }
+    case 'X': // ECH
+        fill(m_row, m_column, qMin(m_column + n, m_columns));
+        m_wrapPending = false;
+        break;
+    case 'S': // SU
+        scrollUp(m_top, m_bottom, n);
+        break;
+    case 'T': // SD
+        scrollDown(m_top, m_bottom, n);
+        break;
+    case 'm': // SGR
+        selectGraphicRendition();
+        break;
+    case 'r': // DECSTBM
+    {
+        const int top = param(0, 1) - 1;
+        const int bottom = (param(1, 0) > 0 ? param(1, 0) : m_rows) - 1;
+        if(top >= 0 && top < bottom && bottom < m_rows)
+        {
+            m_top = top;
+            m_bottom = bottom;
+            moveCursor(0, 0);
+        }
+        break;
+    }
+    case 's':
+        saveCursor();
+        break;
+    case 'u':
+        restoreCursor();
+        break;
+    case 'n': // DSR
+        if(param(0, 0) == 5)
+            m_response += "\x1b[0n";
+        else if(param(0, 0) == 6)
+            m_response += "\x1b[" + QByteArray::number(m_row + 1) + ";" + QByteArray::number(m_column + 1) + "R";
+        break;
+    case 'c': // DA, VT100 with advanced video option
+        if(param(0, 0) == 0)
+            m_response += "\x1b[?1;2c";
+        break;
+    default:
+        break;
+    }
+}
+
+void TerminalScreen::setPrivateModes(bool enabled)
+{
+    for(const int mode : qAsConst(m_params))
+    {
+        if(mode == 7) // DECAWM
+            m_autoWrap = enabled;
+        else if(mode == 25) // DECTCEM
+        {
+            m_cursorVisible = enabled;
+            markDirty(m_row, m_column, m_column + 1);
+        }
+        else if(mode == 47 || mode == 1047)
+            setAltScreen(enabled);
+        else if(mode == 1049)
+        {
+            if(enabled)
+            {
+                saveCursor();
+                setAltScreen(true);
+            }
+            else
+            {
+                setAltScreen(false);
+                restoreCursor();
+            }
+        }
+    }
+}
+
+void TerminalScreen::selectGraphicRendition()
+{
+    for(int i = 0; i < m_params.size(); i++)
+    {
+        const int p = qMax(m_params[i], 0);
+        if(p == 0)
+        {
+            m_pen = Cell();
+        }
+        else if(p == 1)
+            m_pen.attr |= Bold;
+        else if(p == 4)
+            m_pen.attr |= Underline;
+        else if(p == 7)
+            m_pen.attr |= Inverse;
+        else if(p == 22)
+            m_pen.attr &= ~Bold;
+        else if(p == 24)
+            m_pen.attr &= ~Underline;
+        else if(p == 27)
+            m_pen.attr &= ~Inverse;
+        else if(p >= 30 && p <= 37)
+            m_pen.fg = p - 30;
+        else if(p == 39)
+            m_pen.fg = DefaultColor;
+        else if(p >= 40 && p <= 47)
+            m_pen.bg = p - 40;
+        else if(p == 49)
+            m_pen.bg = DefaultColor;
+        else if(p >= 90 && p <= 97)
+            m_pen.fg = p - 90 + 8;
+        else if(p >= 100 && p <= 107)
+            m_pen.bg = p - 100 + 8;
+        else if(p == 38 || p == 48)
+        {
+            quint16 color = DefaultColor;
+            if(param(i + 1, 0) == 5)
+            {
+                color = param(i + 2, 0) & 0xFF;
+                i += 2;
+            }
+            else if(param(i + 1, 0) == 2)
+            {
+                // the nearest one in the 6x6x6 color cube
+                auto level = [](int value)
+                {
+                    return (qBound(0, value, 255) * 5 + 127) / 255;
+                };
+                color = 16 + 36 * level(param(i + 2, 0)) + 6 * level(param(i + 3, 0)) + level(param(i + 4, 0));
+                i += 4;
+            }
+            if(p == 38)
+                m_pen.fg = color;
+            else
+                m_pen.bg = color;
+        }
+    }
+}
+
+void TerminalScreen::lineFeed()
+{
+    if(m_row == m_bottom)
+        scrollUp(m_top, m_bottom, 1);
+    else if(m_row < m_rows - 1)
+        m_row++;
+}
+
+void TerminalScreen::reverseIndex()
+{
+    m_wrapPending = false;
+    if(m_row == m_top)
+        scrollDown(m_top, m_bottom, 1);
+    else if(m_row > 0)
+        m_row--;
+}
+
+void TerminalScreen::scrollUp(int top, int bottom, int n)
+{
+    n = qMin(n, bottom - top + 1);
+    for(int i = 0; i < n; i++)
+    {
+        // only the lines scrolled out of the whole main screen are kept
+        if(top == 0 && !m_isAltScreen)
+            appendScrollback(m_lines[top]);
+        m_lines.remove(top);
+        m_lines.insert(bottom, blankLine());
+    }
+    for(int i = top; i <= bottom; i++)
+        markDirty(i, 0, m_columns);
+}
+
+void TerminalScreen::scrollDown(int top, int bottom, int n)
+{
+    n = qMin(n, bottom - top + 1);
+    for(int i = 0; i < n; i++)
+    {
+        m_lines.remove(bottom);
+        m_lines.insert(top, blankLine());
+    }
+    for(int i = top; i <= bottom; i++)
+        markDirty(i, 0, m_columns);
+}
+
+void TerminalScreen::appendScrollback(const Line& line)
+{
+    if(m_maxScrollback <= 0)
+        return;
+    m_scrollback.append(line);
+    if(m_scrollback.size() > m_maxScrollback)
+        m_scrollback.removeFirst();
+}
+
+void TerminalScreen::fill(int row, int begin, int end)
+{
+    if(begin >= end)
+        return;
+    const Cell blank = blankCell();
+    Line& line = m_lines[row];
+    std::fill(line.begin() + begin, line.begin() + end, blank);
+    markDirty(row, begin, end);
+}
+
+void TerminalScreen::eraseDisplay(int mode)
+{
+    if(mode == 0)
+    {
+        fill(m_row, m_column, m_columns);
+        for(int i = m_row + 1; i < m_rows; i++)
+            fill(i, 0, m_columns);
+    }
+    else if(mode == 1)
+    {
+        for(int i = 0; i < m_row; i++)
+            fill(i, 0, m_columns);
+        fill(m_row, 0, m_column + 1);
+    }
+    else if(mode == 2 || mode == 3)
+    {
+        for(int i = 0; i < m_rows; i++)
+            fill(i, 0, m_columns);
+        if(mode == 3)
+            m_scrollback.clear();
+    }
+}
+
+void TerminalScreen::eraseLine(int mode)
+{
+    if(mode == 0)
+        fill(m_row, m_column, m_columns);
+    else if(mode == 1)
+        fill(m_row, 0, m_column + 1);
+    else if(mode == 2)
+        fill(m_row, 0, m_columns);
+}
+
+void TerminalScreen::saveCursor()
+{
+    m_savedRow = m_row;
+    m_savedColumn = m_column;
+    m_savedPen = m_pen;
+}
+
+void TerminalScreen::restoreCursor()
+{
+    moveCursor(m_savedRow, m_savedColumn);
+    m_pen = m_savedPen;
+}
+
+void TerminalScreen::setAltScreen(bool enabled)
+{
+    if(enabled == m_isAltScreen)
+        return;
+    m_isAltScreen = enabled;
+    if(enabled)
+    {
+        m_mainLines = m_lines;
+        m_lines.fill(blankLine(), m_rows);
+    }
+    else
+    {
+        m_lines = m_mainLines;
+        m_mainLines.clear();
+    }
+    markAllDirty();
+}
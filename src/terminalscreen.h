@@ -0,0 +1,133 @@
+#ifndef TERMINALSCREEN_H
+#define TERMINALSCREEN_H
+
+#include <QList>
+#include <QPair>
+#include <QVector>
+
+class QTextCodec;
+class QTextDecoder;
+
+// The screen buffer of a VT100/xterm compatible terminal, with scrollback.
+// The escape sequences are parsed by a state machine fed chunk by chunk, a sequence might span the chunks.
+// The changed cells are recorded as a column range per row, so only these cells need to be repainted.
+class TerminalScreen
+{
+public:
+    enum Attribute
+    {
+        Bold = 1,
+        Underline = 2,
+        Inverse = 4,
+    };
+    // 0~255: xterm 256 colors
+    static const quint16 DefaultColor = 256;
+
+    struct Cell
+    {
+        QChar ch = ' ';
+        quint16 fg = DefaultColor;
+        quint16 bg = DefaultColor;
+        quint8 attr = 0;
+    };
+    typedef QVector<Cell> Line;
+
+    TerminalScreen(int columns = 80, int rows = 24);
+    ~TerminalScreen();
+
+    void setCodec(QTextCodec* codec);
+    void setMaxScrollback(int lines);
+    void resize(int columns, int rows);
+    // clears the screen and the scrollback
+    void reset();
+    void feed(const char* data, qint64 len);
+
+    int columns() const;
+    int rows() const;
+    const Line& line(int row) const;
+    // the lines scrolled out of the screen, 0 is the oldest
+    int scrollbackSize() const;
+    const Line& scrollbackLine(int id) const;
+    int cursorRow() const;
+    int cursorColumn() const;
+    bool isCursorVisible() const;
+    // the changed columns [first, second) of every row since the last call, first >= second if unchanged
+    // the old and new cursor cells are included
+    QVector<QPair<int, int>> takeDirty();
+    // the replies to the status requests, should be sent back
+    QByteArray takeResponse();
+private:
+    enum State
+    {
+        Ground,
+        Escape,
+        EscapeIntermediate,
+        CSI,
+        OSC, // also DCS/SOS/PM/APC, ignored until ST or BEL
+        OSCEscape,
+    };
+    // the extra parameters of a CSI sequence are ignored, the values are clamped
+    static const int m_maxParamNum = 16;
+    static const int m_maxParamValue = 65535;
+
+    int m_columns;
+    int m_rows;
+    QVector<Line> m_lines;
+    QList<Line> m_scrollback;
+    int m_maxScrollback = 10000;
+    // the alternate screen has no scrollback
+    bool m_isAltScreen = false;
+    QVector<Line> m_mainLines;
+
+    int m_row = 0;
+    int m_column = 0;
+    // the cursor stays at the last column until the next character is printed
+    bool m_wrapPending = false;
+    bool m_autoWrap = true;
+    bool m_cursorVisible = true;
+    int m_top = 0;
+    int m_bottom = 0;
+    Cell m_pen;
+    int m_savedRow = 0;
+    int m_savedColumn = 0;
+    Cell m_savedPen;
+
+    State m_state = Ground;
+    QVector<int> m_params; // -1: default
+    bool m_isParamOverflow = false;
+    char m_private = 0;
+
+    QTextCodec* m_codec = nullptr;
+    QTextDecoder* m_decoder = nullptr;
+    QVector<QPair<int, int>> m_dirty;
+    int m_dirtyCursorRow = 0;
+    int m_dirtyCursorColumn = 0;
+    QByteArray m_response;
+
+    Cell blankCell() const;
+    Line blankLine() const;
+    void markDirty(int row, int begin, int end);
+    void markAllDirty();
+    int param(int id, int defaultValue) const;
+    void moveCursor(int row, int column);
+    void printText(const QString& text);
+    void control(quint8 c);
+    void escape(quint8 c);
+    void csi(quint8 c);
+    void executeCSI(quint8 final);
+    void setPrivateModes(bool enabled);
+    void selectGraphicRendition();
+    void lineFeed();
+    void reverseIndex();
+    void scrollUp(int top, int bottom, int n);
+    void scrollDown(int top, int bottom, int n);
+    void appendScrollback(const Line& line);
+    void fill(int row, int begin, int end);
+    void eraseDisplay(int mode);
+    void eraseLine(int mode);
+    void saveCursor();
+    void restoreCursor();
+    void setAltScreen(bool enabled);
+};
+
+#endif // TERMINALSCREEN_H
@@ -0,0 +1,320 @@
+#include "terminalwidget.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QFontDatabase>
+#include <QKeyEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QTextCodec>
+
+TerminalWidget::TerminalWidget(QWidget *parent) : QAbstractScrollArea(parent)
+{
+    setFocusPolicy(Qt::StrongFocus);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    // the background is filled in paintEvent()
+    viewport()->setAttribute(Qt::WA_OpaquePaintEvent);
+    viewport()->setCursor(Qt::IBeamCursor);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setCodec(nullptr);
+    updateCellSize();
+}
+
+void TerminalWidget::setCodec(QTextCodec* codec)
+{
+    m_codec = (codec != nullptr) ? codec : QTextCodec::codecForName("UTF-8");
+    m_screen.setCodec(m_codec);
+}
+
+void TerminalWidget::feed(const QByteArray& data)
+{
+    const bool follow = isAtBottom();
+    m_screen.feed(data.constData(), data.size());
+    const QByteArray response = m_screen.takeResponse();
+    if(!response.isEmpty())
+        emit send(response);
+    const QVector<QPair<int, int>> dirty = m_screen.takeDirty();
+    updateScrollBar(follow);
+    if(!follow)
+    {
+        // the lines in the view might be shifted when the scrollback is full
+        viewport()->update();
+        return;
+    }
+    // the view rows are the screen rows
+    for(int row = 0; row < dirty.size(); row++)
+    {
+        const QPair<int, int>& range = dirty[row];
+        if(range.first < range.second)
+            viewport()->update(range.first * m_cellWidth, row * m_cellHeight, (range.second - range.first) * m_cellWidth, m_cellHeight);
+    }
+}
+
+void TerminalWidget::clear()
+{
+    m_screen.reset();
+    m_screen.takeDirty();
+    updateScrollBar(true);
+    viewport()->update();
+}
+
+void TerminalWidget::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(viewport());
+    const QRect rect = event->rect();
+    const QColor defaultBackground = color(TerminalScreen::DefaultColor, false);
+    painter.fillRect(rect, defaultBackground);
+    const int firstRow = rect.top() / m_cellHeight;
+    const int lastRow = rect.bottom() / m_cellHeight;
+    const int firstColumn = rect.left() / m_cellWidth;
+    const int lastColumn = rect.right() / m_cellWidth;
+    for(int row = firstRow; row <= lastRow; row++)
+    {
+        const TerminalScreen::Line* line = lineAt(row);
+        if(line == nullptr)
+            break;
+        const int end = qMin(lastColumn + 1, line->size());
+        int column = firstColumn;
+        while(column < end)
+        {
+            // the cells with the same style are drawn together
+            const TerminalScreen::Cell& style = line->at(column);
+            QString text;
+            int runEnd = column;
+            for(; runEnd < end; runEnd++)
+            {
+                const TerminalScreen::Cell& cell = line->at(runEnd);
+                if(cell.fg != style.fg || cell.bg != style.bg || cell.attr != style.attr)
+                    break;
+                text += cell.ch;
+            }
+            QColor foreground = color(style.fg, true);
+            QColor background = color(style.bg, false);
+            if(style.attr & TerminalScreen::Inverse)
+                qSwap(foreground, background);
+            const QRect runRect(column * m_cellWidth, row * m_cellHeight, (runEnd - column) * m_cellWidth, m_cellHeight);
+            if(background != defaultBackground)
+                painter.fillRect(runRect, background);
+            if(!text.trimmed().isEmpty() || (style.attr & TerminalScreen::Underline))
+            {
+                QFont runFont = font();
+                runFont.setBold(style.attr & TerminalScreen::Bold);
+                runFont.setUnderline(style.attr & TerminalScreen::Underline);
+                painter.setFont(runFont);
+                painter.setPen(foreground);
+                painter.drawText(runRect.left(), runRect.top() + m_ascent, text);
+            }
+            column = runEnd;
+        }
+    }
+
+    const int cursorRow = m_screen.scrollbackSize() + m_screen.cursorRow() - verticalScrollBar()->value();
+    if(m_screen.isCursorVisible() && cursorRow >= firstRow && cursorRow <= lastRow)
+    {
+        const QRect cursorRect(m_screen.cursorColumn() * m_cellWidth, cursorRow * m_cellHeight, m_cellWidth, m_cellHeight);
+        const QColor foreground = color(TerminalScreen::DefaultColor, true);
+        if(hasFocus())
+        {
+            painter.fillRect(cursorRect, foreground);
+            painter.setFont(font());
+            painter.setPen(defaultBackground);
+            painter.drawText(cursorRect.left(), cursorRect.top() + m_ascent, m_screen.line(m_screen.cursorRow()).at(m_screen.cursorColumn()).ch);
+        }
+        else
+        {
+            painter.setPen(foreground);
+            painter.drawRect(cursorRect.adjusted(0, 0, -1, -1));
+        }
+    }
+}
+
+void TerminalWidget::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScreenSize();
+}
+
+void TerminalWidget::keyPressEvent(QKeyEvent *event)
+{
+    const int key = event->key();
+    const Qt::KeyboardModifiers modifiers = event->modifiers();
+    if(modifiers == Qt::ShiftModifier && (key == Qt::Key_PageUp || key == Qt::Key_PageDown))
+    {
+        verticalScrollBar()->triggerAction(key == Qt::Key_PageUp ? QAbstractSlider::SliderPageStepSub : QAbstractSlider::SliderPageStepAdd);
+        return;
+    }
+    QByteArray data;
+    if(modifiers == (Qt::ControlModifier | Qt::ShiftModifier) && key == Qt::Key_V)
+        data = m_codec->fromUnicode(QApplication::clipboard()->text());
+    else
+        data = keyData(event);
+    if(data.isEmpty())
+    {
+        QAbstractScrollArea::keyPressEvent(event);
+        return;
+    }
+    // back to the screen when typing
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    emit send(data);
+}
+
+void TerminalWidget::changeEvent(QEvent *event)
+{
+    QAbstractScrollArea::changeEvent(event);
+    if(event->type() == QEvent::FontChange)
+        updateCellSize();
+}
+
+void TerminalWidget::focusInEvent(QFocusEvent *event)
+{
+    QAbstractScrollArea::focusInEvent(event);
+    viewport()->update();
+}
+
+void TerminalWidget::focusOutEvent(QFocusEvent *event)
+{
+    QAbstractScrollArea::focusOutEvent(event);
+    viewport()->update();
+}
+
+bool TerminalWidget::focusNextPrevChild(bool next)
+{
+    Q_UNUSED(next)
+    return false;
+}
+
+void TerminalWidget::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dx)
+    Q_UNUSED(dy)
+    if(!m_isFollowing)
+        viewport()->update();
+}
+
+void TerminalWidget::updateCellSize()
+{
+    const QFontMetrics metrics(font());
+#if QT_VERSION < QT_VERSION_CHECK(5, 11, 0)
+    m_cellWidth = qMax(metrics.width('M'), 1);
+#else
+    m_cellWidth = qMax(metrics.horizontalAdvance('M'), 1);
+#endif
+    m_cellHeight = qMax(metrics.height(), 1);
+    m_ascent = metrics.ascent();
+    updateScreenSize();
+}
+
+void TerminalWidget::updateScreenSize()
+{
+    const bool follow = isAtBottom();
+    m_screen.resize(viewport()->width() / m_cellWidth, viewport()->height() / m_cellHeight);
+    m_screen.takeDirty();
+    updateScrollBar(follow);
+    viewport()->update();
+}
+
+void TerminalWidget::updateScrollBar(bool follow)
+{
+    QScrollBar* bar = verticalScrollBar();
+    m_isFollowing = true;
+    bar->setRange(0, m_screen.scrollbackSize());
+    bar->setPageStep(m_screen.rows());
+    if(follow)
+        bar->setValue(bar->maximum());
+    m_isFollowing = false;
+}
+
+QColor TerminalWidget::color(quint16 id, bool isForeground) const
+{
+    // xterm
+    static const QRgb basicColors[16] =
+    {
+        0x000000, 0xCD0000, 0x00CD00, 0xCDCD00, 0x0000EE, 0xCD00CD, 0x00CDCD, 0xE5E5E5,
+        0x7F7F7F, 0xFF0000, 0x00FF00, 0xFFFF00, 0x5C5CFF, 0xFF00FF, 0x00FFFF, 0xFFFFFF,
+    };
+    static const int cubeLevels[6] = {0, 95, 135, 175, 215, 255};
+    if(id == TerminalScreen::DefaultColor)
+        return palette().color(isForeground ? QPalette::Text : QPalette::Base);
+    else if(id < 16)
+        return QColor(basicColors[id]);
+    else if(id < 232)
+    {
+        id -= 16;
+        return QColor(cubeLevels[id / 36], cubeLevels[id / 6 % 6], cubeLevels[id % 6]);
+    }
+    const int gray = 8 + (id - 232) * 10;
+    return QColor(gray, gray, gray);
+}
+
+const TerminalScreen::Line* TerminalWidget::lineAt(int viewRow) const
+{
+    const int id = verticalScrollBar()->value() + viewRow;
+    if(id < m_screen.scrollbackSize())
+        return &m_screen.scrollbackLine(id);
+    const int row = id - m_screen.scrollbackSize();
+    return (row < m_screen.rows()) ? &m_screen.line(row) : nullptr;
+}
+
+bool TerminalWidget::isAtBottom() const
+{
+    return verticalScrollBar()->value() == verticalScrollBar()->maximum();
+}
+
+QByteArray TerminalWidget::keyData(QKeyEvent *event) const
+{
+    const int key = event->key();
+    const Qt::KeyboardModifiers modifiers = event->modifiers();
+    switch(key)
+    {
+    case Qt::Key_Up:
+        return "\x1b[A";
+    case Qt::Key_Down:
+        return "\x1b[B";
+    case Qt::Key_Right:
+        return "\x1b[C";
+    case Qt::Key_Left:
+        return "\x1b[D";
+    case Qt::Key_Home:
+        return "\x1b[H";
+    case Qt::Key_End:
+        return "\x1b[F";
+    case Qt::Key_Insert:
+        return "\x1b[2~";
+    case Qt::Key_Delete:
+        return "\x1b[3~";
+    case Qt::Key_PageUp:
+        return "\x1b[5~";
+    case Qt::Key_PageDown:
+        return "\x1b[6~";
+    case Qt::Key_F1:
+        return "\x1bOP";
+    case Qt::Key_F2:
+        return "\x1bOQ";
+    case Qt::Key_F3:
+        return "\x1bOR";
+    case Qt::Key_F4:
+        return "\x1bOS";
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+        return "\r";
+    case Qt::Key_Backspace:
+        return "\x7f";
+    case Qt::Key_Tab:
+        return "\t";
+    case Qt::Key_Backtab:
+        return "\x1b[Z";
+    case Qt::Key_Escape:
+        return "\x1b";
+    default:
+        break;
+    }
+    // Ctrl+@ ~ Ctrl+_, event->text() is empty on some platforms
+    if((modifiers & Qt::ControlModifier) && key >= Qt::Key_At && key <= Qt::Key_Underscore)
+        return QByteArray(1, (char)(key - Qt::Key_At));
+    const QByteArray text = m_codec->fromUnicode(event->text());
+    if(text.isEmpty())
+        return text;
+    // Alt is sent as ESC
+    return (modifiers & Qt::AltModifier) ? "\x1b" + text : text;
+}
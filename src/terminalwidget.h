@@ -0,0 +1,53 @@
+#ifndef TERMINALWIDGET_H
+#define TERMINALWIDGET_H
+
+#include <QAbstractScrollArea>
+
+#include "terminalscreen.h"
+
+class QTextCodec;
+
+// Shows a TerminalScreen and sends the keystrokes.
+// After feeding, only the changed cells are repainted unless the view is scrolled back.
+// Shift+PageUp/PageDown scroll the scrollback, Ctrl+Shift+V pastes.
+class TerminalWidget : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    explicit TerminalWidget(QWidget *parent = nullptr);
+
+    void setCodec(QTextCodec* codec);
+    void feed(const QByteArray& data);
+    void clear();
+signals:
+    void send(const QByteArray& data);
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    void focusInEvent(QFocusEvent *event) override;
+    void focusOutEvent(QFocusEvent *event) override;
+    // Tab is sent rather than moving the focus
+    bool focusNextPrevChild(bool next) override;
+    void scrollContentsBy(int dx, int dy) override;
+private:
+    TerminalScreen m_screen;
+    QTextCodec* m_codec = nullptr;
+    int m_cellWidth = 8;
+    int m_cellHeight = 16;
+    int m_ascent = 12;
+    // the scroll bar is moved by feed(), the dirty cells are repainted instead
+    bool m_isFollowing = false;
+
+    void updateCellSize();
+    void updateScreenSize();
+    void updateScrollBar(bool follow);
+    QColor color(quint16 id, bool isForeground) const;
+    // view row -> line, nullptr if it's below the screen
+    const TerminalScreen::Line* lineAt(int viewRow) const;
+    bool isAtBottom() const;
+    QByteArray keyData(QKeyEvent *event) const;
+};
+
+#endif // TERMINALWIDGET_H
@@ -0,0 +1,107 @@
+#include "timeline.h"
+
+#include <algorithm>
+
+Timeline::Timeline(const QVector<Metadata>* RxMetadata, const QVector<Metadata>* TxMetadata)
+{
+    m_RxMetadata = RxMetadata;
+    m_TxMetadata = TxMetadata;
+}
+
+void Timeline::setEnabled(bool enabled)
+{
+    if(m_isEnabled == enabled)
+        return;
+    m_isEnabled = enabled;
+    // the snapshot taken by an exporter is not affected
+    m_entries = QVector<Entry>();
+    m_firstChanged = 0;
+    if(!enabled)
+        return;
+    // merge the recorded chunks, the received data goes first if the timestamps are the same
+    const QVector<Metadata>& rx = *m_RxMetadata;
+    const QVector<Metadata>& tx = *m_TxMetadata;
+    m_entries.reserve(rx.size() + tx.size());
+    int i = 0, j = 0;
+    while(i < rx.size() || j < tx.size())
+    {
+        if(j >= tx.size() || (i < rx.size() && rx[i].timestamp <= tx[j].timestamp))
+        {
+            if(rx[i].len > 0)
+                m_entries.append(Entry{rx[i].pos, rx[i].len, rx[i].timestamp, Rx});
+            i++;
+        }
+        else
+        {
+            if(tx[j].len > 0)
+                m_entries.append(Entry{tx[j].pos, tx[j].len, tx[j].timestamp, Tx});
+            j++;
+        }
+    }
+}
+
+void Timeline::append(Direction direction, qint64 pos, qint64 len, qint64 timestamp, bool isContinued)
+{
+    if(!m_isEnabled || len <= 0)
+        return;
+    if(isContinued && !m_entries.isEmpty())
+    {
+        Entry& last = m_entries.last();
+        if(last.direction == direction && last.pos + last.len == pos)
+        {
+            last.len += len;
+            m_firstChanged = qMin(m_firstChanged, m_entries.size() - 1);
+            return;
+        }
+    }
+    // the entries with the same timestamp keep the order they are appended
+    int id = m_entries.size();
+    const int minId = qMax(id - m_maxReorderNum, 0);
+    while(id > minId && m_entries[id - 1].timestamp > timestamp)
+        id--;
+    m_entries.insert(id, Entry{pos, len, timestamp, direction});
+    m_firstChanged = qMin(m_firstChanged, id);
+}
+
+void Timeline::remove(Direction direction)
+{
+    auto it = std::remove_if(m_entries.begin(), m_entries.end(), [direction](const Entry & entry)
+    {
+        return entry.direction == direction;
+    });
+    m_entries.erase(it, m_entries.end());
+    m_generation++;
+    m_firstChanged = 0;
+}
+
+int Timeline::size() const
+{
+    return m_entries.size();
+}
+
+const Timeline::Entry& Timeline::at(int id) const
+{
+    return m_entries.at(id);
+}
+
+const QVector<Timeline::Entry>& Timeline::entries() const
+{
+    return m_entries;
+}
+
+qint64 Timeline::memoryUsage() const
+{
+    return (qint64)m_entries.capacity() * sizeof(Entry);
+}
+
+int Timeline::generation() const
+{
+    return m_generation;
+}
+
+int Timeline::takeFirstChanged()
+{
+    const int result = qMin(m_firstChanged, m_entries.size());
+    m_firstChanged = m_entries.size();
+    return result;
+}
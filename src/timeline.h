@@ -0,0 +1,62 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <QMetaType>
+#include <QVector>
+
+#include "metadata.h"
+
+// The received and sent chunks as one list in time order, for showing and exporting the conversation.
+// An Entry only refers to the data in rawReceivedData or rawSendedData, the data is not copied.
+// Nothing is recorded until it's enabled, then the entries are built from RxMetadata and TxMetadata once,
+// and the new chunks are appended. The sent data reported by TxScheduler in batches might be older than
+// the latest received chunk, so it's inserted before the newer entries near the tail.
+class Timeline
+{
+public:
+    enum Direction : quint8
+    {
+        Rx = 0,
+        Tx,
+    };
+
+    struct Entry
+    {
+        qint64 pos; // in the buffer of the direction
+        qint64 len;
+        qint64 timestamp;
+        Direction direction;
+    };
+
+    Timeline(const QVector<Metadata>* RxMetadata, const QVector<Metadata>* TxMetadata);
+
+    // the entries are dropped when it's disabled
+    void setEnabled(bool enabled);
+    // ignored if it's disabled
+    // isContinued: merged into the last entry if it's the previous chunk of the same direction
+    void append(Direction direction, qint64 pos, qint64 len, qint64 timestamp, bool isContinued = false);
+    // call it after the buffer of the direction is cleared
+    void remove(Direction direction);
+    int size() const;
+    const Entry& at(int id) const;
+    // implicitly shared, a copy is a snapshot
+    const QVector<Entry>& entries() const;
+    qint64 memoryUsage() const;
+    // increased when the buffers are cleared
+    int generation() const;
+    // the first entry inserted or changed since the last call, size() if there is no such entry
+    int takeFirstChanged();
+private:
+    // the clock going back is not searched further
+    static const int m_maxReorderNum = 1024;
+
+    const QVector<Metadata>* m_RxMetadata;
+    const QVector<Metadata>* m_TxMetadata;
+    bool m_isEnabled = false;
+    QVector<Entry> m_entries;
+    int m_generation = 0;
+    int m_firstChanged = 0;
+};
+Q_DECLARE_METATYPE(Timeline::Entry)
+
+#endif // TIMELINE_H
@@ -0,0 +1,123 @@
+#include "timelinemodel.h"
+#include "hexformatter.h"
+#include "streamdecoder.h"
+
+#include <QColor>
+
+TimelineModel::TimelineModel(Timeline* timeline, const QByteArray* RxBuf, const QByteArray* TxBuf, QObject *parent)
+    : QAbstractListModel{parent}
+{
+    m_timeline = timeline;
+    m_RxBuf = RxBuf;
+    m_TxBuf = TxBuf;
+}
+
+int TimelineModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return m_rowCount;
+}
+
+QVariant TimelineModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= m_rowCount || index.row() >= m_timeline->size())
+        return QVariant();
+    if(role == Qt::DisplayRole)
+        return rowText(index.row(), m_maxRowLen);
+    else if(role == Qt::BackgroundRole)
+    {
+        // translucent, for both light and dark themes
+        if(m_timeline->at(index.row()).direction == Timeline::Tx)
+            return QColor(0, 128, 255, 40);
+    }
+    return QVariant();
+}
+
+void TimelineModel::setHexEnabled(bool enabled)
+{
+    // the rows are not changed
+    beginResetModel();
+    m_hexEnabled = enabled;
+    endResetModel();
+}
+
+void TimelineModel::setCodec(QTextCodec* codec)
+{
+    beginResetModel();
+    m_codec = codec;
+    endResetModel();
+}
+
+QString TimelineModel::rowText(int row) const
+{
+    return rowText(row, -1);
+}
+
+QString TimelineModel::rowText(int row, qint64 maxLen) const
+{
+    if(row < 0 || row >= m_timeline->size())
+        return QString();
+    const Timeline::Entry& entry = m_timeline->at(row);
+    const QByteArray* buf = (entry.direction == Timeline::Rx) ? m_RxBuf : m_TxBuf;
+    // the buffer is cleared, and sync() is not called yet
+    if(entry.pos + entry.len > buf->size())
+        return QString();
+    const qint64 len = (maxLen < 0) ? entry.len : qMin(entry.len, maxLen);
+    QString result = entryText(buf->constData() + entry.pos, len, entry.direction, m_hexEnabled, m_codec);
+    if(len < entry.len)
+        result += "...";
+    return m_timestampFormatter.withTimestamp(result, entry.timestamp);
+}
+
+QString TimelineModel::rowsText(int first, int last) const
+{
+    QString result;
+    for(int i = first; i <= last; i++)
+    {
+        if(i > first)
+            result += '\n';
+        result += rowText(i);
+    }
+    return result;
+}
+
+void TimelineModel::sync()
+{
+    if(m_generation != m_timeline->generation() || m_timeline->size() < m_rowCount)
+    {
+        // cleared or rebuilt
+        beginResetModel();
+        m_generation = m_timeline->generation();
+        m_timeline->takeFirstChanged();
+        m_rowCount = m_timeline->size();
+        endResetModel();
+        return;
+    }
+    // the sent data might be inserted before the received data, the rows after it are shifted
+    const int firstChanged = m_timeline->takeFirstChanged();
+    const int newCount = m_timeline->size();
+    if(firstChanged < m_rowCount)
+        emit dataChanged(index(firstChanged), index(m_rowCount - 1));
+    if(newCount > m_rowCount)
+    {
+        beginInsertRows(QModelIndex(), m_rowCount, newCount - 1);
+        m_rowCount = newCount;
+        endInsertRows();
+    }
+}
+
+QString TimelineModel::entryText(const char* data, qint64 len, Timeline::Direction direction, bool hexEnabled, QTextCodec* codec)
+{
+    QString text;
+    if(hexEnabled)
+        text = HexFormatter::hex(data, len);
+    else
+    {
+        // a QString can't hold more, the text is cut like the hex
+        text = StreamDecoder::decode(codec, data, (int)qMin(len, (qint64)m_maxTextLen));
+        text.replace('\r', "\\r");
+        text.replace('\n', "\\n");
+    }
+    return (direction == Timeline::Rx ? "Rx: " : "Tx: ") + text;
+}
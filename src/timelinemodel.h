@@ -0,0 +1,51 @@
+#ifndef TIMELINEMODEL_H
+#define TIMELINEMODEL_H
+
+#include <QAbstractListModel>
+#include <QTextCodec>
+
+#include "timeline.h"
+#include "timestampformatter.h"
+
+// A read-only view of the Timeline as a conversation, one row per entry, for QListView with uniform item sizes.
+// The text of a row is generated from rawReceivedData or rawSendedData when it's visible.
+// The line breaks are escaped to keep one line per entry, and the long entries are cut in the view.
+class TimelineModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    static const int m_maxRowLen = 1024;
+    // entryText() decodes at most this many bytes
+    static const int m_maxTextLen = 256 * 1024 * 1024;
+
+    explicit TimelineModel(Timeline* timeline, const QByteArray* RxBuf, const QByteArray* TxBuf, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setHexEnabled(bool enabled);
+    void setCodec(QTextCodec* codec);
+    // the whole entry, without cutting
+    QString rowText(int row) const;
+    // rows in [first, last], separated by '\n'
+    QString rowsText(int first, int last) const;
+    // call it after the timeline is changed
+    void sync();
+
+    // "Rx: text" or "Tx: text", shared with RxExporter
+    static QString entryText(const char* data, qint64 len, Timeline::Direction direction, bool hexEnabled, QTextCodec* codec);
+private:
+    Timeline* m_timeline;
+    const QByteArray* m_RxBuf;
+    const QByteArray* m_TxBuf;
+    QTextCodec* m_codec = nullptr;
+    bool m_hexEnabled = false;
+    int m_rowCount = 0;
+    int m_generation = 0;
+    // rowText() is const, the cache is not a part of the state
+    mutable TimestampFormatter m_timestampFormatter;
+
+    QString rowText(int row, qint64 maxLen) const;
+};
+
+#endif // TIMELINEMODEL_H
@@ -0,0 +1,58 @@
+#include "timestampformatter.h"
+
+#include <QDateTime>
+#include <cstring>
+
+TimestampFormatter::TimestampFormatter()
+{
+    memset(m_prefix, 0, sizeof(m_prefix));
+}
+
+QString TimestampFormatter::toString(qint64 timestamp)
+{
+    QString result(m_length, Qt::Uninitialized);
+    write(reinterpret_cast<ushort*>(result.data()), timestamp);
+    return result;
+}
+
+QString TimestampFormatter::withTimestamp(const QString& str, qint64 timestamp)
+{
+    QString result(m_length + 3 + str.size(), Qt::Uninitialized);
+    ushort* dst = reinterpret_cast<ushort*>(result.data());
+    *dst++ = '[';
+    dst = write(dst, timestamp);
+    *dst++ = ']';
+    *dst++ = ' ';
+    memcpy(dst, str.constData(), str.size() * sizeof(ushort));
+    return result;
+}
+
+ushort* TimestampFormatter::write(ushort* dst, qint64 timestamp)
+{
+    if(timestamp < m_minuteBegin || timestamp >= m_minuteEnd)
+        updatePrefix(timestamp);
+    memcpy(dst, m_prefix, sizeof(m_prefix));
+    dst += m_prefixLen;
+    const int msecs = timestamp - m_minuteBegin;
+    const int sec = msecs / 1000;
+    const int ms = msecs % 1000;
+    *dst++ = '0' + sec / 10;
+    *dst++ = '0' + sec % 10;
+    *dst++ = '.';
+    *dst++ = '0' + ms / 100;
+    *dst++ = '0' + ms / 10 % 10;
+    *dst++ = '0' + ms % 10;
+    return dst;
+}
+
+void TimestampFormatter::updatePrefix(qint64 timestamp)
+{
+    // the time zone offsets are whole minutes, so a local minute is 60000 msecs
+    const QDateTime dateTime = QDateTime::fromMSecsSinceEpoch(timestamp);
+    const QTime time = dateTime.time();
+    const QString prefix = dateTime.toString("yyyy-MM-dd'T'hh:mm:");
+    m_minuteBegin = timestamp - time.second() * 1000 - time.msec();
+    m_minuteEnd = m_minuteBegin + 60000;
+    // the years out of 0000-9999 don't fit
+    memcpy(m_prefix, prefix.constData(), qMin(prefix.size(), m_prefixLen) * sizeof(ushort));
+}
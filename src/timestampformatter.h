@@ -0,0 +1,34 @@
+#ifndef TIMESTAMPFORMATTER_H
+#define TIMESTAMPFORMATTER_H
+
+#include <QString>
+
+// Formats msecs since epoch like QDateTime::toString(Qt::ISODateWithMs) in local time:
+// 2024-01-02T03:04:05.678
+// The "yyyy-MM-ddThh:mm:" prefix is converted by QDateTime once per minute and cached,
+// so the consecutive timestamps only need the seconds and msecs digits.
+// Not thread safe, every thread should have its own formatter.
+class TimestampFormatter
+{
+public:
+    static const int m_length = 23;
+
+    TimestampFormatter();
+
+    QString toString(qint64 timestamp);
+    // "[timestamp] str"
+    QString withTimestamp(const QString& str, qint64 timestamp);
+    // writes m_length chars to dst, returns the end
+    ushort* write(ushort* dst, qint64 timestamp);
+private:
+    static const int m_prefixLen = 17;
+
+    ushort m_prefix[m_prefixLen];
+    // the cached minute is [m_minuteBegin, m_minuteEnd), empty at first
+    qint64 m_minuteBegin = 0;
+    qint64 m_minuteEnd = 0;
+
+    void updatePrefix(qint64 timestamp);
+};
+
+#endif // TIMESTAMPFORMATTER_H
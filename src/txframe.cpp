@@ -0,0 +1,97 @@
+#include "txframe.h"
+
+TxFrame::TxFrame(const QByteArray& data)
+{
+    m_data = data;
+}
+
+void TxFrame::addField(FieldType type, int offset, int size, bool bigEndian)
+{
+    if(offset < 0 || size < 1 || size > 8 || offset + size > m_data.size())
+        return;
+    Field field;
+    field.type = type;
+    field.offset = offset;
+    field.size = size;
+    field.bigEndian = bigEndian;
+    field.begin = 0;
+    field.crcId = -1;
+    m_fields.append(field);
+}
+
+void TxFrame::addChecksum(FieldType type, int offset, int size, bool bigEndian, int begin, const AsyncCRC* crc)
+{
+    if(offset < 0 || size < 1 || size > 8 || offset + size > m_data.size() || begin < 0 || begin > offset)
+        return;
+    if(type == CRC && crc == nullptr)
+        return;
+    Field field;
+    field.type = type;
+    field.offset = offset;
+    field.size = size;
+    field.bigEndian = bigEndian;
+    field.begin = begin;
+    field.crcId = -1;
+    if(type == CRC)
+    {
+        field.crcId = m_crcs.size();
+        m_crcs.append(*crc);
+    }
+    m_checksums.append(field);
+}
+
+bool TxFrame::isEmpty() const
+{
+    return m_data.isEmpty();
+}
+
+const QByteArray& TxFrame::data(quint64 sequence, qint64 timestamp)
+{
+    if(m_fields.isEmpty() && m_checksums.isEmpty())
+        return m_data;
+    // detaches only once
+    char* dst = m_data.data();
+    for(const Field& field : m_fields)
+    {
+        quint64 value = sequence;
+        if(field.type == Timestamp)
+            value = timestamp;
+        else if(field.type == UnixTime)
+            value = timestamp / 1000;
+        writeValue(dst + field.offset, value, field.size, field.bigEndian);
+    }
+    for(const Field& field : m_checksums)
+    {
+        const char* begin = dst + field.begin;
+        const int len = field.offset - field.begin;
+        quint64 value = 0;
+        if(field.type == CRC)
+        {
+            AsyncCRC& crc = m_crcs[field.crcId];
+            crc.reset();
+            crc.addData(begin, len);
+            value = crc.getResult();
+        }
+        else if(field.type == Sum)
+        {
+            for(int i = 0; i < len; i++)
+                value += (quint8)begin[i];
+        }
+        else if(field.type == XOR)
+        {
+            for(int i = 0; i < len; i++)
+                value ^= (quint8)begin[i];
+        }
+        writeValue(dst + field.offset, value, field.size, field.bigEndian);
+    }
+    return m_data;
+}
+
+void TxFrame::writeValue(char* dst, quint64 value, int size, bool bigEndian)
+{
+    for(int i = 0; i < size; i++)
+    {
+        dst[bigEndian ? size - 1 - i : i] = (char)(value & 0xFF);
+        value >>= 8;
+    }
+}
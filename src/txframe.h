@@ -0,0 +1,56 @@
+#ifndef TXFRAME_H
+#define TXFRAME_H
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QVector>
+
+#include "asynccrc.h"
+
+// A frame compiled once from the user input, then sent many times.
+// The fields are patched into the same buffer before every send, so nothing is parsed or allocated per frame.
+// The checksums are calculated after the other fields, in the order they are added.
+class TxFrame
+{
+public:
+    enum FieldType
+    {
+        Sequence,
+        Timestamp, // ms since epoch
+        UnixTime, // s since epoch
+        CRC,
+        Sum, // the sum of the bytes
+        XOR, // the xor of the bytes
+    };
+
+    struct Field
+    {
+        FieldType type;
+        int offset;
+        int size; // 1 to 8 bytes, the value is truncated
+        bool bigEndian;
+        int begin; // checksums only, [begin, offset) is calculated
+        int crcId; // CRC only, the index in m_crcs
+    };
+
+    TxFrame() = default;
+    explicit TxFrame(const QByteArray& data);
+
+    void addField(FieldType type, int offset, int size, bool bigEndian);
+    // crc is only for CRC
+    void addChecksum(FieldType type, int offset, int size, bool bigEndian, int begin, const AsyncCRC* crc = nullptr);
+    bool isEmpty() const;
+    // the data to be sent, sequence starts from 0
+    const QByteArray& data(quint64 sequence, qint64 timestamp);
+
+    static void writeValue(char* dst, quint64 value, int size, bool bigEndian);
+private:
+    QByteArray m_data;
+    QVector<Field> m_fields;
+    QVector<Field> m_checksums;
+    // copied on write, so the frames shared by threads don't share the state of CRC
+    QVector<AsyncCRC> m_crcs;
+};
+Q_DECLARE_METATYPE(TxFrame)
+
+#endif // TXFRAME_H
@@ -0,0 +1,273 @@
+#include "txscheduler.h"
+#include "rtttracker.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QThread>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+TxScheduler::TxScheduler(QObject *parent)
+    : QObject{parent}
+{
+    m_clock.start();
+    qRegisterMetaType<TxFrame>("TxFrame");
+    qRegisterMetaType<QVector<Metadata>>("QVector<Metadata>");
+    qRegisterMetaType<QVector<qint64>>("QVector<qint64>");
+}
+
+void TxScheduler::post(const QByteArray& data)
+{
+    m_pendingBytes.fetchAndAddOrdered(data.size());
+    QMetaObject::invokeMethod(this, "process", Qt::QueuedConnection, Q_ARG(QByteArray, data), Q_ARG(int, m_generation.loadAcquire()));
+}
+
+void TxScheduler::clear()
+{
+    // the queued frames are dropped in process()
+    m_generation.fetchAndAddOrdered(1);
+}
+
+void TxScheduler::startRepeat(const TxFrame& frame, qint64 period)
+{
+    // the previous repeating is stopped
+    const int repeatGeneration = m_repeatGeneration.fetchAndAddOrdered(1) + 1;
+    if(period < m_minRepeatPeriod)
+        period = m_minRepeatPeriod;
+    QMetaObject::invokeMethod(this, "repeat", Qt::QueuedConnection, Q_ARG(TxFrame, frame), Q_ARG(qint64, period), Q_ARG(int, m_generation.loadAcquire()), Q_ARG(int, repeatGeneration));
+}
+
+void TxScheduler::stopRepeat()
+{
+    m_repeatGeneration.fetchAndAddOrdered(1);
+}
+
+bool TxScheduler::isPacing() const
+{
+    return m_byteGap.loadAcquire() > 0 || m_frameGap.loadAcquire() > 0;
+}
+
+qint64 TxScheduler::pendingBytes() const
+{
+    return m_pendingBytes.loadAcquire();
+}
+
+int TxScheduler::generation() const
+{
+    return m_generation.loadAcquire();
+}
+
+void TxScheduler::writeFinished()
+{
+    m_inFlightWrites.fetchAndAddOrdered(-1);
+}
+
+void TxScheduler::setPacing(qint64 byteGap, qint64 frameGap)
+{
+    m_byteGap.storeRelease(qMax<qint64>(byteGap, 0));
+    m_frameGap.storeRelease(qMax<qint64>(frameGap, 0));
+}
+
+void TxScheduler::setFileDescriptor(int fd)
+{
+    // a write in progress checks the generation regularly, so the wait is short after clear()
+    QMutexLocker locker(&m_fdMutex);
+    m_fd = fd;
+}
+
+void TxScheduler::process(const QByteArray& data, int generation)
+{
+    m_pendingBytes.fetchAndAddOrdered(-data.size());
+    if(generation != m_generation.loadAcquire() || data.isEmpty())
+        return;
+    m_currGeneration = generation;
+
+    qint64 timestamp, sendTime;
+    const qint64 sentLen = sendFrame(data.constData(), data.size(), generation, &timestamp, &sendTime);
+    if(sentLen > 0)
+        emit sent(sentLen == data.size() ? data : data.left(sentLen), timestamp, sendTime, generation);
+}
+
+void TxScheduler::repeat(const TxFrame& frame, qint64 period, int generation, int repeatGeneration)
+{
+    if(frame.isEmpty())
+        return;
+    m_currGeneration = generation;
+    TxFrame currFrame = frame;
+    QByteArray reportData;
+    QVector<Metadata> reportFrames;
+    QVector<qint64> reportSendTimes;
+    qint64 lastReport = m_clock.nsecsElapsed();
+    qint64 next = lastReport;
+    for(quint64 sequence = 0;; sequence++)
+    {
+        // wake up regularly, so a long period can be stopped in time
+        while(generation == m_generation.loadAcquire() && repeatGeneration == m_repeatGeneration.loadAcquire() && m_clock.nsecsElapsed() < next)
+            sleepUntil(qMin(next, m_clock.nsecsElapsed() + m_maxRepeatSleep));
+        if(generation != m_generation.loadAcquire() || repeatGeneration != m_repeatGeneration.loadAcquire())
+            break;
+
+        const QByteArray& data = currFrame.data(sequence, QDateTime::currentMSecsSinceEpoch());
+        qint64 timestamp, sendTime;
+        const qint64 sentLen = sendFrame(data.constData(), data.size(), generation, &timestamp, &sendTime);
+        if(sentLen > 0)
+        {
+            reportFrames.append(Metadata(reportData.size(), sentLen, timestamp));
+            reportSendTimes.append(sendTime);
+            reportData.append(data.constData(), sentLen);
+        }
+        if(sentLen < data.size())
+            break;
+
+        const qint64 now = m_clock.nsecsElapsed();
+        // the deadlines are absolute, so the sending time doesn't add up
+        // if the sending is too slow, the missed periods are skipped rather than sent in a burst
+        next = qMax(next + period * 1000, now);
+        if(now - lastReport >= m_sentFramesInterval)
+        {
+            emit sentFrames(reportData, reportFrames, reportSendTimes, generation);
+            reportData.clear();
+            reportFrames.clear();
+            reportSendTimes.clear();
+            lastReport = now;
+        }
+    }
+    if(!reportFrames.isEmpty())
+        emit sentFrames(reportData, reportFrames, reportSendTimes, generation);
+}
+
+// returns the length of the sent data
+qint64 TxScheduler::sendFrame(const char* data, qint64 len, int generation, qint64* timestamp, qint64* sendTime)
+{
+    const qint64 byteGap = m_byteGap.loadAcquire() * 1000;
+    const qint64 frameGap = m_frameGap.loadAcquire() * 1000;
+    if(m_lastFrameEnd >= 0 && frameGap > 0)
+        sleepUntil(m_lastFrameEnd + frameGap);
+
+    *timestamp = QDateTime::currentMSecsSinceEpoch();
+    *sendTime = RttTracker::now();
+    qint64 sentLen = 0;
+    if(byteGap > 0)
+    {
+        qint64 next = 0;
+        for(; sentLen < len; sentLen++)
+        {
+            // stop the current frame as well
+            if(generation != m_generation.loadAcquire())
+                break;
+            sleepUntil(next);
+            if(!writeChunk(data + sentLen, 1))
+                break;
+            next = m_clock.nsecsElapsed() + byteGap;
+        }
+    }
+    else if(writeChunk(data, len))
+        sentLen = len;
+    m_lastFrameEnd = m_clock.nsecsElapsed();
+    return sentLen;
+}
+
+bool TxScheduler::writeChunk(const char* data, qint64 len)
+{
+#ifdef Q_OS_UNIX
+    // the port is not closed while the fd is in use
+    QMutexLocker locker(&m_fdMutex);
+    if(m_fd >= 0)
+    {
+        qint64 written = 0;
+        while(written < len)
+        {
+            const ssize_t num = ::write(m_fd, data + written, len - written);
+            if(num >= 0)
+            {
+                written += num;
+                continue;
+            }
+            if(errno == EINTR)
+                continue;
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                // the fd is opened with O_NONBLOCK by QSerialPort
+                pollfd pfd;
+                pfd.fd = m_fd;
+                pfd.events = POLLOUT;
+                pfd.revents = 0;
+                ::poll(&pfd, 1, 10);
+                if(m_currGeneration != m_generation.loadAcquire())
+                    return false;
+                continue;
+            }
+            emit failed(QString::fromLocal8Bit(strerror(errno)));
+            return false;
+        }
+        // setFileDescriptor(-1) must not wait for the drain
+        locker.unlock();
+        return drain();
+    }
+    locker.unlock();
+#endif
+    // backpressure, the event queue of the main thread is not flooded
+    while(m_inFlightWrites.loadAcquire() >= m_maxInFlightWrites)
+    {
+        if(m_currGeneration != m_generation.loadAcquire())
+            return false;
+        QThread::usleep(100);
+    }
+    m_inFlightWrites.fetchAndAddOrdered(1);
+    emit writeRequested(QByteArray(data, len), m_currGeneration);
+    return true;
+}
+
+#ifdef Q_OS_UNIX
+bool TxScheduler::drain()
+{
+    // Wait until the data is on the wire, then the gap is accurate.
+    // tcdrain() might block forever if the flow control stops the output, so the queue is polled.
+    const qint64 deadline = m_clock.nsecsElapsed() + m_maxDrainTime;
+    while(m_clock.nsecsElapsed() < deadline)
+    {
+        int queued = 0;
+        {
+            QMutexLocker locker(&m_fdMutex);
+            if(m_fd < 0 || ::ioctl(m_fd, TIOCOUTQ, &queued) < 0)
+                return true;
+        }
+        if(queued <= 0)
+            return true;
+        if(m_currGeneration != m_generation.loadAcquire())
+            return false;
+        QThread::usleep(100);
+    }
+    return true;
+}
+#endif
+
+void TxScheduler::sleepUntil(qint64 deadline)
+{
+    qint64 remaining = deadline - m_clock.nsecsElapsed();
+    if(remaining <= 0)
+        return;
+#if defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    remaining += ts.tv_nsec;
+    ts.tv_sec += remaining / 1000000000;
+    ts.tv_nsec = remaining % 1000000000;
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+        ;
+#else
+    // the sleep functions are not accurate enough there, sleep for most of the time then spin
+    if(remaining > 2000000)
+        QThread::usleep((remaining - 1000000) / 1000);
+    while(m_clock.nsecsElapsed() < deadline)
+        ;
+#endif
+}
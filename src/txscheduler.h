@@ -0,0 +1,88 @@
+#ifndef TXSCHEDULER_H
+#define TXSCHEDULER_H
+
+#include <QObject>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QMutex>
+
+#include "metadata.h"
+#include "txframe.h"
+
+// Pace the outgoing data with us-level gaps between bytes or frames, in a dedicated thread.
+// Each enqueued QByteArray is a frame.
+// For a serial port on Unix, the data is written to the file descriptor directly and the output queue is polled until it's empty,
+// so the gap is measured on the wire rather than in the buffer of the driver.
+// The fd is used under m_fdMutex, call clear() then setFileDescriptor(-1) before the port is closed.
+// For other connections, the paced chunks are handed back to the main thread by writeRequested(),
+// at most m_maxInFlightWrites chunks are queued, so a fast repeat waits for the main thread.
+// A repeated frame is sent in a loop with absolute deadlines, so the period can be much shorter than 1ms.
+class TxScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TxScheduler(QObject *parent = nullptr);
+
+    // thread safe
+    void post(const QByteArray& data);
+    // stops the repeating as well
+    void clear();
+    // thread safe, sends the frame every period us until stopRepeat() is called, the frames posted meanwhile wait
+    void startRepeat(const TxFrame& frame, qint64 period);
+    void stopRepeat();
+    bool isPacing() const;
+    qint64 pendingBytes() const;
+    int generation() const;
+    // thread safe, call it when a chunk from writeRequested() is handled
+    void writeFinished();
+
+    // thread safe, blocks until the current write to the old fd returns
+    void setFileDescriptor(int fd);
+public slots:
+    // thread safe, in us
+    void setPacing(qint64 byteGap, qint64 frameGap);
+signals:
+    // generation: the value of generation() when the data is scheduled, the reports of a cleared generation can be dropped
+    void writeRequested(const QByteArray& data, int generation);
+    // the time when the first byte of the frame is sent, timestamp: in ms since epoch, sendTime: RttTracker::now()
+    void sent(const QByteArray& data, qint64 timestamp, qint64 sendTime, int generation);
+    // the repeated frames are reported in batches, the pos of frames is relative to data, sendTimes[i] is for frames[i]
+    void sentFrames(const QByteArray& data, const QVector<Metadata>& frames, const QVector<qint64>& sendTimes, int generation);
+    void failed(const QString& info);
+private slots:
+    void process(const QByteArray& data, int generation);
+    void repeat(const TxFrame& frame, qint64 period, int generation, int repeatGeneration);
+private:
+    // in ns
+    static const qint64 m_sentFramesInterval = 50000000;
+    static const qint64 m_maxRepeatSleep = 10000000;
+    // in us
+    static const qint64 m_minRepeatPeriod = 1;
+    // the chunks in the event queue of the main thread
+    static const int m_maxInFlightWrites = 16;
+    // in ns, the output stopped by the flow control is not waited longer
+    static const qint64 m_maxDrainTime = 1000000000;
+
+    // in us, 0: no gap
+    QAtomicInteger<qint64> m_byteGap = 0;
+    QAtomicInteger<qint64> m_frameGap = 0;
+    QAtomicInteger<qint64> m_pendingBytes = 0;
+    QAtomicInt m_inFlightWrites = 0;
+    QAtomicInt m_generation = 0;
+    QAtomicInt m_repeatGeneration = 0;
+    int m_currGeneration = 0;
+    int m_fd = -1;
+    QMutex m_fdMutex;
+    QElapsedTimer m_clock;
+    qint64 m_lastFrameEnd = -1; // in ns, m_clock
+
+    qint64 sendFrame(const char* data, qint64 len, int generation, qint64* timestamp, qint64* sendTime);
+    bool writeChunk(const char* data, qint64 len);
+#ifdef Q_OS_UNIX
+    // false if the generation is cleared
+    bool drain();
+#endif
+    void sleepUntil(qint64 deadline);
+};
+
+#endif // TXSCHEDULER_H
@@ -0,0 +1,246 @@
+#include "txtemplate.h"
+#include "util.h"
+
+#include <QStringList>
+#include <QTextCodec>
+
+TxTemplate::TxTemplate(bool isTemplate)
+{
+    m_isTemplate = isTemplate;
+}
+
+bool TxTemplate::append(const QString& text, const Converter& literal)
+{
+    if(!m_isValid)
+        return false;
+    if(!m_isTemplate)
+    {
+        m_data += literal(text);
+        return true;
+    }
+    m_isValid = false;
+    QString literalText;
+    for(int i = 0; i < text.size(); i++)
+    {
+        const QChar c = text[i];
+        if((c == '{' || c == '}') && i + 1 < text.size() && text[i + 1] == c)
+        {
+            literalText += c;
+            i++;
+            continue;
+        }
+        if(c == '}')
+        {
+            m_errorString = tr("Unmatched \"}\".");
+            return false;
+        }
+        if(c != '{')
+        {
+            literalText += c;
+            continue;
+        }
+        const int end = text.indexOf('}', i + 1);
+        if(end == -1)
+        {
+            m_errorString = tr("Unmatched \"{\".");
+            return false;
+        }
+        m_data += literal(literalText);
+        literalText.clear();
+        if(!addField(text.mid(i + 1, end - i - 1).trimmed()))
+            return false;
+        i = end;
+    }
+    m_data += literal(literalText);
+    m_isValid = true;
+    return true;
+}
+
+bool TxTemplate::appendAffix(int type, const QString& text, const Converter& toText)
+{
+    if(type == TextAffix)
+        return append(text, toText);
+    else if(type == HexAffix)
+        return append(text, hexConverter());
+    else if(type == CRLFAffix)
+        appendRaw("\r\n");
+    else if(type == LFAffix)
+        appendRaw("\n");
+    return m_isValid;
+}
+
+void TxTemplate::appendRaw(const QByteArray& data)
+{
+    m_data += data;
+}
+
+TxFrame TxTemplate::frame() const
+{
+    QByteArray data = m_data;
+    int size;
+    bool bigEndian;
+    // the lengths are constant
+    for(int i = 0; i < m_fields.size(); i++)
+    {
+        const Field& field = m_fields[i];
+        if(field.name != "len")
+            continue;
+        int end = data.size();
+        for(int j = i + 1; j < m_fields.size(); j++)
+        {
+            if(checksumParam(m_fields[j].name, &size, &bigEndian))
+            {
+                end = m_fields[j].offset;
+                break;
+            }
+        }
+        TxFrame::writeValue(data.data() + field.offset, end - field.offset - field.size, field.size, field.bigEndian);
+    }
+
+    TxFrame result(data);
+    for(const Field& field : m_fields)
+    {
+        if(field.name == "seq")
+            result.addField(TxFrame::Sequence, field.offset, field.size, field.bigEndian);
+        else if(field.name == "ms")
+            result.addField(TxFrame::Timestamp, field.offset, field.size, field.bigEndian);
+        else if(field.name == "now")
+            result.addField(TxFrame::UnixTime, field.offset, field.size, field.bigEndian);
+        else if(field.name == "sum8")
+            result.addChecksum(TxFrame::Sum, field.offset, field.size, field.bigEndian, field.begin);
+        else if(field.name == "xor8")
+            result.addChecksum(TxFrame::XOR, field.offset, field.size, field.bigEndian, field.begin);
+        else if(field.name != "len")
+        {
+            AsyncCRC crc;
+            checksumParam(field.name, &size, &bigEndian, &crc);
+            result.addChecksum(TxFrame::CRC, field.offset, field.size, field.bigEndian, field.begin, &crc);
+        }
+    }
+    return result;
+}
+
+QString TxTemplate::errorString() const
+{
+    return m_errorString;
+}
+
+bool TxTemplate::isValid() const
+{
+    return m_isValid;
+}
+
+TxTemplate::Converter TxTemplate::textConverter(QTextCodec* codec, bool unescape)
+{
+    return [codec, unescape](const QString & text)
+    {
+        return unescape ? Util::unescape(text, codec) : codec->fromUnicode(text);
+    };
+}
+
+TxTemplate::Converter TxTemplate::hexConverter()
+{
+    return [](const QString & text)
+    {
+        return QByteArray::fromHex(text.toLatin1());
+    };
+}
+
+bool TxTemplate::addField(const QString& spec)
+{
+    const QStringList args = spec.split(':');
+    Field field;
+    field.name = args[0].trimmed().toLower();
+    field.offset = m_data.size();
+    field.begin = 0;
+    bool valid = true;
+    if(field.name == "seq" || field.name == "ms" || field.name == "now" || field.name == "len")
+        valid = (args.size() == 2 && parseType(args[1].trimmed().toLower(), &field.size, &field.bigEndian));
+    else if(checksumParam(field.name, &field.size, &field.bigEndian))
+    {
+        for(int i = 1; i < args.size() && valid; i++)
+        {
+            const QString arg = args[i].trimmed().toLower();
+            bool isNumber;
+            const int begin = arg.toInt(&isNumber);
+            if(isNumber)
+            {
+                valid = (begin >= 0 && begin <= field.offset);
+                field.begin = begin;
+            }
+            else if(arg == "le" || arg == "be")
+                field.bigEndian = (arg == "be");
+            else
+                valid = false;
+        }
+    }
+    else
+    {
+        m_errorString = tr("Unknown field:") + " {" + spec + "}";
+        return false;
+    }
+    if(!valid)
+    {
+        m_errorString = tr("Invalid field:") + " {" + spec + "}";
+        return false;
+    }
+    // filled by TxFrame
+    m_data.append(field.size, '\0');
+    m_fields.append(field);
+    return true;
+}
+
+bool TxTemplate::parseType(const QString& type, int* size, bool* bigEndian)
+{
+    if(!type.startsWith('u'))
+        return false;
+    QString bits = type.mid(1);
+    *bigEndian = bits.endsWith("be");
+    if(bits.endsWith("le") || bits.endsWith("be"))
+        bits.chop(2);
+    bool ok;
+    const int bitNum = bits.toInt(&ok);
+    if(!ok || (bitNum != 8 && bitNum != 16 && bitNum != 32 && bitNum != 64))
+        return false;
+    *size = bitNum / 8;
+    return true;
+}
+
+bool TxTemplate::checksumParam(const QString& name, int* size, bool* bigEndian, AsyncCRC* crc)
+{
+    struct CRCParam
+    {
+        const char* name;
+        quint8 width;
+        quint64 poly, init;
+        bool refIn, refOut;
+        quint64 xorOut;
+        bool bigEndian; // the common byte order of the algorithm
+    };
+    static const CRCParam params[] =
+    {
+        {"crc8", 8, 0x07, 0, false, false, 0, false},
+        {"crc16-modbus", 16, 0x8005, 0xFFFF, true, true, 0, false},
+        // CRC-16/CCITT-FALSE
+        {"crc16-ccitt", 16, 0x1021, 0xFFFF, false, false, 0, true},
+        {"crc16-xmodem", 16, 0x1021, 0, false, false, 0, true},
+        {"crc32", 32, 0x04C11DB7ULL, 0xFFFFFFFFULL, true, true, 0xFFFFFFFFULL, false},
+    };
+    if(name == "sum8" || name == "xor8")
+    {
+        *size = 1;
+        *bigEndian = false;
+        return true;
+    }
+    for(const CRCParam& param : params)
+    {
+        if(name != param.name)
+            continue;
+        *size = param.width / 8;
+        *bigEndian = param.bigEndian;
+        if(crc != nullptr)
+            crc->setParam(param.width, param.poly, param.init, param.refIn, param.refOut, param.xorOut);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,73 @@
+#ifndef TXTEMPLATE_H
+#define TXTEMPLATE_H
+
+#include <QString>
+#include <QVector>
+#include <QCoreApplication>
+#include <functional>
+
+#include "txframe.h"
+
+class QTextCodec;
+
+// Compiles the send templates to a TxFrame, the fields are written in {}:
+// AA 55 {seq:u16le} {len:u8} 01 02 03 {crc16-modbus}
+// {seq:TYPE}, {ms:TYPE}, {now:TYPE}: the sequence, ms since epoch, s since epoch
+// {len:TYPE}: the length of the bytes after the field, up to the next checksum or the end
+// {crc8}, {crc16-modbus}, {crc16-ccitt}, {crc16-xmodem}, {crc32}, {sum8}, {xor8}: the checksum of the bytes before the field,
+// optionally from an offset and in a byte order, like {crc16-modbus:2:be}
+// TYPE: u8, u16, u32, u64, followed by le(default) or be
+// "{{" and "}}" are the literal braces.
+// A frame can be built from several parts, like the prefix, the command and the suffix.
+class TxTemplate
+{
+    Q_DECLARE_TR_FUNCTIONS(TxTemplate)
+public:
+    typedef std::function<QByteArray (const QString&)> Converter;
+
+    // the items of the prefix/suffix type boxes
+    enum AffixType
+    {
+        TextAffix = 0,
+        HexAffix,
+        CRLFAffix,
+        LFAffix,
+    };
+
+    // the fields are not parsed if isTemplate is false, the text is converted as a whole
+    explicit TxTemplate(bool isTemplate = true);
+
+    // the text between the fields is converted by literal, returns false if the template is invalid
+    // nothing is appended after a failure
+    bool append(const QString& text, const Converter& literal);
+    // type: AffixType, the text is converted by toText or as hex
+    bool appendAffix(int type, const QString& text, const Converter& toText);
+    void appendRaw(const QByteArray& data);
+    bool isValid() const;
+    TxFrame frame() const;
+    QString errorString() const;
+
+    static Converter textConverter(QTextCodec* codec, bool unescape);
+    static Converter hexConverter();
+private:
+    struct Field
+    {
+        QString name;
+        int offset;
+        int size;
+        bool bigEndian;
+        int begin;
+    };
+    bool m_isTemplate;
+    bool m_isValid = true;
+    QByteArray m_data;
+    QVector<Field> m_fields;
+    QString m_errorString;
+
+    bool addField(const QString& spec);
+    static bool parseType(const QString& type, int* size, bool* bigEndian);
+    // returns false if name is not a checksum, crc is set for CRC
+    static bool checksumParam(const QString& name, int* size, bool* bigEndian, AsyncCRC* crc = nullptr);
+};
+
+#endif // TXTEMPLATE_H